@@ -1,5 +1,6 @@
 // ActivityLiveLog screen test using PCF8814 and s3ui wrapper
 // Tests log scrolling, text wrapping, and dynamic log appending
+// An uptime clock in the title bar shows status field updates repainting only the changed field
 
 #include <s3ui.h>
 #include <PCF8814.h>
@@ -39,6 +40,8 @@ static const uint16_t logIntervalMs = 1500;  // Add a new log every 1.5 seconds
 static uint8_t nextMessageIndex = 0;
 static unsigned long cycleSwitchTime = 0;
 static const uint16_t cycleDurationMs = 30000;  // Clear and restart logs every 30 seconds
+static int8_t clockField = -1;
+static unsigned long lastClockSecond = 0;
 
 void setup() {
   // Initialize display
@@ -54,6 +57,10 @@ void setup() {
   ui.setTitleSize(1);
   ui.setContentSize(1);
 
+  // Uptime clock left of the battery text, wide enough for "00:00"
+  clockField = ui.addStatusField(ui.getTextWidth("00:00", true));
+  ui.setStatusField(clockField, "00:00");
+
   // Initialize the activity log screen
   ui.activityLiveLogScreen("Activity Log", "95%");
   
@@ -70,6 +77,16 @@ void setup() {
 
 void loop() {
   unsigned long now = millis();
+
+  // Update the uptime clock once per second; only the clock field is repainted
+  if (now / 1000 != lastClockSecond) {
+    lastClockSecond = now / 1000;
+    char clock[6];
+    snprintf(clock, sizeof(clock), "%02u:%02u", (unsigned)(lastClockSecond / 60 % 100),
+             (unsigned)(lastClockSecond % 60));
+    ui.setStatusField(clockField, clock);
+  }
+
   // Check if we should clear and restart the log cycle
   if (now - cycleSwitchTime >= cycleDurationMs) {
     ui.clearLog();
@@ -94,9 +111,10 @@ void loop() {
     }
   }
   
-  // Update the display (handles log screen refresh)
-  ui.update();
-  lcd.display();
+  // Redraw the log only if it changed, and flush only when something was drawn
+  if (ui.update()) {
+    lcd.display();
+  }
   
   // Small delay to prevent overwhelming the MCU
   delay(10);
@@ -84,13 +84,6 @@ void setup() {
 }
 
 void loop() {
-  // Update animation frames
-  ui.update();
-  lcd.display();
-  
-  // Small delay to prevent overwhelming the MCU
-  delay(10);
-
   // Cycle through cases to demonstrate no-wrap, wrap, and newline handling
   unsigned long now = millis();
   if (now - lastStep >= stepMs) {
@@ -102,6 +95,20 @@ void loop() {
     }
 
     ui.runningActivityScreen(kCases[currentCase].title, "98%", animationFrames, kNumFrames, kBitmapW, kBitmapH, kFrameDelayMs, kCases[currentCase].caption);
+  }
+
+  // Advance animation frames; flush only when a new frame (or screen) was drawn
+  if (ui.update()) {
     lcd.display();
   }
+
+  // Sleep until the next animation frame or case switch is due instead of polling
+  // (on ESP32 this is where esp_light_sleep_start() or a FreeRTOS notification wait would go)
+  uint32_t wait = ui.msUntilNextUpdate();
+  unsigned long elapsed = millis() - lastStep;
+  unsigned long untilStep = (elapsed >= stepMs) ? 0 : stepMs - elapsed;
+  if (wait > untilStep) {
+    wait = untilStep;
+  }
+  delay(wait);
 }
\ No newline at end of file
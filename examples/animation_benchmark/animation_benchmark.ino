@@ -0,0 +1,113 @@
+// Compressed animation benchmark: plays the same 24x24 animation from raw frames and from the
+// compressed s3uiAnimation format (download_anim.h, generated with extras/s3ui_anim.py), checks
+// that every frame renders identically and reports flash size and time per frame.
+// Runs against in-memory canvases, so no display is required.
+// Results are printed over Serial as CSV: format,bytes,ratio,us_per_frame,identical
+//
+// Regenerate the compressed header with:
+//   cd examples/animation_benchmark
+//   python3 ../../extras/s3ui_anim.py ../animated_runningActivityScreen/animated_runningActivityScreen.ino
+//       --c-arrays --frame-size 24x24 --name download_anim -o download_anim.h
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <s3ui.h>
+#include <Fonts/Picopixel.h>
+#include "download_anim.h"
+
+static const int16_t kWidth = 96;
+static const int16_t kHeight = 65;
+static const uint16_t kIterations = 700;
+
+static const unsigned char PROGMEM image_download_0_bits[] = {0x00,0x00,0x00,0x07,0xff,0xf0,0x04,0x00,0x10,0x03,0xff,0xe0,0x01,0x00,0x40,0x01,0x7f,0x40,0x01,0x7f,0x40,0x01,0x3e,0x40,0x00,0x9c,0x80,0x00,0x49,0x00,0x00,0x22,0x00,0x00,0x14,0x00,0x00,0x14,0x00,0x00,0x22,0x00,0x00,0x49,0x00,0x00,0x80,0x80,0x01,0x00,0x40,0x01,0x00,0x40,0x01,0x00,0x40,0x01,0x00,0x40,0x03,0xff,0xe0,0x04,0x00,0x10,0x07,0xff,0xf0,0x00,0x00,0x00};
+
+static const unsigned char PROGMEM image_download_1_bits[] = {0x00,0x00,0x00,0x07,0xff,0xf0,0x04,0x00,0x10,0x03,0xff,0xe0,0x01,0x00,0x40,0x01,0x00,0x40,0x01,0x7f,0x40,0x01,0x3e,0x40,0x00,0x9c,0x80,0x00,0x49,0x00,0x00,0x22,0x00,0x00,0x14,0x00,0x00,0x14,0x00,0x00,0x22,0x00,0x00,0x49,0x00,0x00,0x80,0x80,0x01,0x08,0x40,0x01,0x3e,0x40,0x01,0x7f,0x40,0x01,0x00,0x40,0x03,0xff,0xe0,0x04,0x00,0x10,0x07,0xff,0xf0,0x00,0x00,0x00};
+
+static const unsigned char PROGMEM image_download_2_bits[] = {0x00,0x00,0x00,0x07,0xff,0xf0,0x04,0x00,0x10,0x03,0xff,0xe0,0x01,0x00,0x40,0x01,0x00,0x40,0x01,0x00,0x40,0x01,0x3e,0x40,0x00,0x9c,0x80,0x00,0x49,0x00,0x00,0x22,0x00,0x00,0x14,0x00,0x00,0x14,0x00,0x00,0x22,0x00,0x00,0x49,0x00,0x00,0x80,0x80,0x01,0x3e,0x40,0x01,0x7f,0x40,0x01,0x7f,0x40,0x01,0x00,0x40,0x03,0xff,0xe0,0x04,0x00,0x10,0x07,0xff,0xf0,0x00,0x00,0x00};
+
+static const unsigned char PROGMEM image_download_3_bits[] = {0x00,0x00,0x00,0x07,0xff,0xf0,0x04,0x00,0x10,0x03,0xff,0xe0,0x01,0x00,0x40,0x01,0x00,0x40,0x01,0x00,0x40,0x01,0x00,0x40,0x00,0x80,0x80,0x00,0x41,0x00,0x00,0x22,0x00,0x00,0x14,0x00,0x00,0x14,0x00,0x00,0x22,0x00,0x00,0x49,0x00,0x00,0x9c,0x80,0x01,0x3e,0x40,0x01,0x7f,0x40,0x01,0x7f,0x40,0x01,0x00,0x40,0x03,0xff,0xe0,0x04,0x00,0x10,0x07,0xff,0xf0,0x00,0x00,0x00};
+
+static const unsigned char PROGMEM image_download_4_bits[] = {0x00,0x40,0x00,0x00,0xe0,0x00,0x01,0x40,0x00,0x02,0xa0,0x00,0x05,0x10,0x00,0x0a,0x08,0x00,0x14,0x08,0x00,0x28,0x08,0x00,0x50,0x08,0x00,0xe0,0x08,0x00,0x50,0x08,0x00,0x08,0x07,0xe0,0x07,0xe0,0x10,0x00,0x14,0x0a,0x00,0x17,0xe7,0x00,0x17,0xca,0x00,0x17,0x94,0x00,0x17,0x28,0x00,0x12,0x50,0x00,0x08,0xa0,0x00,0x05,0x40,0x00,0x02,0x80,0x00,0x07,0x00,0x00,0x02,0x00};
+
+static const unsigned char PROGMEM image_download_5_bits[] = {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x60,0x00,0x06,0x50,0x00,0x0a,0x5f,0x00,0xfa,0x50,0x81,0x0a,0x50,0x42,0x0a,0x50,0x24,0x0a,0x50,0x18,0x7a,0x50,0x03,0xfa,0x50,0x19,0xfa,0x50,0x24,0xfa,0x50,0x42,0x7a,0x50,0x81,0x0a,0x5f,0x00,0xfa,0x50,0x00,0x0a,0x60,0x00,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+
+static const unsigned char PROGMEM image_download_6_bits[] = {0x00,0x02,0x00,0x00,0x07,0x00,0x00,0x02,0x80,0x00,0x05,0x40,0x00,0x08,0xa0,0x00,0x10,0x50,0x00,0x10,0x28,0x00,0x13,0x94,0x00,0x17,0xca,0x00,0x17,0xe7,0x00,0x17,0xca,0x07,0xe0,0x10,0x08,0x07,0xe0,0x50,0x08,0x00,0xe0,0x08,0x00,0x50,0x08,0x00,0x28,0x08,0x00,0x14,0x08,0x00,0x0a,0x08,0x00,0x05,0x10,0x00,0x02,0xa0,0x00,0x01,0x40,0x00,0x00,0xe0,0x00,0x00,0x40,0x00};
+
+static const uint8_t *const kRawFrames[] = {image_download_0_bits, image_download_1_bits, image_download_2_bits,
+                                            image_download_3_bits, image_download_4_bits, image_download_5_bits,
+                                            image_download_6_bits};
+static const uint8_t kNumFrames = sizeof(kRawFrames) / sizeof(kRawFrames[0]);
+
+static GFXcanvas1 rawCanvas(kWidth, kHeight);
+static GFXcanvas1 encodedCanvas(kWidth, kHeight);
+static s3ui rawUi;
+static s3ui encodedUi;
+static uint8_t scratch[S3UI_ANIMATION_FRAME_BYTES(DOWNLOAD_ANIM_WIDTH, DOWNLOAD_ANIM_HEIGHT)];
+
+static void setupUi(s3ui &ui, GFXcanvas1 &canvas) {
+  ui.setDisplay(&canvas, kWidth, kHeight);
+  ui.setTitleFont(&Picopixel);
+  ui.setContentFont(&Picopixel);
+  ui.setTitleSize(1);
+  ui.setContentSize(1);
+}
+
+// msPerFrame = 0 makes every update() advance exactly one frame
+static void startRaw() {
+  rawUi.runningActivityScreen("Download", "84%", (const uint8_t **)kRawFrames, kNumFrames, 24, 24, 0,
+                              "Fetching update");
+}
+
+static void startEncoded() {
+  encodedUi.runningActivityScreen("Download", "84%", download_anim, scratch, 0, "Fetching update");
+}
+
+static float timeFrames(s3ui &ui) {
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < kIterations; i++) {
+    ui.update();
+  }
+  return (float)(micros() - start) / kIterations;
+}
+
+static void report(const char *format, size_t bytes, size_t rawBytes, float us, bool identical) {
+  Serial.print(format);
+  Serial.print(',');
+  Serial.print((unsigned long)bytes);
+  Serial.print(',');
+  Serial.print((float)rawBytes / bytes, 2);
+  Serial.print(',');
+  Serial.print(us, 1);
+  Serial.print(',');
+  Serial.println(identical ? "yes" : "NO");
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+
+  setupUi(rawUi, rawCanvas);
+  setupUi(encodedUi, encodedCanvas);
+
+  // Both players must show the same pixels after every frame, including the loop back to frame 0
+  size_t bufferBytes = ((kWidth + 7) / 8) * kHeight;
+  startRaw();
+  startEncoded();
+  bool identical = memcmp(rawCanvas.getBuffer(), encodedCanvas.getBuffer(), bufferBytes) == 0;
+  for (uint8_t i = 0; i < 3 * kNumFrames; i++) {
+    rawUi.update();
+    encodedUi.update();
+    if (memcmp(rawCanvas.getBuffer(), encodedCanvas.getBuffer(), bufferBytes) != 0)
+      identical = false;
+  }
+
+  size_t rawBytes = kNumFrames * S3UI_ANIMATION_FRAME_BYTES(24, 24);
+  Serial.println("format,bytes,ratio,us_per_frame,identical");
+  startRaw();
+  report("raw", rawBytes, rawBytes, timeFrames(rawUi), true);
+  startEncoded();
+  report("compressed", sizeof(download_anim), rawBytes, timeFrames(encodedUi), identical);
+}
+
+void loop() {}
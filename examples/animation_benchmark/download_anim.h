@@ -0,0 +1,32 @@
+// Generated by s3ui_anim.py: 7 frames of 24x24, 343 bytes (raw frames: 504 bytes)
+#pragma once
+#include <Arduino.h>
+
+#define DOWNLOAD_ANIM_WIDTH 24
+#define DOWNLOAD_ANIM_HEIGHT 24
+#define DOWNLOAD_ANIM_FRAMES 7
+
+static const uint8_t download_anim[] PROGMEM = {
+    0x53, 0x01, 0x18, 0x00, 0x18, 0x00, 0x07, 0x00, 0x00, 0x81, 0x00, 0x19, 0x07, 0xff, 0xf0, 0x04,
+    0x00, 0x10, 0x03, 0xff, 0xe0, 0x01, 0x00, 0x40, 0x01, 0x7f, 0x40, 0x01, 0x7f, 0x40, 0x01, 0x3e,
+    0x40, 0x00, 0x9c, 0x80, 0x00, 0x49, 0x80, 0x00, 0x00, 0x22, 0x80, 0x00, 0x00, 0x14, 0x80, 0x00,
+    0x00, 0x14, 0x80, 0x00, 0x00, 0x22, 0x80, 0x00, 0x00, 0x49, 0x80, 0x00, 0x80, 0x80, 0x14, 0x01,
+    0x00, 0x40, 0x01, 0x00, 0x40, 0x01, 0x00, 0x40, 0x01, 0x00, 0x40, 0x03, 0xff, 0xe0, 0x04, 0x00,
+    0x10, 0x07, 0xff, 0xf0, 0x81, 0x00, 0x01, 0x8e, 0x00, 0x00, 0x7f, 0x9e, 0x00, 0x00, 0x08, 0x80,
+    0x00, 0x00, 0x3e, 0x80, 0x00, 0x00, 0x7f, 0x8e, 0x00, 0x01, 0x91, 0x00, 0x00, 0x7f, 0x9b, 0x00,
+    0x00, 0x36, 0x80, 0x00, 0x00, 0x41, 0x91, 0x00, 0x01, 0x94, 0x00, 0x00, 0x3e, 0x80, 0x00, 0x00,
+    0x1c, 0x80, 0x00, 0x00, 0x08, 0x8f, 0x00, 0x00, 0x1c, 0x97, 0x00, 0x01, 0x33, 0x00, 0x40, 0x00,
+    0x07, 0x1f, 0xf0, 0x05, 0x40, 0x10, 0x01, 0x5f, 0xe0, 0x04, 0x10, 0x40, 0x0b, 0x08, 0x40, 0x15,
+    0x08, 0x40, 0x29, 0x08, 0x40, 0x50, 0x88, 0x80, 0xe0, 0x49, 0x00, 0x50, 0x2a, 0x00, 0x08, 0x13,
+    0xe0, 0x07, 0xf4, 0x10, 0x00, 0x36, 0x0a, 0x00, 0x5e, 0xe7, 0x00, 0x8b, 0x4a, 0x01, 0x29, 0xd4,
+    0x01, 0x80, 0x68, 0x11, 0x01, 0x6d, 0x10, 0x01, 0x08, 0xe0, 0x03, 0xfa, 0xa0, 0x04, 0x02, 0x90,
+    0x07, 0xf8, 0xf0, 0x00, 0x02, 0x00, 0x00, 0x8d, 0x00, 0x2c, 0x60, 0x00, 0x06, 0x50, 0x00, 0x0a,
+    0x5f, 0x00, 0xfa, 0x50, 0x81, 0x0a, 0x50, 0x42, 0x0a, 0x50, 0x24, 0x0a, 0x50, 0x18, 0x7a, 0x50,
+    0x03, 0xfa, 0x50, 0x19, 0xfa, 0x50, 0x24, 0xfa, 0x50, 0x42, 0x7a, 0x50, 0x81, 0x0a, 0x5f, 0x00,
+    0xfa, 0x50, 0x00, 0x0a, 0x60, 0x00, 0x06, 0x8a, 0x00, 0x00, 0x01, 0x00, 0x02, 0x80, 0x00, 0x00,
+    0x07, 0x80, 0x00, 0x39, 0x02, 0x80, 0x00, 0x05, 0x40, 0x00, 0x08, 0xa0, 0x00, 0x10, 0x50, 0x00,
+    0x10, 0x28, 0x00, 0x13, 0x94, 0x00, 0x17, 0xca, 0x00, 0x17, 0xe7, 0x00, 0x17, 0xca, 0x07, 0xe0,
+    0x10, 0x08, 0x07, 0xe0, 0x50, 0x08, 0x00, 0xe0, 0x08, 0x00, 0x50, 0x08, 0x00, 0x28, 0x08, 0x00,
+    0x14, 0x08, 0x00, 0x0a, 0x08, 0x00, 0x05, 0x10, 0x00, 0x02, 0xa0, 0x00, 0x01, 0x40, 0x80, 0x00,
+    0x00, 0xe0, 0x80, 0x00, 0x01, 0x40, 0x00,
+};
@@ -257,8 +257,6 @@ void renderCurrentTest() {
       selectedOption
     );
   }
-  
-  lcd.display();
 }
 
 void setup() {
@@ -275,6 +273,7 @@ void setup() {
   ui.setContentSize(1);
   // Initial render
   renderCurrentTest();
+  lcd.display();
 }
 
 void loop() {
@@ -298,8 +297,10 @@ void loop() {
     renderCurrentTest();
   }
   
-  // Allow UI to update (not needed for confirm screens, but good practice)
-  ui.update();
+  // Flush only when s3ui drew something since the last update
+  if (ui.update()) {
+    lcd.display();
+  }
   // Small delay to prevent a tight loop from consuming unnecessary CPU/power
   delay(10);
 }
@@ -0,0 +1,133 @@
+// Framebuffer backend benchmark: renders the same screens through Adafruit_GFX and through
+// setFramebuffer(), checks the buffers are identical and reports the time per frame.
+// Runs against in-memory canvases, so no display is required.
+// Results are printed over Serial as CSV: screen,layout,gfx_us,fb_us,identical
+//
+// On real hardware attach the display's own buffer instead, e.g.
+//   ui.setFramebuffer(ssd1306.getBuffer(), S3UI_LAYOUT_VERTICAL);
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <s3ui.h>
+#include <Fonts/Picopixel.h>
+
+static const int16_t kWidth = 96;
+static const int16_t kHeight = 65;
+
+// Minimal page-addressed canvas (SSD1306/PCF8814 memory layout) for the vertical layout check
+class PageCanvas : public Adafruit_GFX {
+public:
+  PageCanvas(int16_t w, int16_t h) : Adafruit_GFX(w, h) { buffer = (uint8_t *)calloc(w * ((h + 7) / 8), 1); }
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || y < 0 || x >= width() || y >= height())
+      return;
+    uint8_t *p = &buffer[x + (y / 8) * width()];
+    if (color)
+      *p |= 1 << (y & 7);
+    else
+      *p &= ~(1 << (y & 7));
+  }
+  uint8_t *getBuffer() { return buffer; }
+
+private:
+  uint8_t *buffer;
+};
+
+static GFXcanvas1 gfxCanvas(kWidth, kHeight);
+static GFXcanvas1 fbCanvas(kWidth, kHeight);
+static PageCanvas gfxPages(kWidth, kHeight);
+static PageCanvas fbPages(kWidth, kHeight);
+static s3ui gfxUi;
+static s3ui fbUi;
+
+static const char *const kOptions[] = {"Scan", "Jammer", "Channels", "Settings", "About", "Firmware"};
+static const char *const kValues[] = {"On", "25%", "Medium", "300s", "v1.2", "Auto"};
+static const char *const kButtons[] = {"Save", "Discard", "Cancel"};
+static const uint8_t kIcon[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x07, 0xff, 0xf0, 0x04, 0x00, 0x10, 0x03, 0xff, 0xe0, 0x01, 0x00, 0x40, 0x01, 0x00, 0x40,
+    0x01, 0x7f, 0x40, 0x01, 0x3e, 0x40, 0x00, 0x9c, 0x80, 0x00, 0x49, 0x00, 0x00, 0x22, 0x00, 0x00, 0x14, 0x00,
+    0x00, 0x14, 0x00, 0x00, 0x22, 0x00, 0x00, 0x49, 0x00, 0x00, 0x80, 0x80, 0x01, 0x08, 0x40, 0x01, 0x3e, 0x40,
+    0x01, 0x7f, 0x40, 0x01, 0x00, 0x40, 0x03, 0xff, 0xe0, 0x04, 0x00, 0x10, 0x07, 0xff, 0xf0, 0x00, 0x00, 0x00};
+
+static const uint8_t kNumScreens = 4;
+static const char *const kScreenNames[kNumScreens] = {"optionSelect", "optionValueSet", "runningActivity", "confirm"};
+static const uint16_t kIterations = 200;
+
+static void renderScreen(s3ui &ui, uint8_t screen, uint8_t step) {
+  switch (screen) {
+  case 0:
+    ui.optionSelectScreen("Main Menu", "84%", kOptions, 6, step % 6);
+    break;
+  case 1:
+    ui.optionValueSetScreen("Settings", "84%", kOptions, kValues, 6, step % 6, step & 1);
+    break;
+  case 2:
+    ui.runningActivityScreen("Running", "84%", kIcon, 24, 24, "Scanning channels and measuring link quality");
+    break;
+  default:
+    ui.confirmScreen("Confirm", "84%", kIcon, 24, 24, "Discard changes?", kButtons, 3, step % 3);
+    break;
+  }
+}
+
+static void setupUi(s3ui &ui, Adafruit_GFX *gfx) {
+  ui.setDisplay(gfx, kWidth, kHeight);
+  ui.setTitleFont(&Picopixel);
+  ui.setContentFont(&Picopixel);
+  ui.setTitleSize(1);
+  ui.setContentSize(1);
+}
+
+static float timeScreen(s3ui &ui, uint8_t screen) {
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < kIterations; i++) {
+    renderScreen(ui, screen, i);
+  }
+  return (float)(micros() - start) / kIterations;
+}
+
+static void compare(const char *layout, uint8_t *gfxBuffer, uint8_t *fbBuffer, size_t bytes) {
+  for (uint8_t screen = 0; screen < kNumScreens; screen++) {
+    // Identical output for every step of the screen
+    bool identical = true;
+    for (uint8_t step = 0; step < 6; step++) {
+      renderScreen(gfxUi, screen, step);
+      renderScreen(fbUi, screen, step);
+      if (memcmp(gfxBuffer, fbBuffer, bytes) != 0)
+        identical = false;
+    }
+
+    float gfxUs = timeScreen(gfxUi, screen);
+    float fbUs = timeScreen(fbUi, screen);
+
+    Serial.print(kScreenNames[screen]);
+    Serial.print(',');
+    Serial.print(layout);
+    Serial.print(',');
+    Serial.print(gfxUs, 1);
+    Serial.print(',');
+    Serial.print(fbUs, 1);
+    Serial.print(',');
+    Serial.println(identical ? "yes" : "NO");
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+
+  Serial.println("screen,layout,gfx_us,fb_us,identical");
+
+  setupUi(gfxUi, &gfxCanvas);
+  setupUi(fbUi, &fbCanvas);
+  fbUi.setFramebuffer(fbCanvas.getBuffer(), S3UI_LAYOUT_HORIZONTAL);
+  compare("horizontal", gfxCanvas.getBuffer(), fbCanvas.getBuffer(), ((kWidth + 7) / 8) * kHeight);
+
+  setupUi(gfxUi, &gfxPages);
+  setupUi(fbUi, &fbPages);
+  fbUi.setFramebuffer(fbPages.getBuffer(), S3UI_LAYOUT_VERTICAL);
+  compare("vertical", gfxPages.getBuffer(), fbPages.getBuffer(), kWidth * ((kHeight + 7) / 8));
+}
+
+void loop() {}
@@ -58,12 +58,16 @@ void loop() {
   if (now - lastStep >= stepMs) {
     lastStep = now;
     cursor = (uint8_t)((cursor + 1) % numOptions);
-    ui.optionSelectScreen(title, "99%", options, numOptions, cursor);
-    lcd.display();
+    // Repaint only the rows that changed; fall back to the full screen when that is not possible
+    if (!ui.moveOptionCursor(cursor)) {
+      ui.optionSelectScreen(title, "99%", options, numOptions, cursor);
+    }
   }
 
-  // Allow s3ui to update any animations (none on OptionSelect)
-  ui.update();
+  // Flush only when s3ui drew something since the last update
+  if (ui.update()) {
+    lcd.display();
+  }
   
   // Small delay to prevent overwhelming the MCU
   delay(10);
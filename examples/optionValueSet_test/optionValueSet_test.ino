@@ -112,11 +112,12 @@ void loop() {
     }
     
     ui.optionValueSetScreen(title, "99%", optionNames, optionValues, numOptions, position, optionSelected);
-    lcd.display();
   }
 
-  // Allow s3ui to update any animations
-  ui.update();
+  // Flush only when s3ui drew something since the last update
+  if (ui.update()) {
+    lcd.display();
+  }
   
   // Small delay to prevent overwhelming the MCU
   delay(10);
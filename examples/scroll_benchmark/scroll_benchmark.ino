@@ -0,0 +1,81 @@
+// Smooth list scrolling benchmark: measures the cost of one scroll frame (list area repainted at a pixel
+// offset, clipped to the content box) on a 96x65 screen through Adafruit_GFX and through setFramebuffer().
+// Runs against in-memory canvases, so no display is required; add the panel's own display() time to the
+// result on real hardware.
+// Results are printed over Serial as CSV: path,screen,us_per_frame,max_fps
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <s3ui.h>
+#include <Fonts/Picopixel.h>
+
+static const int16_t kWidth = 96;
+static const int16_t kHeight = 65;
+static const uint16_t kFrames = 500;
+
+static GFXcanvas1 canvas(kWidth, kHeight);
+static s3ui ui;
+
+static const char *const kOptions[] = {"Scan", "Jammer", "Channels", "Settings", "About", "Firmware",
+                                       "Wifi", "Bluetooth", "Log", "Display", "Power", "Reset"};
+static const char *const kValues[] = {"On", "25%", "Medium", "300s", "v1.2", "Auto",
+                                      "Off", "On", "Full", "50%", "Eco", "No"};
+static const uint8_t kNumOptions = sizeof(kOptions) / sizeof(kOptions[0]);
+
+static void render(bool valueScreen, uint8_t cursor) {
+  if (valueScreen)
+    ui.optionValueSetScreen("Settings", "84%", kOptions, kValues, kNumOptions, cursor, false);
+  else
+    ui.optionSelectScreen("Main Menu", "84%", kOptions, kNumOptions, cursor);
+}
+
+static float timeFrames(bool valueScreen) {
+  // A long tween with fps = 0 makes every update() draw one scroll frame
+  render(valueScreen, 0);
+  ui.update();
+  unsigned long total = 0;
+  uint16_t frames = 0;
+  uint8_t target = kNumOptions - 2;
+  while (frames < kFrames) {
+    ui.moveOptionCursor(target);
+    target = (target == 0) ? kNumOptions - 2 : 0;
+    for (uint8_t i = 0; i < 50; i++, frames++) {
+      unsigned long start = micros();
+      ui.update();
+      total += micros() - start;
+    }
+  }
+  return (float)total / frames;
+}
+
+static void report(const char *path, const char *screen, float us) {
+  Serial.print(path);
+  Serial.print(',');
+  Serial.print(screen);
+  Serial.print(',');
+  Serial.print(us, 1);
+  Serial.print(',');
+  Serial.println(us > 0 ? 1000000.0f / us : 0.0f, 0);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+
+  ui.setDisplay(&canvas, kWidth, kHeight);
+  ui.setTitleFont(&Picopixel);
+  ui.setContentFont(&Picopixel);
+  ui.setTitleSize(1);
+  ui.setContentSize(1);
+  ui.setSmoothScroll(60000, 0);
+
+  Serial.println("path,screen,us_per_frame,max_fps");
+  report("gfx", "optionSelect", timeFrames(false));
+  report("gfx", "optionValueSet", timeFrames(true));
+  ui.setFramebuffer(canvas.getBuffer(), S3UI_LAYOUT_HORIZONTAL);
+  report("framebuffer", "optionSelect", timeFrames(false));
+  report("framebuffer", "optionValueSet", timeFrames(true));
+}
+
+void loop() {}
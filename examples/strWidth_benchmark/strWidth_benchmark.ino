@@ -0,0 +1,75 @@
+// Text measurement benchmark: per-string cost of the glyph advance tables vs. walking the GFXfont
+// Renders nothing; runs against an in-memory GFXcanvas1 so no display is required.
+// Results are printed over Serial as CSV: string,chars,legacy_us,table_us,width
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <s3ui.h>
+#include <Fonts/Picopixel.h>
+
+static GFXcanvas1 canvas(96, 65);
+static s3ui ui;
+
+static const char *kSamples[] = {
+    "OK",
+    "Settings",
+    "Device found: RF24-001 at channel 10",
+    "Long message that should wrap to multiple lines because it contains a lot of text to demonstrate the text wrapping feature",
+};
+static const uint8_t kNumSamples = sizeof(kSamples) / sizeof(kSamples[0]);
+static const uint16_t kIterations = 2000;
+
+// Reference: how s3ui measured text before the advance tables (setFont + glyph walk per call)
+static int16_t legacyWidth(Adafruit_GFX *gfx, const char *str, const GFXfont *font, uint8_t size) {
+  int16_t totalWidth = 0;
+  gfx->setFont(font);
+  for (size_t i = 0; str[i]; i++) {
+    char c = str[i];
+    if (c < font->first || c > font->last)
+      continue;
+    GFXglyph *glyph = &font->glyph[c - font->first];
+    totalWidth += glyph->xAdvance * size;
+  }
+  return totalWidth;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+  }
+
+  ui.setDisplay(&canvas, 96, 65);
+  ui.setTitleFont(&Picopixel);
+  ui.setContentFont(&Picopixel);
+  ui.setTitleSize(1);
+  ui.setContentSize(1);
+
+  Serial.println("string,chars,legacy_us,table_us,width");
+  for (uint8_t s = 0; s < kNumSamples; s++) {
+    volatile int16_t sink = 0;
+
+    unsigned long start = micros();
+    for (uint16_t i = 0; i < kIterations; i++) {
+      sink = legacyWidth(&canvas, kSamples[s], &Picopixel, 1);
+    }
+    float legacyUs = (float)(micros() - start) / kIterations;
+
+    start = micros();
+    for (uint16_t i = 0; i < kIterations; i++) {
+      sink = ui.getTextWidth(kSamples[s]);
+    }
+    float tableUs = (float)(micros() - start) / kIterations;
+
+    Serial.print(s);
+    Serial.print(',');
+    Serial.print(strlen(kSamples[s]));
+    Serial.print(',');
+    Serial.print(legacyUs, 3);
+    Serial.print(',');
+    Serial.print(tableUs, 3);
+    Serial.print(',');
+    Serial.println(sink);
+  }
+}
+
+void loop() {}
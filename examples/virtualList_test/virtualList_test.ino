@@ -0,0 +1,66 @@
+// Virtual OptionValueSet list test using PCF8814 and s3ui wrapper: 1000 channels whose names and
+// values are produced on demand by callbacks, so no per-item memory is needed
+
+#include <s3ui.h>
+#include <PCF8814.h>
+#include <Picopixel.h>
+
+// Pins for Nokia 1100 (PCF8814) display (SCE, SCLK, SDIN, RST)
+static PCF8814 lcd(19, 18, 23, 21);
+static s3ui ui;
+
+static const uint16_t numChannels = 1000;
+
+// Only the rows inside the visible window are requested
+static s3uiText channelName(uint16_t index, char *buffer, uint16_t size) {
+  snprintf(buffer, size, "Channel %u", index + 1);
+  return s3uiText(buffer);
+}
+
+static s3uiText channelValue(uint16_t index, char *buffer, uint16_t size) {
+  // Values may also be views of constant strings instead of formatted text
+  return (index % 3 == 0) ? s3uiText("busy") : s3uiText("free");
+}
+
+// Cursor animation state
+static uint16_t cursor = 0;
+static unsigned long lastStep = 0;
+static const uint16_t stepMs = 300;
+
+void setup() {
+  // Initialize display
+  lcd.begin();
+  lcd.setContrast(0x0F); // Adjust if needed for your module
+  lcd.displayOn();
+
+  // Initialize wrapper and fonts
+  ui.setDisplay(&lcd, 96, 65);
+  ui.setTitleFont(&Picopixel);
+  ui.setContentFont(&Picopixel);
+  ui.setTitleSize(1);
+  ui.setContentSize(1);
+
+  // Initial render
+  ui.optionValueSetScreen("Channels", "99%", channelName, channelValue, numChannels, cursor, false);
+  lcd.display();
+}
+
+void loop() {
+  // Step through the list, jumping ahead now and then
+  unsigned long now = millis();
+  if (now - lastStep >= stepMs) {
+    lastStep = now;
+    cursor = (cursor % 50 == 49) ? (cursor + 137) % numChannels : (cursor + 1) % numChannels;
+    if (!ui.moveOptionCursor(cursor)) {
+      ui.optionValueSetScreen("Channels", "99%", channelName, channelValue, numChannels, cursor, false);
+    }
+  }
+
+  // Flush only when s3ui drew something since the last update
+  if (ui.update()) {
+    lcd.display();
+  }
+
+  // Small delay to prevent overwhelming the MCU
+  delay(10);
+}
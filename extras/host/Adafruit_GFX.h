@@ -0,0 +1,217 @@
+#ifndef S3UI_HOST_ADAFRUIT_GFX_H
+#define S3UI_HOST_ADAFRUIT_GFX_H
+
+/**
+ * @file Adafruit_GFX.h
+ * @brief Minimal Adafruit_GFX stand-in for building s3ui on a desktop host (see s3ui_bench.cpp).
+ *
+ * Reproduces the default (unoptimized) Adafruit_GFX drawing paths that s3ui uses, so that every pixel ends up
+ * in drawPixel() exactly as on a display driver that only implements drawPixel() (PCF8814 and similar).
+ * Only custom GFXfont text is supported; the classic 5x7 font is not used by s3ui.
+ */
+
+#include "Arduino.h"
+
+/** @brief Glyph metrics, as in Adafruit_GFX's gfxfont.h. */
+typedef struct {
+  uint16_t bitmapOffset; ///< Offset of the glyph in the font bitmap.
+  uint8_t width;         ///< Bitmap width in pixels.
+  uint8_t height;        ///< Bitmap height in pixels.
+  uint8_t xAdvance;      ///< Distance to advance the cursor.
+  int8_t xOffset;        ///< X distance from the cursor to the upper-left corner.
+  int8_t yOffset;        ///< Y distance from the cursor to the upper-left corner.
+} GFXglyph;
+
+/** @brief Font data, as in Adafruit_GFX's gfxfont.h. */
+typedef struct {
+  uint8_t *bitmap;   ///< Concatenated glyph bitmaps.
+  GFXglyph *glyph;   ///< Glyph array.
+  uint16_t first;    ///< First ASCII code.
+  uint16_t last;     ///< Last ASCII code.
+  uint8_t yAdvance;  ///< Newline distance.
+} GFXfont;
+
+/** @brief Graphics base class: derived classes implement drawPixel(), everything else is built on it. */
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void startWrite() {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+  virtual void endWrite() {}
+
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+      swap(x0, y0);
+      swap(x1, y1);
+    }
+    if (x0 > x1) {
+      swap(x0, x1);
+      swap(y0, y1);
+    }
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = (y0 < y1) ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+      if (steep)
+        writePixel(y0, x0, color);
+      else
+        writePixel(x0, y0, color);
+      err -= dy;
+      if (err < 0) {
+        y0 += ystep;
+        err += dx;
+      }
+    }
+  }
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    startWrite();
+    writeLine(x, y, x, y + h - 1, color);
+    endWrite();
+  }
+
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    startWrite();
+    writeLine(x, y, x + w - 1, y, color);
+    endWrite();
+  }
+
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    startWrite();
+    for (int16_t i = x; i < x + w; i++)
+      writeFastVLine(i, y, h, color);
+    endWrite();
+  }
+
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    startWrite();
+    writeFastHLine(x, y, w, color);
+    writeFastHLine(x, y + h - 1, w, color);
+    writeFastVLine(x, y, h, color);
+    writeFastVLine(x + w - 1, y, h, color);
+    endWrite();
+  }
+
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
+    int16_t byteWidth = (w + 7) / 8;
+    uint8_t b = 0;
+    startWrite();
+    for (int16_t j = 0; j < h; j++, y++) {
+      for (int16_t i = 0; i < w; i++) {
+        if (i & 7)
+          b <<= 1;
+        else
+          b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+        if (b & 0x80)
+          writePixel(x + i, y, color);
+      }
+    }
+    endWrite();
+  }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint8_t sizeX, uint8_t sizeY) {
+    c -= (uint8_t)pgm_read_byte(&gfxFont->first);
+    const GFXglyph *glyph = gfxFont->glyph + c;
+    const uint8_t *bitmap = gfxFont->bitmap;
+    uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+    uint8_t w = pgm_read_byte(&glyph->width);
+    uint8_t h = pgm_read_byte(&glyph->height);
+    int8_t xo = pgm_read_byte(&glyph->xOffset);
+    int8_t yo = pgm_read_byte(&glyph->yOffset);
+    uint8_t bits = 0;
+    uint8_t bit = 0;
+    int16_t xo16 = 0;
+    int16_t yo16 = 0;
+    if (sizeX > 1 || sizeY > 1) {
+      xo16 = xo;
+      yo16 = yo;
+    }
+    startWrite();
+    for (uint8_t yy = 0; yy < h; yy++) {
+      for (uint8_t xx = 0; xx < w; xx++) {
+        if (!(bit++ & 7))
+          bits = pgm_read_byte(&bitmap[bo++]);
+        if (bits & 0x80) {
+          if (sizeX == 1 && sizeY == 1)
+            writePixel(x + xo + xx, y + yo + yy, color);
+          else
+            fillRect(x + (xo16 + xx) * sizeX, y + (yo16 + yy) * sizeY, sizeX, sizeY, color);
+        }
+        bits <<= 1;
+      }
+    }
+    endWrite();
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (!gfxFont)
+      return 1;
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += (int16_t)textsize_y * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+    } else if (c != '\r') {
+      uint8_t first = pgm_read_byte(&gfxFont->first);
+      if (c >= first && c <= (uint8_t)pgm_read_byte(&gfxFont->last)) {
+        const GFXglyph *glyph = gfxFont->glyph + (c - first);
+        uint8_t w = pgm_read_byte(&glyph->width);
+        uint8_t h = pgm_read_byte(&glyph->height);
+        if (w > 0 && h > 0) {
+          int16_t xo = (int8_t)pgm_read_byte(&glyph->xOffset);
+          if (wrap && ((cursor_x + textsize_x * (xo + w)) > _width)) {
+            cursor_x = 0;
+            cursor_y += (int16_t)textsize_y * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+          }
+          drawChar(cursor_x, cursor_y, c, textcolor, textsize_x, textsize_y);
+        }
+        cursor_x += (uint8_t)pgm_read_byte(&glyph->xAdvance) * (int16_t)textsize_x;
+      }
+    }
+    return 1;
+  }
+
+  void setCursor(int16_t x, int16_t y) {
+    cursor_x = x;
+    cursor_y = y;
+  }
+  void setTextColor(uint16_t c) { textcolor = c; }
+  void setTextColor(uint16_t c, uint16_t) { textcolor = c; }
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = s ? s : 1; }
+  void setTextWrap(bool w) { wrap = w; }
+  void setFont(const GFXfont *f) { gfxFont = (GFXfont *)f; }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+  uint8_t getRotation() const { return 0; }
+  int16_t getCursorX() const { return cursor_x; }
+  int16_t getCursorY() const { return cursor_y; }
+
+protected:
+  static void swap(int16_t &a, int16_t &b) {
+    int16_t t = a;
+    a = b;
+    b = t;
+  }
+
+  const int16_t WIDTH;  ///< Display width without rotation.
+  const int16_t HEIGHT; ///< Display height without rotation.
+  int16_t _width;       ///< Display width with rotation.
+  int16_t _height;      ///< Display height with rotation.
+  int16_t cursor_x = 0;
+  int16_t cursor_y = 0;
+  uint16_t textcolor = 0xFFFF;
+  uint8_t textsize_x = 1;
+  uint8_t textsize_y = 1;
+  bool wrap = true;
+  GFXfont *gfxFont = nullptr;
+};
+
+#endif // S3UI_HOST_ADAFRUIT_GFX_H
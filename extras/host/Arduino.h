@@ -0,0 +1,90 @@
+#ifndef S3UI_HOST_ARDUINO_H
+#define S3UI_HOST_ARDUINO_H
+
+/**
+ * @file Arduino.h
+ * @brief Minimal Arduino core stand-in for building s3ui on a desktop host (see s3ui_bench.cpp).
+ *
+ * Provides only what the library uses: PROGMEM access (flash is ordinary memory here), F()/PSTR strings,
+ * a small String class, Print (text and unsigned numbers) and a millis()/micros() clock the host program sets
+ * through hostMillis.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+
+/** @brief Current time returned by millis(); host programs advance it explicitly. */
+extern unsigned long hostMillis;
+
+inline unsigned long millis() { return hostMillis; }
+inline unsigned long micros() { return hostMillis * 1000UL; }
+
+/** @brief Heap-backed string with the part of the Arduino String API that s3ui and the examples use. */
+class String {
+public:
+  String(const char *text = "") { assign(text, strlen(text)); }
+  String(const String &other) { assign(other.buf, other.len); }
+  ~String() { free(buf); }
+  String &operator=(const String &other) {
+    if (this != &other) {
+      free(buf);
+      assign(other.buf, other.len);
+    }
+    return *this;
+  }
+  unsigned int length() const { return len; }
+  const char *c_str() const { return buf; }
+
+private:
+  void assign(const char *text, unsigned int n) {
+    buf = (char *)malloc(n + 1);
+    memcpy(buf, text, n);
+    buf[n] = '\0';
+    len = n;
+  }
+
+  char *buf;
+  unsigned int len;
+};
+
+/** @brief Character sink base class, as in the Arduino core. */
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--)
+      n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+  size_t print(const char *str) { return write(str); }
+  size_t print(const __FlashStringHelper *str) { return write((const char *)str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned long n) {
+    char buffer[12];
+    snprintf(buffer, sizeof(buffer), "%lu", n);
+    return write(buffer);
+  }
+  size_t print(unsigned int n) { return print((unsigned long)n); }
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(T value) { return print(value) + println(); }
+};
+
+#endif // S3UI_HOST_ARDUINO_H
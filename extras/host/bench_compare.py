@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""Compare two s3ui_bench result files and report regressions.
+
+    python3 extras/host/bench_compare.py baseline.csv current.csv [--time-tolerance 25]
+
+Counts (drawPixel calls, allocations, allocated bytes) are deterministic, so any increase is reported. Times
+depend on the host, so they are only reported when they grow by more than the tolerance in percent and by more
+than 0.5 us; compare files measured on the same machine. Exits with status 1 when anything regressed.
+"""
+
+import argparse
+import csv
+import sys
+
+COUNTS = ("draw_pixels", "allocs", "alloc_bytes")
+TIME = "us_per_call"
+TIME_FLOOR_US = 0.5
+
+
+def load(path):
+    with open(path, newline="") as f:
+        return {(row["path"], row["screen"], row["case"]): row for row in csv.DictReader(f)}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--time-tolerance", type=float, default=25.0,
+                        help="allowed growth of us_per_call in percent (default 25)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+    for key, row in current.items():
+        name = ",".join(key)
+        old = baseline.get(key)
+        if old is None:
+            print(f"new       {name}")
+            continue
+        for column in COUNTS:
+            before, after = float(old[column]), float(row[column])
+            if after > before:
+                print(f"REGRESSED {name}: {column} {before:g} -> {after:g}")
+                regressions += 1
+            elif after < before:
+                print(f"improved  {name}: {column} {before:g} -> {after:g}")
+        before, after = float(old[TIME]), float(row[TIME])
+        if before > 0 and after - before > TIME_FLOOR_US and (after - before) * 100.0 / before > args.time_tolerance:
+            print(f"REGRESSED {name}: {TIME} {before:g} -> {after:g} (+{(after - before) * 100.0 / before:.0f}%)")
+            regressions += 1
+    for key in baseline.keys() - current.keys():
+        print(f"missing   {','.join(key)}")
+
+    print(f"{len(current)} cases, {regressions} regressions")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
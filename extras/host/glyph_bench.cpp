@@ -0,0 +1,240 @@
+// Glyph cache benchmark: text throughput of s3ui with a small (3x5) and a large (9x13) font at several text
+// sizes, with the glyph cache off, small and large, through Adafruit_GFX (a 1-bpp canvas with byte-wise lines
+// and rectangles, like GFXcanvas1 or a buffered SSD1306 driver) and through horizontal and vertical framebuffers.
+// Every configuration first renders the same call sequence in lockstep and must produce the same pixels as
+// the others of its layout after every step; then each one is timed. Characters per second count every
+// character the timed screen calls printed (S3UI_RENDER_STATS), so they include the rest of the drawing those
+// calls do; display_calls counts the Adafruit_GFX drawing calls (drawPixel, lines, rectangles) per call.
+// Results are printed on stdout as CSV:
+//   path,font,size,cache_bytes,workload,iterations,us_per_call,chars_per_call,chars_per_s,display_calls,hits,misses,
+//   evictions,hit_rate
+// followed by one "check" row per font, size and workload. Exits with status 1 if any output differed.
+//
+// Build and run with run_glyph_bench.sh.
+
+#include <chrono>
+#include "Arduino.h"
+#include "Adafruit_GFX.h"
+#include "s3ui.h"
+#include "test_fixture.h"
+
+#ifndef S3UI_RENDER_STATS
+#error "Build with -DS3UI_RENDER_STATS (see run_glyph_bench.sh)"
+#endif
+
+unsigned long hostMillis = 0;
+
+static const int16_t kWidth = 128;
+static const int16_t kHeight = 128;
+static const uint16_t kCanvasBytes = ((kWidth + 7) / 8) * kHeight;
+static uint16_t iterations = 200;
+
+// 1-bpp canvas in GFXcanvas1 memory layout (the same as a horizontal framebuffer) that counts drawing calls
+class PixelCanvas : public Adafruit_GFX {
+public:
+  PixelCanvas() : Adafruit_GFX(kWidth, kHeight), calls(0) { memset(buffer, 0, sizeof(buffer)); }
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    calls++;
+    setPixel(x, y, color);
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    calls++;
+    fill(x, y, w, 1, color);
+  }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+    calls++;
+    fill(x, y, 1, h, color);
+  }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+    calls++;
+    fill(x, y, w, h, color);
+  }
+
+  uint8_t buffer[kCanvasBytes];
+  uint32_t calls; ///< Drawing calls since the counter was last reset.
+
+private:
+  void setPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || y < 0 || x >= kWidth || y >= kHeight)
+      return;
+    uint8_t *p = &buffer[x / 8 + y * ((kWidth + 7) / 8)];
+    if (color)
+      *p |= 0x80 >> (x & 7);
+    else
+      *p &= ~(0x80 >> (x & 7));
+  }
+  void fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t j = y; j < y + h; j++) {
+      for (int16_t i = x; i < x + w; i++)
+        setPixel(i, j, color);
+    }
+  }
+};
+
+// Generated fonts: the small one is the font of the other host programs (glyphs up to 3x5 pixels, 7-pixel
+// line, like Picopixel); the large one has glyphs up to 9x13 pixels on a 16-pixel line, like FreeSans9pt7b
+struct BenchFont {
+  const char *name;
+  uint8_t maxSize; ///< Largest text size that still leaves a log window on the display.
+  TestFont glyphs;
+};
+static BenchFont fonts[] = {{"small", 3, {2, 3, 2, 5, 7}}, {"large", 2, {6, 9, 8, 13, 16}}};
+
+// The horizontal framebuffer draws into the canvas buffer, so gfx and framebuffer pixels compare directly
+enum Path : uint8_t { PATH_GFX, PATH_HORIZONTAL, PATH_VERTICAL };
+static const char *const kPathNames[] = {"gfx", "framebuffer", "framebuffer_vertical"};
+
+struct Config {
+  Path path;
+  uint16_t cacheBytes;
+};
+static const Config kConfigs[] = {{PATH_GFX, 0},      {PATH_GFX, 512},      {PATH_GFX, 4096},
+                                  {PATH_HORIZONTAL, 0}, {PATH_HORIZONTAL, 512}, {PATH_HORIZONTAL, 4096},
+                                  {PATH_VERTICAL, 0},   {PATH_VERTICAL, 512},   {PATH_VERTICAL, 4096}};
+static const uint8_t kNumConfigs = sizeof(kConfigs) / sizeof(kConfigs[0]);
+
+struct Screen {
+  PixelCanvas canvas;
+  uint8_t vertical[kCanvasBytes];
+  s3ui ui;
+
+  void setup(const Config &config, const GFXfont *font, uint8_t size) {
+    memset(vertical, 0, sizeof(vertical));
+    ui.setDisplay(&canvas, kWidth, kHeight);
+    if (config.path == PATH_VERTICAL)
+      ui.setFramebuffer(vertical, S3UI_LAYOUT_VERTICAL);
+    else
+      ui.setFramebuffer(config.path == PATH_HORIZONTAL ? canvas.buffer : nullptr, S3UI_LAYOUT_HORIZONTAL);
+    ui.setTitleFont(font);
+    ui.setContentFont(font);
+    ui.setTitleSize(size);
+    ui.setContentSize(size);
+    ui.setGlyphCache(config.cacheBytes);
+    ui.setSmoothScroll(0);
+    ui.setLogCapacity(0, 0);
+    ui.clear();
+  }
+};
+
+// full: option list drawn from scratch; scroll: the cursor walks the list with smooth scrolling, so rows are
+// drawn clipped to the list window; log: a 200-entry log scrolled back and forth
+enum Workload : uint8_t { WORK_FULL, WORK_SCROLL, WORK_LOG, WORKLOADS };
+static const char *const kWorkloadNames[] = {"options_full", "options_scroll", "log_scroll"};
+
+static void prepare(s3ui &ui, Workload work) {
+  char line[48];
+  if (work == WORK_SCROLL)
+    ui.setSmoothScroll(100, 30);
+  if (work == WORK_LOG) {
+    for (uint16_t i = 0; i < 200; i++) {
+      snprintf(line, sizeof(line), "%u rssi -%udBm link %s", i, 40 + i % 50, (i % 3) ? "up" : "retry");
+      ui.appendLogLine(line);
+    }
+    ui.activityLiveLogScreen("Log", "84%");
+  }
+  ui.update();
+}
+
+static void step(s3ui &ui, Workload work, uint16_t i) {
+  switch (work) {
+  case WORK_FULL:
+    ui.invalidate();
+    ui.optionSelectScreen("Menu", "84%", kOptions, kNumOptions, i % kNumOptions);
+    break;
+  case WORK_SCROLL:
+    ui.optionSelectScreen("Menu", "84%", kOptions, kNumOptions, (i / 4) % kNumOptions);
+    break;
+  default:
+    ui.scrollLog((i % 16 < 8) ? -3 : 3);
+    ui.activityLiveLogScreen("Log", "84%");
+    break;
+  }
+  ui.update();
+}
+
+static int failures = 0;
+
+// All configurations run the same steps at the same time and must show the same pixels after each one
+static void check(BenchFont &font, uint8_t size, Workload work) {
+  static Screen screens[kNumConfigs];
+  hostMillis = 0;
+  for (uint8_t c = 0; c < kNumConfigs; c++) {
+    screens[c].setup(kConfigs[c], &font.glyphs.font, size);
+    prepare(screens[c].ui, work);
+  }
+  bool same = true;
+  for (uint16_t i = 0; i < iterations && same; i++) {
+    hostMillis += 17;
+    for (uint8_t c = 0; c < kNumConfigs; c++) {
+      step(screens[c].ui, work, i);
+      bool vertical = kConfigs[c].path == PATH_VERTICAL;
+      const uint8_t *pixels = vertical ? screens[c].vertical : screens[c].canvas.buffer;
+      const uint8_t *reference = vertical ? screens[kNumConfigs - 3].vertical : screens[0].canvas.buffer;
+      if (memcmp(pixels, reference, kCanvasBytes) != 0)
+        same = false;
+    }
+  }
+  printf("check,%s,%u,,%s,%u,%s\n", font.name, size, kWorkloadNames[work], iterations,
+         same ? "identical" : "DIFFERENT");
+  if (!same)
+    failures++;
+}
+
+static const uint8_t kRounds = 5;
+
+static void measure(const Config &config, BenchFont &font, uint8_t size, Workload work) {
+  static Screen screen;
+  uint32_t chars = 0;
+  uint32_t calls = 0;
+  double best = 0;
+  for (uint8_t round = 0; round < kRounds; round++) {
+    hostMillis = 0;
+    screen.setup(config, &font.glyphs.font, size);
+    prepare(screen.ui, work);
+    screen.canvas.calls = 0;
+    screen.ui.resetRenderStats();
+    screen.ui.resetGlyphCacheStats();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint16_t i = 0; i < iterations; i++) {
+      hostMillis += 17;
+      step(screen.ui, work, i);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    if (round == 0 || us < best)
+      best = us;
+    chars = screen.ui.getRenderStats().total.charsPrinted;
+    calls = screen.canvas.calls;
+  }
+  const s3uiGlyphCacheStats &stats = screen.ui.getGlyphCacheStats();
+  uint32_t lookups = stats.hits + stats.misses;
+  printf("%s,%s,%u,%u,%s,%u,%.2f,%.1f,%.0f,%.1f,%lu,%lu,%lu,%.3f\n", kPathNames[config.path], font.name, size,
+         config.cacheBytes, kWorkloadNames[work], iterations, best / iterations, (double)chars / iterations,
+         chars / (best / 1e6), (double)calls / iterations, (unsigned long)stats.hits, (unsigned long)stats.misses,
+         (unsigned long)stats.evictions, lookups ? (double)stats.hits / lookups : 0.0);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+    iterations = (uint16_t)atoi(argv[1]);
+  if (iterations == 0)
+    iterations = 1;
+
+  printf("path,font,size,cache_bytes,workload,iterations,us_per_call,chars_per_call,chars_per_s,display_calls,hits,"
+         "misses,evictions,hit_rate\n");
+  for (BenchFont &font : fonts) {
+    for (uint8_t size = 1; size <= font.maxSize; size++) {
+      for (uint8_t work = 0; work < WORKLOADS; work++) {
+        for (uint8_t c = 0; c < kNumConfigs; c++)
+          measure(kConfigs[c], font, size, (Workload)work);
+      }
+    }
+  }
+  for (BenchFont &font : fonts) {
+    for (uint8_t size = 1; size <= font.maxSize; size++) {
+      for (uint8_t work = 0; work < WORKLOADS; work++)
+        check(font, size, (Workload)work);
+    }
+  }
+  return failures ? 1 : 0;
+}
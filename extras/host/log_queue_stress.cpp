@@ -0,0 +1,212 @@
+// s3ui log queue stress test: hammers s3uiQueue and s3ui::queueLogRecord() from several threads while a
+// consumer drains concurrently, for every producer/overflow mode, and checks that
+// - every record arrives intact and each producer's records arrive in order, without duplicates,
+// - every push is accounted for: records consumed + records dropped == records pushed,
+// - with S3UI_QUEUE_DROP_NEWEST, push() returns false exactly for the dropped records,
+// - setLogLevel() may change the level while producers are queueing records.
+// Prints one line per scenario and exits with status 1 if any of them failed.
+//
+// Build and run with run_queue_stress.sh (add CXXFLAGS=-fsanitize=thread to check for data races too).
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Arduino.h"
+#include "Adafruit_GFX.h"
+#include "s3ui.h"
+#include "test_fixture.h"
+
+unsigned long hostMillis = 0;
+
+static const uint32_t kPushesPerProducer = 200000;
+
+static uint32_t checksum(uint32_t serial) { return (serial ^ 0x5A5A5A5AUL) * 2654435761UL; }
+
+// Checks the records of one scenario as the consumer receives them
+struct Checker {
+  std::vector<int64_t> lastSerial;
+  uint32_t consumed = 0;
+  bool ok = true;
+
+  explicit Checker(uint8_t producers) : lastSerial(producers, -1) {}
+
+  void check(const s3uiLogRecord &record) {
+    uint32_t producer = record.args[0].asUnsigned();
+    uint32_t serial = record.args[1].asUnsigned();
+    if (producer >= lastSerial.size() || record.args[2].asUnsigned() != checksum(serial) ||
+        record.args[3].asUnsigned() != producer + serial || record.level != S3UI_LOG_INFO) {
+      printf("  corrupt record: producer %u serial %u\n", (unsigned)producer, (unsigned)serial);
+      ok = false;
+      return;
+    }
+    if ((int64_t)serial <= lastSerial[producer]) {
+      printf("  out of order: producer %u serial %u after %lld\n", (unsigned)producer, (unsigned)serial,
+             (long long)lastSerial[producer]);
+      ok = false;
+    }
+    lastSerial[producer] = serial;
+    consumed++;
+  }
+};
+
+static s3uiLogRecord makeRecord(uint32_t producer, uint32_t serial) {
+  s3uiLogRecord record;
+  record.timestamp = serial;
+  record.format = "p%u #%u";
+  record.args[0] = producer;
+  record.args[1] = serial;
+  record.args[2] = checksum(serial);
+  record.args[3] = producer + serial;
+  record.level = S3UI_LOG_INFO;
+  return record;
+}
+
+static const char *modeName(s3uiQueueProducers producers, s3uiQueueOverflow overflow) {
+  if (producers == S3UI_QUEUE_SINGLE_PRODUCER)
+    return overflow == S3UI_QUEUE_DROP_NEWEST ? "single/drop_newest" : "single/drop_oldest";
+  return overflow == S3UI_QUEUE_DROP_NEWEST ? "multi/drop_newest" : "multi/drop_oldest";
+}
+
+// Producers push into a bare s3uiQueue while this thread pops
+static bool runQueue(s3uiQueueProducers producers, s3uiQueueOverflow overflow, uint8_t producerCount,
+                     uint16_t capacity) {
+  s3uiQueue queue;
+  if (!queue.configure(capacity, sizeof(s3uiLogRecord), producers, overflow)) {
+    printf("queue %s: configure failed\n", modeName(producers, overflow));
+    return false;
+  }
+
+  std::atomic<uint8_t> running(producerCount);
+  std::atomic<uint32_t> rejected(0);
+  std::vector<std::thread> threads;
+  for (uint8_t p = 0; p < producerCount; p++) {
+    threads.emplace_back([&, p]() {
+      for (uint32_t serial = 0; serial < kPushesPerProducer; serial++) {
+        s3uiLogRecord record = makeRecord(p, serial);
+        if (!queue.push(&record))
+          rejected++;
+        if ((serial & 0x3FF) == 0)
+          std::this_thread::yield();
+      }
+      running--;
+    });
+  }
+
+  Checker checker(producerCount);
+  s3uiLogRecord record;
+  while (running.load() || queue.pending()) {
+    if (queue.pop(&record))
+      checker.check(record);
+  }
+  for (std::thread &t : threads)
+    t.join();
+  while (queue.pop(&record))
+    checker.check(record);
+
+  uint32_t pushed = kPushesPerProducer * producerCount;
+  bool ok = checker.ok && checker.consumed + queue.dropped() == pushed;
+  if (overflow == S3UI_QUEUE_DROP_NEWEST && rejected.load() != queue.dropped())
+    ok = false;
+  printf("queue %-18s producers %u capacity %u: pushed %u consumed %u dropped %u rejected %u %s\n",
+         modeName(producers, overflow), producerCount, queue.capacity(), (unsigned)pushed, (unsigned)checker.consumed,
+         (unsigned)queue.dropped(), (unsigned)rejected.load(), ok ? "OK" : "FAIL");
+  return ok;
+}
+
+// Producers log through s3ui::queueLogRecord() while this thread runs update(), as loop() would
+static bool runUi(s3uiQueueProducers producers, s3uiQueueOverflow overflow, uint8_t producerCount) {
+  NullCanvas canvas;
+  s3ui ui;
+  ui.setDisplay(&canvas, 96, 65);
+  ui.setLogQueue(64, producers, overflow);
+
+  std::atomic<uint8_t> running(producerCount);
+  std::vector<std::thread> threads;
+  const uint32_t pushes = kPushesPerProducer / 10;
+  for (uint8_t p = 0; p < producerCount; p++) {
+    threads.emplace_back([&, p]() {
+      for (uint32_t serial = 0; serial < pushes; serial++)
+        ui.queueLogRecord(S3UI_LOG_INFO, F("p%u #%u"), p, serial);
+      running--;
+    });
+  }
+  while (running.load())
+    ui.update();
+  for (std::thread &t : threads)
+    t.join();
+  ui.update();
+  ui.update();
+
+  uint32_t pushed = pushes * producerCount;
+  bool ok = ui.getLogLineCount() + ui.getLogQueueDropped() == pushed;
+  printf("ui    %-18s producers %u: pushed %u logged %u dropped %u %s\n", modeName(producers, overflow),
+         producerCount, (unsigned)pushed, ui.getLogLineCount(), (unsigned)ui.getLogQueueDropped(), ok ? "OK" : "FAIL");
+  return ok;
+}
+
+// Another thread flips setLogLevel() while producers queue INFO records: the level filter may drop any of them,
+// but no record may be logged twice or invented, and once WARN is set no INFO record gets through
+static bool runLevelChange(uint8_t producerCount) {
+  NullCanvas canvas;
+  s3ui ui;
+  ui.setDisplay(&canvas, 96, 65);
+  ui.setLogQueue(64, S3UI_QUEUE_MULTI_PRODUCER, S3UI_QUEUE_DROP_NEWEST);
+
+  std::atomic<uint8_t> running(producerCount);
+  std::atomic<uint32_t> flips(0);
+  std::vector<std::thread> threads;
+  const uint32_t pushes = kPushesPerProducer / 10;
+  for (uint8_t p = 0; p < producerCount; p++) {
+    threads.emplace_back([&, p]() {
+      while (!flips.load())
+        std::this_thread::yield();
+      for (uint32_t serial = 0; serial < pushes; serial++) {
+        ui.queueLogRecord(S3UI_LOG_INFO, F("p%u #%u"), p, serial);
+        if ((serial & 0x3F) == 0)
+          std::this_thread::yield();
+      }
+      running--;
+    });
+  }
+  threads.emplace_back([&]() {
+    while (running.load()) {
+      ui.setLogLevel(flips.load() & 1 ? S3UI_LOG_DEBUG : S3UI_LOG_WARN);
+      flips++;
+      std::this_thread::yield();
+    }
+  });
+  while (running.load())
+    ui.update();
+  for (std::thread &t : threads)
+    t.join();
+  ui.update();
+
+  uint32_t pushed = pushes * producerCount;
+  uint32_t accounted = ui.getLogLineCount() + ui.getLogQueueDropped();
+  ui.setLogLevel(S3UI_LOG_WARN);
+  uint16_t before = ui.getLogLineCount();
+  for (uint32_t serial = 0; serial < 100; serial++)
+    ui.queueLogRecord(S3UI_LOG_INFO, F("late #%u"), serial);
+  ui.update();
+  bool ok = accounted <= pushed && ui.getLogLineCount() == before;
+  printf("level %-18s producers %u: pushed %u logged %u dropped %u flips %u %s\n",
+         modeName(S3UI_QUEUE_MULTI_PRODUCER, S3UI_QUEUE_DROP_NEWEST), producerCount, (unsigned)pushed, before,
+         (unsigned)ui.getLogQueueDropped(), (unsigned)flips.load(), ok ? "OK" : "FAIL");
+  return ok;
+}
+
+int main() {
+  static const s3uiQueueOverflow kOverflows[] = {S3UI_QUEUE_DROP_NEWEST, S3UI_QUEUE_DROP_OLDEST};
+  bool ok = true;
+  for (s3uiQueueOverflow overflow : kOverflows) {
+    ok = runQueue(S3UI_QUEUE_SINGLE_PRODUCER, overflow, 1, 8) && ok;
+    ok = runQueue(S3UI_QUEUE_SINGLE_PRODUCER, overflow, 1, 1024) && ok;
+    ok = runQueue(S3UI_QUEUE_MULTI_PRODUCER, overflow, 4, 8) && ok;
+    ok = runQueue(S3UI_QUEUE_MULTI_PRODUCER, overflow, 4, 1024) && ok;
+    ok = runUi(S3UI_QUEUE_SINGLE_PRODUCER, overflow, 1) && ok;
+    ok = runUi(S3UI_QUEUE_MULTI_PRODUCER, overflow, 4) && ok;
+  }
+  ok = runLevelChange(4) && ok;
+  printf(ok ? "all scenarios passed\n" : "FAILED\n");
+  return ok ? 0 : 1;
+}
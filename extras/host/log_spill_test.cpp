@@ -0,0 +1,235 @@
+// Spilled log test: an s3ui with a small RAM window spills a long log (lines, multi-line entries and records)
+// to two plain files and must show every scroll position exactly like an s3ui that keeps the whole log in
+// RAM. Then the heap must stay flat while the log keeps growing, a new s3ui must pick up the log from the
+// files, entries evicted before update() could write them must be counted, and a failing file must stop
+// spilling without breaking the view. Prints one line per check and exits with status 1 if any failed.
+//
+// Build and run with run_log_spill.sh.
+
+#include <malloc.h>
+#include <string>
+#include "Arduino.h"
+#include "Adafruit_GFX.h"
+#include "s3ui.h"
+#include "test_fixture.h"
+
+unsigned long hostMillis = 0;
+
+static const int16_t kWidth = 96;
+static const int16_t kHeight = 65;
+static const uint16_t kFrameBytes = kWidth * ((kHeight + 7) / 8);
+static const uint32_t kEntries = 20000;
+
+// A host file with the part of the Arduino File API that s3uiFileStorage uses
+class HostFile {
+private:
+  FILE *file;
+
+public:
+  explicit HostFile(const char *path, const char *mode) : file(fopen(path, mode)) {}
+  ~HostFile() {
+    if (file)
+      fclose(file);
+  }
+  bool isOpen() const { return file != nullptr; }
+  bool seek(uint32_t position) { return fseek(file, position, SEEK_SET) == 0; }
+  int read(uint8_t *buffer, size_t bytes) { return fread(buffer, 1, bytes, file); }
+  size_t write(const uint8_t *data, size_t bytes) { return fwrite(data, 1, bytes, file); }
+  uint32_t size() {
+    long position = ftell(file);
+    fseek(file, 0, SEEK_END);
+    long end = ftell(file);
+    fseek(file, position, SEEK_SET);
+    return end;
+  }
+  void flush() { fflush(file); }
+};
+
+// Storage that accepts a number of bytes and then fails every write
+class FailingStorage : public s3uiLogStorage {
+private:
+  uint32_t budget;
+  uint32_t length;
+
+public:
+  explicit FailingStorage(uint32_t bytes) : budget(bytes), length(0) {}
+  bool seek(uint32_t) { return true; }
+  size_t read(uint8_t *, size_t) { return 0; }
+  size_t write(const uint8_t *, size_t bytes) {
+    if (bytes > budget)
+      return 0;
+    budget -= bytes;
+    length += bytes;
+    return bytes;
+  }
+  uint32_t size() { return length; }
+};
+
+static int failures = 0;
+
+static void report(const char *check, bool ok) {
+  printf("%-40s %s\n", check, ok ? "ok" : "FAILED");
+  if (!ok)
+    failures++;
+}
+
+struct Screen {
+  NullCanvas canvas;
+  uint8_t frame[kFrameBytes];
+  s3ui ui;
+
+  Screen() {
+    memset(frame, 0, sizeof(frame));
+    ui.setDisplay(&canvas, kWidth, kHeight);
+    ui.setTitleFont(&testFont.font);
+    ui.setContentFont(&testFont.font);
+    ui.setTitleSize(1);
+    ui.setContentSize(1);
+    ui.setFramebuffer(frame, S3UI_LAYOUT_VERTICAL);
+  }
+};
+
+// Entry n of the test log: short lines, lines that wrap, multi-line entries and records
+static void addEntry(s3ui &ui, uint32_t n) {
+  char text[64];
+  switch (n % 5) {
+  case 0: ui.logRecord(S3UI_LOG_INFO, F("rec %lu"), (unsigned long)n); return;
+  case 1: snprintf(text, sizeof(text), "Line %lu", (unsigned long)n); break;
+  case 2: snprintf(text, sizeof(text), "Entry %lu wraps over more than one line of the log", (unsigned long)n); break;
+  case 3: snprintf(text, sizeof(text), "Multi %lu\nsecond line", (unsigned long)n); break;
+  default: ui.logRecord(S3UI_LOG_WARN, F("warn %lu"), (unsigned long)n); return;
+  }
+  ui.appendLogLine(text);
+}
+
+static bool sameFrame(Screen &a, Screen &b) {
+  a.ui.update();
+  b.ui.update();
+  return memcmp(a.frame, b.frame, kFrameBytes) == 0;
+}
+
+// Scroll both logs back step by step from the end, then forward again, comparing every view
+static bool sameScrolling(Screen &a, Screen &b, uint32_t steps, int32_t stride) {
+  a.ui.scrollLogToEnd();
+  b.ui.scrollLogToEnd();
+  if (!sameFrame(a, b))
+    return false;
+  for (uint32_t i = 0; i < steps; i++) {
+    a.ui.scrollLog(-stride);
+    b.ui.scrollLog(-stride);
+    if (!sameFrame(a, b))
+      return false;
+  }
+  a.ui.scrollLog(-100000000);
+  b.ui.scrollLog(-100000000);
+  if (!sameFrame(a, b))
+    return false;
+  for (uint32_t i = 0; i < steps; i++) {
+    a.ui.scrollLog(stride);
+    b.ui.scrollLog(stride);
+    if (!sameFrame(a, b))
+      return false;
+  }
+  return true;
+}
+
+int main() {
+  const char *dataPath = "/tmp/s3ui_spill.log";
+  const char *indexPath = "/tmp/s3ui_spill.idx";
+
+  Screen reference;
+  Screen spilled;
+  spilled.ui.setLogCapacity(1024, 32);
+  {
+    HostFile dataFile(dataPath, "w+b");
+    HostFile indexFile(indexPath, "w+b");
+    s3uiFileStorage<HostFile> data(dataFile);
+    s3uiFileStorage<HostFile> index(indexFile);
+    report("spill attached", dataFile.isOpen() && spilled.ui.setLogSpill(&data, &index, 8));
+    reference.ui.activityLiveLogScreen("Log", "90%");
+    spilled.ui.activityLiveLogScreen("Log", "90%");
+
+    // update() after every few appends, as a loop() would
+    for (uint32_t n = 0; n < kEntries; n++) {
+      addEntry(reference.ui, n);
+      addEntry(spilled.ui, n);
+      if (n % 4 == 3) {
+        reference.ui.update();
+        spilled.ui.update();
+      }
+    }
+    report("tail view", sameFrame(reference, spilled));
+    report("scroll by lines near both ends", sameScrolling(reference, spilled, 200, 1));
+    report("scroll by pages through the log", sameScrolling(reference, spilled, 2000, 29));
+    report("no entries lost", spilled.ui.getLogSpillLost() == 0);
+
+    // RAM stays the same however long the log gets
+    size_t heapBefore = mallinfo2().uordblks;
+    for (uint32_t n = kEntries; n < 2 * kEntries; n++) {
+      addEntry(spilled.ui, n);
+      if (n % 4 == 3)
+        spilled.ui.update();
+    }
+    spilled.ui.scrollLog(-100000000);
+    spilled.ui.update();
+    report("heap flat while the log doubles", mallinfo2().uordblks == heapBefore);
+    for (uint32_t n = kEntries; n < 2 * kEntries; n++)
+      addEntry(reference.ui, n);
+    reference.ui.scrollLog(-100000000);
+    report("top view after doubling", sameFrame(reference, spilled));
+    report("flush before closing", spilled.ui.flushLogSpill());
+    spilled.ui.setLogSpill(nullptr, nullptr);
+  }
+
+  // A new run continues the log in the files
+  {
+    HostFile dataFile(dataPath, "r+b");
+    HostFile indexFile(indexPath, "r+b");
+    s3uiFileStorage<HostFile> data(dataFile);
+    s3uiFileStorage<HostFile> index(indexFile);
+    Screen resumed;
+    resumed.ui.setLogCapacity(1024, 32);
+    report("spill reattached", resumed.ui.setLogSpill(&data, &index, 8));
+    resumed.ui.activityLiveLogScreen("Log", "90%");
+    reference.ui.scrollLogToEnd();
+    report("resumed tail view", sameFrame(reference, resumed));
+    report("resumed scrolling", sameScrolling(reference, resumed, 300, 7));
+    for (uint32_t n = 2 * kEntries; n < 2 * kEntries + 100; n++) {
+      addEntry(reference.ui, n);
+      addEntry(resumed.ui, n);
+      resumed.ui.update();
+    }
+    report("appends after resuming", sameScrolling(reference, resumed, 100, 3));
+
+    // More appends than the RAM window holds between two update() calls
+    for (uint32_t n = 0; n < 100; n++)
+      addEntry(resumed.ui, n);
+    resumed.ui.update();
+    report("overrun counted as lost", resumed.ui.getLogSpillLost() > 0);
+  }
+
+  // A write error stops spilling; the RAM window stays on screen
+  {
+    FailingStorage data(200);
+    FailingStorage index(10000);
+    Screen failing;
+    Screen window;
+    failing.ui.setLogCapacity(1024, 32);
+    window.ui.setLogCapacity(1024, 32);
+    failing.ui.setLogSpill(&data, &index, 8);
+    failing.ui.activityLiveLogScreen("Log", "90%");
+    window.ui.activityLiveLogScreen("Log", "90%");
+    for (uint32_t n = 0; n < 200; n++) {
+      addEntry(failing.ui, n);
+      addEntry(window.ui, n);
+      failing.ui.update();
+    }
+    report("write error stops spilling", !failing.ui.flushLogSpill());
+    report("view after a write error", sameFrame(window, failing));
+  }
+
+  remove(dataPath);
+  remove(indexPath);
+  printf(failures ? "FAILED\n" : "all checks passed\n");
+  return failures ? 1 : 0;
+}
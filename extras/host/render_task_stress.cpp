@@ -0,0 +1,271 @@
+// s3uiRenderTask stress test: an application thread posts a random mix of screens, cursor moves, status
+// field updates and log records while a render thread runs the task and a flush thread plays a slow panel
+// that receives the frames asynchronously (or, in the second scenario, during the flush callback). Afterwards
+// the panel, assembled only from the dirty bands handed to the flush callback, must match an s3ui that made
+// the same calls directly. Prints one line per scenario and exits with status 1 if any of them failed.
+//
+// Build and run with run_render_task.sh (add CXXFLAGS=-fsanitize=thread to check for data races too).
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Arduino.h"
+#include "Adafruit_GFX.h"
+#include "s3ui.h"
+#include "s3uiRenderTask.h"
+#include "test_fixture.h"
+
+unsigned long hostMillis = 0;
+
+static const int16_t kWidth = 96;
+static const int16_t kHeight = 65;
+static const uint16_t kFrameBytes = kWidth * ((kHeight + 7) / 8);
+static const uint32_t kOperations = 20000;
+
+static const char *const kButtons[] = {"Yes", "No"};
+static uint8_t icon[3 * 24];
+
+static void setupUi(s3ui &ui, NullCanvas &canvas) {
+  ui.setDisplay(&canvas, kWidth, kHeight);
+  ui.setTitleFont(&testFont.font);
+  ui.setContentFont(&testFont.font);
+  ui.setTitleSize(1);
+  ui.setContentSize(1);
+  ui.setLogCapacity(2048, 64);
+  ui.addStatusField(12);
+}
+
+// The application's calls, generated the same way for the render task and for the reference s3ui
+struct Operation {
+  uint8_t kind;
+  uint16_t value;
+  char text[16];
+};
+
+enum {
+  OP_SELECT, OP_VALUE_SET, OP_CURSOR, OP_ACTIVITY, OP_CONFIRM, OP_LOG_SCREEN, OP_RECORD, OP_STATUS, OP_CLEAR, OP_LINE
+};
+
+static std::vector<Operation> makeOperations(uint32_t seed) {
+  std::vector<Operation> ops;
+  uint8_t screen = OP_LOG_SCREEN;
+  for (uint32_t i = 0; i < kOperations; i++) {
+    seed = seed * 1103515245UL + 12345UL;
+    uint32_t r = seed >> 8;
+    Operation op;
+    op.value = (r >> 8) % kNumOptions;
+    snprintf(op.text, sizeof(op.text), "Step %u", (unsigned)i);
+    switch (r % 32) {
+    case 0: op.kind = OP_SELECT; break;
+    case 1: op.kind = OP_VALUE_SET; break;
+    case 2: op.kind = OP_ACTIVITY; break;
+    case 3: op.kind = OP_CONFIRM; op.value %= 2; break;
+    case 4: op.kind = OP_LOG_SCREEN; break;
+    case 5: op.kind = OP_CLEAR; break;
+    case 6: case 7: case 8: op.kind = OP_STATUS; snprintf(op.text, sizeof(op.text), "%u", (unsigned)(r % 100)); break;
+    default:
+      if ((screen == OP_SELECT || screen == OP_VALUE_SET) && (r & 64))
+        op.kind = OP_CURSOR;
+      else
+        op.kind = (r & 128) ? OP_LINE : OP_RECORD;
+      break;
+    }
+    if (op.kind <= OP_LOG_SCREEN && op.kind != OP_CURSOR)
+      screen = op.kind;
+    ops.push_back(op);
+  }
+  return ops;
+}
+
+// Reference: the same calls made directly on an s3ui
+static void applyDirect(s3ui &ui, const Operation &op, Operation &screen) {
+  switch (op.kind) {
+  case OP_SELECT: ui.optionSelectScreen("Menu", "87%", kOptions, kNumOptions, op.value); screen = op; break;
+  case OP_VALUE_SET:
+    ui.optionValueSetScreen("Values", "87%", kOptions, kValues, kNumOptions, op.value, op.value & 1);
+    screen = op;
+    break;
+  case OP_CURSOR:
+    screen.value = op.value;
+    if (!ui.moveOptionCursor(op.value))
+      applyDirect(ui, screen, screen);
+    break;
+  case OP_ACTIVITY: ui.runningActivityScreen("Busy", "87%", icon, 24, 24, op.text); break;
+  case OP_CONFIRM: ui.confirmScreen("Sure?", "87%", icon, 24, 24, op.text, kButtons, 2, op.value); break;
+  case OP_LOG_SCREEN: ui.activityLiveLogScreen("Log", "87%"); break;
+  case OP_RECORD: ui.logRecord(S3UI_LOG_INFO, F("op %u"), op.value); break;
+  case OP_STATUS: ui.setStatusField(0, op.text); break;
+  case OP_CLEAR: ui.clearLog(); break;
+  case OP_LINE: ui.appendLogLine(op.text); break;
+  }
+}
+
+static bool post(s3uiRenderTask &task, const Operation &op) {
+  switch (op.kind) {
+  case OP_SELECT: return task.optionSelectScreen("Menu", "87%", kOptions, kNumOptions, op.value);
+  case OP_VALUE_SET:
+    return task.optionValueSetScreen("Values", "87%", kOptions, kValues, kNumOptions, op.value, op.value & 1);
+  case OP_CURSOR: return task.moveOptionCursor(op.value);
+  case OP_ACTIVITY: return task.runningActivityScreen("Busy", "87%", icon, 24, 24, op.text);
+  case OP_CONFIRM: return task.confirmScreen("Sure?", "87%", icon, 24, 24, op.text, kButtons, 2, op.value);
+  case OP_LOG_SCREEN: return task.activityLiveLogScreen("Log", "87%");
+  case OP_RECORD: return task.logRecord(S3UI_LOG_INFO, F("op %u"), op.value);
+  case OP_STATUS: return task.setStatusField(0, op.text);
+  case OP_LINE: return task.appendLogLine(op.text);
+  default: return task.clearLog();
+  }
+}
+
+// Slow panel: copies only the dirty bands of each frame it receives
+struct Panel {
+  uint8_t pixels[kFrameBytes];
+  bool async;
+  s3uiRenderTask *task = nullptr;
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::deque<std::vector<s3uiRect>> jobs;
+  const uint8_t *frame = nullptr;
+  bool stop = false;
+
+  explicit Panel(bool asyncFlush) : async(asyncFlush) { memset(pixels, 0, sizeof(pixels)); }
+
+  void copyBands(const uint8_t *buffer, const std::vector<s3uiRect> &bands) {
+    for (const s3uiRect &band : bands)
+      for (int16_t page = band.y / 8; page < (band.y + band.h + 7) / 8; page++)
+        memcpy(pixels + page * kWidth + band.x, buffer + page * kWidth + band.x, band.w);
+  }
+
+  static bool flush(const uint8_t *buffer, const s3uiRect *bands, uint8_t count, void *context) {
+    Panel *panel = static_cast<Panel *>(context);
+    std::vector<s3uiRect> list(bands, bands + count);
+    if (!panel->async) {
+      panel->copyBands(buffer, list);
+      return true;
+    }
+    std::lock_guard<std::mutex> lock(panel->mutex);
+    panel->frame = buffer;
+    panel->jobs.push_back(list);
+    panel->ready.notify_one();
+    return false;
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      ready.wait(lock, [this]() { return stop || !jobs.empty(); });
+      if (jobs.empty())
+        return;
+      std::vector<s3uiRect> bands = jobs.front();
+      const uint8_t *buffer = frame;
+      jobs.pop_front();
+      lock.unlock();
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      copyBands(buffer, bands);
+      task->flushComplete();
+      lock.lock();
+    }
+  }
+};
+
+// Render task wake-up through a condition variable
+struct Waker {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool woken = false;
+
+  static void wake(void *context) {
+    Waker *waker = static_cast<Waker *>(context);
+    std::lock_guard<std::mutex> lock(waker->mutex);
+    waker->woken = true;
+    waker->cv.notify_one();
+  }
+
+  void sleep(uint32_t ms) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait_for(lock, std::chrono::milliseconds(ms < 2 ? ms : 2), [this]() { return woken; });
+    woken = false;
+  }
+};
+
+static bool runScenario(bool asyncFlush, uint32_t seed) {
+  std::vector<Operation> ops = makeOperations(seed);
+
+  NullCanvas canvas(kWidth, kHeight);
+  s3ui ui;
+  setupUi(ui, canvas);
+  s3uiRenderTask task(ui);
+  Panel panel(asyncFlush);
+  panel.task = &task;
+  Waker waker;
+  if (!task.begin(Panel::flush, &panel, S3UI_LAYOUT_VERTICAL, 16)) {
+    printf("%s flush: begin failed\n", asyncFlush ? "async" : "sync ");
+    return false;
+  }
+  task.setWakeCallback(Waker::wake, &waker);
+
+  std::atomic<bool> posted(false);
+  std::thread flusher([&]() { panel.run(); });
+  std::thread renderer([&]() {
+    while (true) {
+      bool done = posted.load();
+      uint32_t wait = task.run();
+      if (done && task.idle())
+        return;
+      if (wait)
+        waker.sleep(wait);
+    }
+  });
+  uint32_t retries = 0;
+  for (const Operation &op : ops) {
+    while (!post(task, op)) {
+      retries++;
+      std::this_thread::yield();
+    }
+  }
+  posted = true;
+  renderer.join();
+  {
+    std::lock_guard<std::mutex> lock(panel.mutex);
+    panel.stop = true;
+    panel.ready.notify_one();
+  }
+  flusher.join();
+
+  NullCanvas referenceCanvas(kWidth, kHeight);
+  s3ui reference;
+  setupUi(reference, referenceCanvas);
+  static uint8_t expected[kFrameBytes];
+  memset(expected, 0, sizeof(expected));
+  reference.setFramebuffer(expected, S3UI_LAYOUT_VERTICAL);
+  Operation screen = ops[0];
+  for (const Operation &op : ops)
+    applyDirect(reference, op, screen);
+  reference.update();
+
+  uint16_t mismatches = 0;
+  for (uint16_t i = 0; i < kFrameBytes; i++)
+    mismatches += panel.pixels[i] != expected[i];
+  const s3uiRenderTaskStats &stats = task.getStats();
+  bool ok = mismatches == 0 && stats.commands == kOperations && task.dropped() == retries;
+  printf("%s flush: commands %u screens skipped %u frames %u flushes %u coalesced %u queue full %u, "
+         "%u bytes differ %s\n",
+         asyncFlush ? "async" : "sync ", (unsigned)stats.commands, (unsigned)stats.screensSkipped,
+         (unsigned)stats.frames, (unsigned)stats.flushes, (unsigned)stats.framesCoalesced, (unsigned)retries,
+         mismatches, ok ? "OK" : "FAIL");
+  return ok;
+}
+
+int main() {
+  for (uint8_t i = 0; i < sizeof(icon); i++)
+    icon[i] = (uint8_t)(i * 37 + 11);
+  bool ok = runScenario(true, 1);
+  ok = runScenario(false, 2) && ok;
+  ok = runScenario(true, 3) && ok;
+  printf(ok ? "all scenarios passed\n" : "FAILED\n");
+  return ok ? 0 : 1;
+}
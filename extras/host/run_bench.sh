@@ -0,0 +1,17 @@
+#!/bin/sh
+# Build the s3ui host benchmark and run it; arguments are passed on (optional iteration count).
+#   sh extras/host/run_bench.sh > results.csv
+# Environment: CXX (default g++), CXXFLAGS (e.g. -DS3UI_FIXED_WIDTH=96 -DS3UI_FIXED_HEIGHT=65),
+# ADAFRUIT_GFX_DIR (Adafruit GFX Library checkout, to measure with its Picopixel font), OUT (binary path).
+# Heap accounting wraps malloc at link time and needs GNU ld (Linux).
+set -e
+here=$(cd "$(dirname "$0")" && pwd)
+src="$here/../../src"
+out="${OUT:-${TMPDIR:-/tmp}/s3ui_bench}"
+font=""
+if [ -n "$ADAFRUIT_GFX_DIR" ]; then
+  font="-idirafter $ADAFRUIT_GFX_DIR -DS3UI_BENCH_PICOPIXEL"
+fi
+${CXX:-g++} -std=gnu++11 -O2 $CXXFLAGS $font -I"$here" -I"$src" "$here/s3ui_bench.cpp" "$src"/*.cpp \
+  -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free -o "$out"
+"$out" "$@"
@@ -0,0 +1,11 @@
+#!/bin/sh
+# Build the glyph cache benchmark and run it; arguments are passed on (optional iteration count).
+#   sh extras/host/run_glyph_bench.sh > glyphs.csv
+# Environment: CXX (default g++), CXXFLAGS (e.g. -fsanitize=address -g), OUT (binary path).
+set -e
+here=$(cd "$(dirname "$0")" && pwd)
+src="$here/../../src"
+out="${OUT:-${TMPDIR:-/tmp}/s3ui_glyph_bench}"
+${CXX:-g++} -std=gnu++11 -O2 -DS3UI_RENDER_STATS $CXXFLAGS -I"$here" -I"$src" "$here/glyph_bench.cpp" \
+  "$src"/*.cpp -o "$out"
+"$out" "$@"
@@ -0,0 +1,11 @@
+#!/bin/sh
+# Build the spilled log test and run it (exit status 1 on failure).
+#   sh extras/host/run_log_spill.sh
+# Environment: CXX (default g++), CXXFLAGS (e.g. -fsanitize=address -g), OUT (binary path).
+set -e
+here=$(cd "$(dirname "$0")" && pwd)
+src="$here/../../src"
+out="${OUT:-${TMPDIR:-/tmp}/s3ui_log_spill}"
+${CXX:-g++} -std=gnu++11 -O2 $CXXFLAGS -I"$here" -I"$src" "$here/log_spill_test.cpp" "$src"/*.cpp \
+  -o "$out"
+"$out" "$@"
@@ -0,0 +1,11 @@
+#!/bin/sh
+# Build the s3uiRenderTask stress test and run it (exit status 1 on failure).
+#   sh extras/host/run_render_task.sh
+# Environment: CXX (default g++), CXXFLAGS (e.g. -fsanitize=thread -g), OUT (binary path).
+set -e
+here=$(cd "$(dirname "$0")" && pwd)
+src="$here/../../src"
+out="${OUT:-${TMPDIR:-/tmp}/s3ui_render_task}"
+${CXX:-g++} -std=gnu++11 -O2 $CXXFLAGS -I"$here" -I"$src" "$here/render_task_stress.cpp" "$src"/*.cpp -pthread \
+  -o "$out"
+"$out" "$@"
@@ -0,0 +1,431 @@
+// s3ui host benchmark: builds the library for a desktop host against the Arduino/Adafruit_GFX stand-ins in
+// this folder and measures every screen function on a 96x65 display, through Adafruit_GFX (a canvas that
+// only implements drawPixel(), like the PCF8814 driver) and through setFramebuffer().
+// For each case it reports the time per call and, per call, the drawPixel() calls that reached the display
+// and the heap allocations (count and bytes, malloc and operator new) made by s3ui.
+// Results are printed on stdout as CSV: path,screen,case,iterations,us_per_call,draw_pixels,allocs,alloc_bytes
+//
+// Build and run with run_bench.sh; compare two result files with bench_compare.py.
+
+#include <chrono>
+#include <new>
+#include "Arduino.h"
+#include "Adafruit_GFX.h"
+#include "s3ui.h"
+#include "test_fixture.h"
+#include "../../examples/animation_benchmark/download_anim.h"
+#ifdef S3UI_BENCH_PICOPIXEL
+#include <Fonts/Picopixel.h>
+#endif
+
+unsigned long hostMillis = 0;
+
+static const int16_t kWidth = 96;
+static const int16_t kHeight = 65;
+static uint16_t iterations = 200;
+
+// Heap accounting: malloc and friends are wrapped at link time (-Wl,--wrap=...) and operator new goes through
+// malloc, so every allocation s3ui makes is counted while a case is being measured
+static bool counting = false;
+static uint32_t allocCount = 0;
+static uint32_t allocBytes = 0;
+
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size) {
+  if (counting) {
+    allocCount++;
+    allocBytes += size;
+  }
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+  if (counting) {
+    allocCount++;
+    allocBytes += count * size;
+  }
+  return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  if (counting) {
+    allocCount++;
+    allocBytes += size;
+  }
+  return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr) { __real_free(ptr); }
+}
+
+void *operator new(size_t size) {
+  void *p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete[](void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+// 1-bpp canvas (GFXcanvas1 memory layout) that counts the drawPixel() calls reaching it
+class CountingCanvas : public Adafruit_GFX {
+public:
+  CountingCanvas(int16_t w, int16_t h) : Adafruit_GFX(w, h), pixelCalls(0) {
+    buffer = (uint8_t *)calloc(((w + 7) / 8) * h, 1);
+  }
+  ~CountingCanvas() { free(buffer); }
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    pixelCalls++;
+    if (x < 0 || y < 0 || x >= width() || y >= height())
+      return;
+    uint8_t *p = &buffer[x / 8 + y * ((width() + 7) / 8)];
+    if (color)
+      *p |= 0x80 >> (x & 7);
+    else
+      *p &= ~(0x80 >> (x & 7));
+  }
+  uint8_t *getBuffer() { return buffer; }
+
+  uint32_t pixelCalls; ///< drawPixel() calls since the counter was last reset.
+
+private:
+  uint8_t *buffer;
+};
+
+#ifdef S3UI_BENCH_PICOPIXEL
+static const GFXfont *const kFont = &Picopixel;
+#else
+// Without Adafruit_GFX's fonts at hand, a generated font with Picopixel's metrics (glyphs up to 3x5 pixels,
+// 7-pixel line) stands in for it. Set ADAFRUIT_GFX_DIR for run_bench.sh to use the real Picopixel.
+static const GFXfont *const kFont = &testFont.font;
+#endif
+
+static const uint8_t kIcon[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x07, 0xff, 0xf0, 0x04, 0x00, 0x10, 0x03, 0xff, 0xe0, 0x01, 0x00, 0x40, 0x01, 0x00, 0x40,
+    0x01, 0x7f, 0x40, 0x01, 0x3e, 0x40, 0x00, 0x9c, 0x80, 0x00, 0x49, 0x00, 0x00, 0x22, 0x00, 0x00, 0x14, 0x00,
+    0x00, 0x14, 0x00, 0x00, 0x22, 0x00, 0x00, 0x49, 0x00, 0x00, 0x80, 0x80, 0x01, 0x08, 0x40, 0x01, 0x3e, 0x40,
+    0x01, 0x7f, 0x40, 0x01, 0x00, 0x40, 0x03, 0xff, 0xe0, 0x04, 0x00, 0x10, 0x07, 0xff, 0xf0, 0x00, 0x00, 0x00};
+static const uint8_t kIconSize = 24;
+static const uint8_t kIconBytes = sizeof(kIcon);
+
+// Raw frames for the frame-array overload: the icon rolled down by a few rows per frame
+static const uint8_t kNumFrames = 4;
+static uint8_t frameData[kNumFrames][kIconBytes];
+static const uint8_t *frames[kNumFrames];
+
+static void makeFrames() {
+  for (uint8_t f = 0; f < kNumFrames; f++) {
+    for (uint8_t i = 0; i < kIconBytes; i++)
+      frameData[f][i] = kIcon[(i + f * 3 * 3) % kIconBytes];
+    frames[f] = frameData[f];
+  }
+}
+
+// Button sets that select each confirm layout on a 96-pixel screen
+struct ButtonSet {
+  const char *name;
+  const char *const *labels;
+  uint8_t count;
+};
+static const char *const kOneButton[] = {"OK"};
+static const char *const kTwoButtons[] = {"Yes", "No"};
+static const char *const kThreeButtons[] = {"Save", "Skip", "Back"};
+static const char *const kTwoPlusOne[] = {"Save", "Discard", "Cancel all pending"};
+static const char *const kStacked[] = {"Save all changes now", "Discard all changes", "Cancel"};
+static const ButtonSet kButtonSets[] = {{"1_button", kOneButton, 1},
+                                        {"2_row", kTwoButtons, 2},
+                                        {"3_row", kThreeButtons, 3},
+                                        {"2_plus_1", kTwoPlusOne, 3},
+                                        {"stacked", kStacked, 3}};
+
+static CountingCanvas canvas(kWidth, kHeight);
+static s3ui ui;
+static const char *pathName = "gfx";
+
+static void setupUi(bool useFramebuffer) {
+  ui.setDisplay(&canvas, kWidth, kHeight);
+  ui.setFramebuffer(useFramebuffer ? canvas.getBuffer() : nullptr, S3UI_LAYOUT_HORIZONTAL);
+  ui.setTitleFont(kFont);
+  ui.setContentFont(kFont);
+  ui.setTitleSize(1);
+  ui.setContentSize(1);
+  ui.clear();
+  pathName = useFramebuffer ? "framebuffer" : "gfx";
+}
+
+// Run body(i) for every iteration and print one CSV row with the per-call averages. One unmeasured call first
+// brings the screen into the state the case measures (e.g. "unchanged" starts with the screen already up).
+// The loop is timed kRounds times and the fastest round is reported; counts are taken from the first round.
+static const uint8_t kRounds = 5;
+
+template <typename Body> static void measure(const char *screen, const char *caseName, Body body) {
+  body(0);
+  canvas.pixelCalls = 0;
+  allocCount = 0;
+  allocBytes = 0;
+  uint32_t pixels = 0;
+  double best = 0;
+  for (uint8_t round = 0; round < kRounds; round++) {
+    counting = (round == 0);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint16_t i = 0; i < iterations; i++)
+      body(i);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    if (round == 0 || us < best)
+      best = us;
+    if (round == 0)
+      pixels = canvas.pixelCalls;
+  }
+  counting = false;
+  printf("%s,%s,%s,%u,%.2f,%.1f,%.2f,%.1f\n", pathName, screen, caseName, iterations, best / iterations,
+         (double)pixels / iterations, (double)allocCount / iterations, (double)allocBytes / iterations);
+}
+
+static void benchOptionScreens() {
+  // full: rendered from scratch; cursor: retained screen with the cursor moving (scrolling the window at the
+  // ends); unchanged: the same call again
+  measure("optionSelectScreen", "full", [](uint16_t i) {
+    ui.invalidate();
+    ui.optionSelectScreen("Main Menu", "84%", kOptions, kNumOptions, i % kNumOptions);
+  });
+  measure("optionSelectScreen", "cursor", [](uint16_t i) {
+    ui.optionSelectScreen("Main Menu", "84%", kOptions, kNumOptions, i % kNumOptions);
+  });
+  measure("optionSelectScreen", "unchanged",
+          [](uint16_t) { ui.optionSelectScreen("Main Menu", "84%", kOptions, kNumOptions, 3); });
+
+  measure("optionValueSetScreen", "full", [](uint16_t i) {
+    ui.invalidate();
+    ui.optionValueSetScreen("Settings", "84%", kOptions, kValues, kNumOptions, i % kNumOptions, false);
+  });
+  measure("optionValueSetScreen", "cursor", [](uint16_t i) {
+    ui.optionValueSetScreen("Settings", "84%", kOptions, kValues, kNumOptions, i % kNumOptions, false);
+  });
+  measure("optionValueSetScreen", "edit_toggle", [](uint16_t i) {
+    ui.optionValueSetScreen("Settings", "84%", kOptions, kValues, kNumOptions, 3, i & 1);
+  });
+  measure("optionValueSetScreen", "unchanged", [](uint16_t) {
+    ui.optionValueSetScreen("Settings", "84%", kOptions, kValues, kNumOptions, 3, false);
+  });
+
+  // smooth_scroll_frame: one 30 fps frame of a smooth scroll between the first and the last option. A scroll
+  // lasts 10 frames; when it has ended the next call starts the scroll back, which draws its first frame.
+  static const uint8_t kFrameMs = 1000 / 30;
+  ui.setSmoothScroll(10 * kFrameMs, 30);
+  ui.invalidate();
+  ui.optionSelectScreen("Main Menu", "84%", kOptions, kNumOptions, 0);
+  ui.update();
+  measure("optionSelectScreen", "smooth_scroll_frame", [](uint16_t) {
+    static uint16_t target = kNumOptions - 1;
+    if (ui.msUntilNextUpdate() == S3UI_NO_DEADLINE) {
+      if (!ui.moveOptionCursor(target)) {
+        fprintf(stderr, "smooth_scroll_frame: moveOptionCursor(%u) failed\n", target);
+        exit(1);
+      }
+      target = kNumOptions - 1 - target;
+    }
+    hostMillis += kFrameMs;
+    ui.update();
+  });
+  ui.setSmoothScroll(0);
+}
+
+static void benchActivityScreens() {
+  static const char *const kCaption = "Scanning channels and measuring link quality";
+  measure("runningActivityScreen_bitmap", "full", [](uint16_t) {
+    ui.invalidate();
+    ui.runningActivityScreen("Running", "84%", kIcon, kIconSize, kIconSize, kCaption);
+  });
+  measure("runningActivityScreen_bitmap", "unchanged",
+          [](uint16_t) { ui.runningActivityScreen("Running", "84%", kIcon, kIconSize, kIconSize, kCaption); });
+
+  // msPerFrame = 0 makes every update() advance exactly one frame
+  measure("runningActivityScreen_frames", "full", [](uint16_t) {
+    ui.invalidate();
+    ui.runningActivityScreen("Running", "84%", frames, kNumFrames, kIconSize, kIconSize, 0, kCaption);
+  });
+  measure("runningActivityScreen_frames", "update_frame", [](uint16_t) { ui.update(); });
+
+  static uint8_t scratch[S3UI_ANIMATION_FRAME_BYTES(DOWNLOAD_ANIM_WIDTH, DOWNLOAD_ANIM_HEIGHT)];
+  measure("runningActivityScreen_encoded", "full", [](uint16_t) {
+    ui.invalidate();
+    ui.runningActivityScreen("Download", "84%", download_anim, scratch, 0, "Fetching update");
+  });
+  measure("runningActivityScreen_encoded", "update_frame", [](uint16_t) { ui.update(); });
+}
+
+static void benchLog() {
+  static const uint16_t kLineCounts[] = {10, 100, 10000};
+  static const char *const kWords[] = {"scan", "channel", "ok", "rssi", "-67dBm", "retry", "link", "up"};
+  char line[48];
+  char caseName[32];
+  uint32_t serial = 0;
+
+  for (uint8_t n = 0; n < sizeof(kLineCounts) / sizeof(kLineCounts[0]); n++) {
+    uint16_t count = kLineCounts[n];
+    // fill: loading count lines into a fresh default (growable) log, which is where its allocations show up
+    snprintf(caseName, sizeof(caseName), "fill_%u_lines", count);
+    measure("appendLogLine", caseName, [&line, count](uint16_t) {
+      ui.setLogCapacity(0, 0);
+      for (uint16_t i = 0; i < count; i++) {
+        snprintf(line, sizeof(line), "%u %s %s", i, kWords[i % 8], kWords[(i * 3 + 1) % 8]);
+        ui.appendLogLine(line);
+      }
+    });
+
+    // A ring of exactly count lines keeps the log size constant while lines are appended below
+    ui.setLogCapacity((uint32_t)count * sizeof(line), count);
+    for (uint16_t i = 0; i < count; i++) {
+      snprintf(line, sizeof(line), "%lu %s %s", (unsigned long)serial++, kWords[i % 8], kWords[(i * 3 + 1) % 8]);
+      ui.appendLogLine(line);
+    }
+    ui.activityLiveLogScreen("Log", "84%");
+    ui.update();
+
+    snprintf(caseName, sizeof(caseName), "full_%u_lines", count);
+    measure("activityLiveLogScreen", caseName, [](uint16_t) {
+      ui.invalidate();
+      ui.activityLiveLogScreen("Log", "84%");
+    });
+    snprintf(caseName, sizeof(caseName), "append_update_%u_lines", count);
+    measure("activityLiveLogScreen", caseName, [&line, &serial](uint16_t i) {
+      snprintf(line, sizeof(line), "%lu %s %s", (unsigned long)serial++, kWords[i % 8], kWords[(i * 5 + 2) % 8]);
+      ui.appendLogLine(line);
+      ui.update();
+    });
+
+    // Structured records: the append copies a fixed-size record, formatting waits for the next render
+    snprintf(caseName, sizeof(caseName), "append_%u_lines", count);
+    measure("logRecord", caseName, [](uint16_t i) {
+      ui.logRecord(S3UI_LOG_INFO, F("rssi %d dBm ch %u"), -40 - (int)(i % 50), i % 13);
+    });
+    ui.update();
+    snprintf(caseName, sizeof(caseName), "record_update_%u_lines", count);
+    measure("activityLiveLogScreen", caseName, [](uint16_t i) {
+      ui.logRecord((s3uiLogLevel)(i % S3UI_LOG_LEVELS), F("rssi %d dBm ch %u"), -40 - (int)(i % 50), i % 13);
+      ui.update();
+    });
+
+    // Scrollback: a one-line step and a jump across half of the log, each followed by the redraw
+    snprintf(caseName, sizeof(caseName), "line_%u_lines", count);
+    measure("scrollLog", caseName, [](uint16_t i) {
+      ui.scrollLog((i & 1) ? 1 : -1);
+      ui.update();
+    });
+    snprintf(caseName, sizeof(caseName), "seek_%u_lines", count);
+    measure("scrollLog", caseName, [count](uint16_t i) {
+      ui.scrollLog((i & 1) ? (int32_t)count / 2 : -(int32_t)count / 2);
+      ui.update();
+    });
+    ui.scrollLogToEnd();
+  }
+  ui.setLogCapacity(0, 0);
+}
+
+// Spill files in temporary stdio files
+class StdioStorage : public s3uiLogStorage {
+private:
+  FILE *file;
+
+public:
+  StdioStorage() : file(tmpfile()) {}
+  ~StdioStorage() { fclose(file); }
+  bool seek(uint32_t position) { return fseek(file, position, SEEK_SET) == 0; }
+  size_t read(uint8_t *buffer, size_t bytes) { return fread(buffer, 1, bytes, file); }
+  size_t write(const uint8_t *data, size_t bytes) { return fwrite(data, 1, bytes, file); }
+  uint32_t size() {
+    long position = ftell(file);
+    fseek(file, 0, SEEK_END);
+    long end = ftell(file);
+    fseek(file, position, SEEK_SET);
+    return end;
+  }
+};
+
+// A 64-entry RAM window in front of a spilled log of 100000 entries: appends with batched writes, and
+// scrollback that reads spilled entries back
+static void benchLogSpill() {
+  static const uint32_t kSpilled = 100000;
+  char line[48];
+  StdioStorage data;
+  StdioStorage index;
+  ui.setLogCapacity(64 * sizeof(line), 64);
+  ui.setLogSpill(&data, &index, 8);
+  ui.activityLiveLogScreen("Log", "84%");
+  for (uint32_t i = 0; i < kSpilled; i++) {
+    snprintf(line, sizeof(line), "%lu spilled entry", (unsigned long)i);
+    ui.appendLogLine(line);
+    if (i % 8 == 7)
+      ui.update();
+  }
+  ui.flushLogSpill();
+  ui.update();
+
+  measure("logSpill", "append_update_100000_entries", [&line](uint16_t i) {
+    snprintf(line, sizeof(line), "%u spill append", i);
+    ui.appendLogLine(line);
+    ui.update();
+  });
+  measure("logSpill", "record_update_100000_entries", [](uint16_t i) {
+    ui.logRecord(S3UI_LOG_INFO, F("rssi %d dBm ch %u"), -40 - (int)(i % 50), i % 13);
+    ui.update();
+  });
+  measure("logSpill", "line_100000_entries", [](uint16_t i) {
+    ui.scrollLog((i & 1) ? 1 : -1);
+    ui.update();
+  });
+  measure("logSpill", "seek_100000_entries", [](uint16_t i) {
+    ui.scrollLog((i & 1) ? (int32_t)kSpilled / 2 : -(int32_t)kSpilled / 2);
+    ui.update();
+  });
+  ui.setLogSpill(nullptr, nullptr);
+  ui.setLogCapacity(0, 0);
+}
+
+static void benchConfirm() {
+  char screen[48];
+  for (uint8_t s = 0; s < sizeof(kButtonSets) / sizeof(kButtonSets[0]); s++) {
+    const ButtonSet *set = &kButtonSets[s];
+    snprintf(screen, sizeof(screen), "confirmScreen_%s", set->name);
+    measure(screen, "full", [set](uint16_t i) {
+      ui.invalidate();
+      ui.confirmScreen("Confirm", "84%", "Discard changes?", set->labels, set->count, i % set->count);
+    });
+    measure(screen, "full_bitmap", [set](uint16_t i) {
+      ui.invalidate();
+      ui.confirmScreen("Confirm", "84%", kIcon, kIconSize, kIconSize, "Discard?", set->labels, set->count,
+                       i % set->count);
+    });
+    measure(screen, "select", [set](uint16_t i) {
+      ui.confirmScreen("Confirm", "84%", "Discard changes?", set->labels, set->count, i % set->count);
+    });
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+    iterations = (uint16_t)atoi(argv[1]);
+  if (iterations == 0)
+    iterations = 1;
+  makeFrames();
+
+  printf("path,screen,case,iterations,us_per_call,draw_pixels,allocs,alloc_bytes\n");
+  for (uint8_t path = 0; path < 2; path++) {
+    setupUi(path == 1);
+    benchOptionScreens();
+    benchActivityScreens();
+    benchLog();
+    benchLogSpill();
+    benchConfirm();
+  }
+  return 0;
+}
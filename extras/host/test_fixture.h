@@ -0,0 +1,57 @@
+#ifndef S3UI_HOST_TEST_FIXTURE_H
+#define S3UI_HOST_TEST_FIXTURE_H
+
+/**
+ * @file test_fixture.h
+ * @brief Fixtures shared by the host programs in this folder: a display that draws nothing, generated fonts
+ *        and the option texts the benchmarks and stress tests put on screen.
+ */
+
+#include "Adafruit_GFX.h"
+
+// Display stand-in for programs that draw into a framebuffer or only need the display size
+class NullCanvas : public Adafruit_GFX {
+public:
+  NullCanvas(int16_t w = 96, int16_t h = 65) : Adafruit_GFX(w, h) {}
+  void drawPixel(int16_t, int16_t, uint16_t) override {}
+};
+
+// A generated font with small, distinct glyphs so that different texts give different pixels. Glyph sizes are
+// picked from the given ranges (up to 9x13 pixels); the space is empty and minWidth wide
+struct TestFont {
+  uint8_t bitmap[95 * 15];
+  GFXglyph glyphs[95];
+  GFXfont font;
+
+  TestFont(uint8_t minWidth, uint8_t maxWidth, uint8_t minHeight, uint8_t maxHeight, uint8_t yAdvance) {
+    uint32_t seed = 12345;
+    uint16_t offset = 0;
+    for (uint8_t i = 0; i < 95; i++) {
+      seed = seed * 1103515245UL + 12345UL;
+      uint8_t w = (i == 0) ? 0 : minWidth + (seed >> 16) % (maxWidth - minWidth + 1);
+      uint8_t h = (i == 0) ? 0 : minHeight + (seed >> 20) % (maxHeight - minHeight + 1);
+      GFXglyph glyph = {offset, w, h, (uint8_t)(w + 1), 0, (int8_t)(1 - h)};
+      glyphs[i] = glyph;
+      for (uint8_t b = 0; b < (w * h + 7) / 8; b++) {
+        seed = seed * 1103515245UL + 12345UL;
+        bitmap[offset++] = seed >> 16;
+      }
+    }
+    glyphs[0].xAdvance = minWidth;
+    GFXfont generated = {bitmap, glyphs, 0x20, 0x7E, yAdvance};
+    font = generated;
+  }
+  TestFont(const TestFont &) = delete;
+  TestFont &operator=(const TestFont &) = delete;
+};
+
+// The font of most host programs: glyphs up to 3x5 pixels on a 7-pixel line, like Picopixel
+static TestFont testFont(2, 3, 2, 5, 7);
+
+static const char *const kOptions[] = {"Scan", "Jammer", "Channels", "Settings", "About", "Firmware",
+                                       "Wifi", "Bluetooth", "Log", "Display", "Power", "Reset"};
+static const char *const kValues[] = {"On", "25%", "Medium", "300s", "v1.2", "Auto",
+                                      "Off", "On", "Full", "50%", "Eco", "No"};
+static const uint8_t kNumOptions = sizeof(kOptions) / sizeof(kOptions[0]);
+
+#endif
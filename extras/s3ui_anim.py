@@ -0,0 +1,287 @@
+#!/usr/bin/env python3
+"""Convert animation frames into the compressed s3ui animation format (see src/s3uiAnimation.h).
+
+Frames can come from:
+  * image files or folders of images (PBM natively; PNG, BMP, GIF, ... when Pillow is installed),
+  * a sprite sheet split into equally sized frames (--frame-size WxH),
+  * C/C++ sources containing 1-bpp byte arrays such as image2cpp output (--c-arrays --frame-size WxH).
+
+The result is a C header with a PROGMEM array for s3ui::runningActivityScreen(). Frame 0 is stored as a key
+frame; every other frame is stored as an XOR delta against the previous frame, or as a key frame when that is
+smaller. Both are run-length encoded. Statistics are printed to stderr.
+
+Examples:
+  s3ui_anim.py frames/ --name spinner -o spinner.h
+  s3ui_anim.py sheet.png --frame-size 24x24 --name loader -o loader.h
+  s3ui_anim.py sketch.ino --c-arrays --frame-size 24x24 --name download -o download_anim.h
+"""
+
+import argparse
+import os
+import re
+import sys
+
+MAGIC = 0x53
+VERSION = 1
+FRAME_KEY = 0
+FRAME_DELTA = 1
+
+
+def row_bytes(width):
+    return (width + 7) // 8
+
+
+def pack_rows(pixels, width, height):
+    """Pack a row-major list of 0/1 pixels into byte-padded, MSB-first rows."""
+    out = bytearray()
+    for y in range(height):
+        for bx in range(row_bytes(width)):
+            value = 0
+            for bit in range(8):
+                x = bx * 8 + bit
+                if x < width and pixels[y * width + x]:
+                    value |= 0x80 >> bit
+            out.append(value)
+    return bytes(out)
+
+
+def read_pbm(path):
+    """Read a plain (P1) or raw (P4) PBM file; returns (width, height, pixels)."""
+    with open(path, "rb") as f:
+        data = f.read()
+    tokens = []
+    pos = 0
+    # Header: magic, width, height (comments start with '#')
+    while len(tokens) < 3:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            while data[pos:pos + 1] not in (b"\n", b""):
+                pos += 1
+            continue
+        start = pos
+        while pos < len(data) and not data[pos:pos + 1].isspace():
+            pos += 1
+        tokens.append(data[start:pos])
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+    if magic == b"P4":
+        raster = data[pos + 1:]
+        pixels = []
+        for y in range(height):
+            for x in range(width):
+                pixels.append((raster[y * row_bytes(width) + x // 8] >> (7 - x % 8)) & 1)
+        return width, height, pixels
+    if magic == b"P1":
+        bits = [int(c) for c in data[pos:].decode("ascii") if c in "01"]
+        return width, height, bits[:width * height]
+    raise ValueError("%s: unsupported PBM type %r" % (path, magic))
+
+
+def read_image(path, threshold, invert):
+    """Read any image as (width, height, pixels); set pixels are dark unless invert is given."""
+    if path.lower().endswith(".pbm"):
+        width, height, pixels = read_pbm(path)
+        return width, height, [1 - p for p in pixels] if invert else pixels
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("%s: Pillow is required for this image type (pip install pillow), or use PBM files" % path)
+    image = Image.open(path).convert("L")
+    width, height = image.size
+    pixels = [1 if (v < threshold) != invert else 0 for v in image.getdata()]
+    return width, height, pixels
+
+
+def split_sheet(width, height, pixels, frame_w, frame_h):
+    """Split a sprite sheet into frames, left to right, top to bottom."""
+    frames = []
+    for top in range(0, height - frame_h + 1, frame_h):
+        for left in range(0, width - frame_w + 1, frame_w):
+            frame = [pixels[(top + y) * width + left + x] for y in range(frame_h) for x in range(frame_w)]
+            frames.append(pack_rows(frame, frame_w, frame_h))
+    return frames
+
+
+def read_c_arrays(path, frame_w, frame_h):
+    """Extract every brace-enclosed hex byte array of the expected frame size from a C/C++ source."""
+    with open(path) as f:
+        source = f.read()
+    size = row_bytes(frame_w) * frame_h
+    frames = []
+    for body in re.findall(r"\{([^{}]*)\}", source):
+        values = re.findall(r"0x[0-9a-fA-F]{1,2}\b", body)
+        if len(values) == size:
+            frames.append(bytes(int(v, 16) for v in values))
+    return frames
+
+
+def rle(data):
+    """Run-length encode bytes: c < 0x80 -> c + 1 literals follow, c >= 0x80 -> next byte repeats (c & 0x7F) + 2."""
+    out = bytearray()
+    literal = bytearray()
+
+    def flush():
+        while literal:
+            chunk = literal[:128]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+            del literal[:128]
+
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 129 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            flush()
+            out.append(0x80 | (run - 2))
+            out.append(data[i])
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+    flush()
+    return bytes(out)
+
+
+def unrle(stream, pos, size):
+    """Decode one RLE stream of size bytes; returns (data, new position)."""
+    out = bytearray()
+    while len(out) < size:
+        control = stream[pos]
+        pos += 1
+        if control & 0x80:
+            out.extend(bytes([stream[pos]]) * ((control & 0x7F) + 2))
+            pos += 1
+        else:
+            out.extend(stream[pos:pos + control + 1])
+            pos += control + 1
+    return bytes(out), pos
+
+
+def encode(frames, width, height):
+    """Encode frames; returns (blob, per-frame encoded sizes)."""
+    blob = bytearray([MAGIC, VERSION, width & 0xFF, width >> 8, height & 0xFF, height >> 8,
+                      len(frames) & 0xFF, len(frames) >> 8])
+    sizes = []
+    previous = None
+    for frame in frames:
+        key = bytes([FRAME_KEY]) + rle(frame)
+        best = key
+        if previous is not None:
+            delta = bytes([FRAME_DELTA]) + rle(bytes(a ^ b for a, b in zip(previous, frame)))
+            if len(delta) < len(key):
+                best = delta
+        blob.extend(best)
+        sizes.append(len(best))
+        previous = frame
+    return bytes(blob), sizes
+
+
+def decode(blob):
+    """Reference decoder used to verify the output."""
+    width = blob[2] | blob[3] << 8
+    height = blob[4] | blob[5] << 8
+    count = blob[6] | blob[7] << 8
+    size = row_bytes(width) * height
+    pos = 8
+    frames = []
+    current = bytes(size)
+    for _ in range(count):
+        kind = blob[pos]
+        data, pos = unrle(blob, pos + 1, size)
+        current = data if kind == FRAME_KEY else bytes(a ^ b for a, b in zip(current, data))
+        frames.append(current)
+    return frames
+
+
+def collect_inputs(paths):
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            files.extend(os.path.join(path, name) for name in sorted(os.listdir(path))
+                         if not name.startswith("."))
+        else:
+            files.append(path)
+    return files
+
+
+def parse_size(text):
+    match = re.fullmatch(r"(\d+)x(\d+)", text or "")
+    if not match:
+        raise argparse.ArgumentTypeError("expected WIDTHxHEIGHT, e.g. 24x24")
+    return int(match.group(1)), int(match.group(2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("inputs", nargs="+", help="image files, folders of images, a sprite sheet or C sources")
+    parser.add_argument("--name", default="animation", help="C identifier of the generated array")
+    parser.add_argument("-o", "--output", help="output header (default: stdout)")
+    parser.add_argument("--frame-size", type=parse_size, help="frame size WxH for sprite sheets and --c-arrays")
+    parser.add_argument("--c-arrays", action="store_true", help="read 1-bpp byte arrays from C/C++ sources")
+    parser.add_argument("--threshold", type=int, default=128, help="gray level below which a pixel is set")
+    parser.add_argument("--invert", action="store_true", help="set light pixels instead of dark ones")
+    args = parser.parse_args()
+
+    files = collect_inputs(args.inputs)
+    frames = []
+    if args.c_arrays:
+        if not args.frame_size:
+            parser.error("--c-arrays requires --frame-size")
+        width, height = args.frame_size
+        for path in files:
+            frames.extend(read_c_arrays(path, width, height))
+    else:
+        width = height = None
+        for path in files:
+            w, h, pixels = read_image(path, args.threshold, args.invert)
+            if args.frame_size:
+                fw, fh = args.frame_size
+                frames.extend(split_sheet(w, h, pixels, fw, fh))
+                w, h = fw, fh
+            else:
+                frames.append(pack_rows(pixels, w, h))
+            if width is not None and (w, h) != (width, height):
+                sys.exit("%s: frame size %dx%d differs from %dx%d" % (path, w, h, width, height))
+            width, height = w, h
+    if not frames:
+        sys.exit("no frames found")
+    if len(frames) > 0xFFFF or width > 0xFFFF or height > 0xFFFF:
+        sys.exit("animation too large for the format")
+
+    blob, sizes = encode(frames, width, height)
+    if decode(blob) != frames:
+        sys.exit("internal error: round trip mismatch")
+
+    raw = len(frames) * row_bytes(width) * height
+    sys.stderr.write("%s: %d frames of %dx%d, raw %d bytes -> %d bytes (%.2f:1)\n"
+                     % (args.name, len(frames), width, height, raw, len(blob), raw / float(len(blob))))
+    sys.stderr.write("frame sizes: %s\n" % " ".join(str(s) for s in sizes))
+
+    lines = [
+        "// Generated by s3ui_anim.py: %d frames of %dx%d, %d bytes (raw frames: %d bytes)"
+        % (len(frames), width, height, len(blob), raw),
+        "#pragma once",
+        "#include <Arduino.h>",
+        "",
+        "#define %s_WIDTH %d" % (args.name.upper(), width),
+        "#define %s_HEIGHT %d" % (args.name.upper(), height),
+        "#define %s_FRAMES %d" % (args.name.upper(), len(frames)),
+        "",
+        "static const uint8_t %s[] PROGMEM = {" % args.name,
+    ]
+    for i in range(0, len(blob), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in blob[i:i + 16]) + ",")
+    lines.append("};")
+    text = "\n".join(lines) + "\n"
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,26 @@
 #include "s3ui.h"
+#include "s3uiFont.h"
+
+// FNV-1a parameters for screen fingerprints
+static const uint32_t kHashSeed = 2166136261UL;
+static const uint32_t kHashPrime = 16777619UL;
+
+// Default record prefixes per s3uiLogLevel, stored back to back
+static const char kLogPrefixes[] PROGMEM = "D \0\0W \0E ";
+static const uint8_t kLogPrefixOffsets[S3UI_LOG_LEVELS] = {0, 3, 4, 7};
+// Cached display-line count of a record that has not been formatted yet
+static const uint8_t kLogLinesUnknown = s3uiLogStore::kLinesUnknown;
+static const uint8_t kLogMaxLines = s3uiLogStore::kMaxLines;
+
+// Render instrumentation: S3UI_STAT(fillCalls++) updates the cumulative counters and S3UI_STAT_SCOPE() times a
+// screen call or update(); both compile to nothing unless S3UI_RENDER_STATS is defined
+#ifdef S3UI_RENDER_STATS
+#define S3UI_STAT(expr) ((void)(renderStats.total.expr))
+#define S3UI_STAT_SCOPE(screen) StatScope statScope(*this, screen)
+#else
+#define S3UI_STAT(expr) ((void)0)
+#define S3UI_STAT_SCOPE(screen) ((void)0)
+#endif
 
 /**
  * @file s3ui.cpp
@@ -7,172 +29,363 @@
 
 // Constructor
 s3ui::s3ui()
-    : gfx(nullptr), displayWidth(0), displayHeight(0), animationActive(false), animationFrames(nullptr),
-      currentFrame(0), totalFrames(0), frameDelay(0), lastFrameTime(0), bitmapWidth(0), bitmapHeight(0),
-      captionText(""), logActive(false), titleFont(nullptr), contentFont(nullptr), titleSize(1), contentSize(1),
-      titleFontHeight(0), contentFontHeight(0) {}
+    : gfx(nullptr),
+#ifndef S3UI_FIXED_WIDTH
+      displayWidth(0), displayHeight(0),
+#endif
+      animationActive(false), animationFrames(nullptr),
+      encodedAnimation(nullptr), encodedReadPos(nullptr), animationScratch(nullptr), currentFrame(0), totalFrames(0),
+      frameDelay(0), nextFrameTime(0), bitmapWidth(0), bitmapHeight(0),
+      activityBitmapX(0), activityBitmapY(0), activityClipBottom(0), logActive(false), logLayoutValid(false),
+      logDirty(false),
+      logMinLevel(S3UI_LOG_DEBUG), logTimestamps(true), logFollowTail(true), logAtTail(true), logTopLine(0),
+      logTopSequence(0), logSpillNext(0), logSpillBase(0), logSpillLost(0), logSpillBatch(8),
+      optionScreen(OPTION_NONE), optionCount(0), optionCursor(0), optionEditing(false),
+      optionOverflow(false), scrollDuration(0), scrollFrameMs(0), scrollActive(false), scrollFrom(0), scrollTo(0),
+      thumbFrom(0), thumbTo(0), scrollStart(0), nextScrollTime(0), rowClip(false), clipTop(0), clipBottom(0),
+      screenKind(SCREEN_NONE), contentHash(0), trackOverflow(false), contentOverflow(false), rowHashTop(0xFFFF),
+      confirmSelected(0), confirmButtons(0), statusFieldCount(0), barVisible(false), needsDisplay(false),
+      titleFont(nullptr), contentFont(nullptr), titleSize(1), contentSize(1), titleFontHeight(0),
+      contentFontHeight(0), titleMetrics(), contentMetrics() {
+  titleText[0] = '\0';
+  statusText[0][0] = '\0';
+  for (uint8_t i = 0; i < S3UI_LOG_LEVELS; i++)
+    logPrefix[i] = s3uiText::progmem(kLogPrefixes + kLogPrefixOffsets[i]);
+  resetDirtyRegion();
+#ifdef S3UI_RENDER_STATS
+  resetRenderStats();
+  logAllocsSeen = 0;
+  logAllocBytesSeen = 0;
+  statsTiming = false;
+#endif
+}
+
+s3ui::~s3ui() {
+  delete[] titleMetrics.advance;
+  delete[] contentMetrics.advance;
+}
 
-void s3ui::setDisplay(Adafruit_GFX *display, uint16_t width, uint16_t height) {
+bool s3ui::setDisplay(Adafruit_GFX *display, uint16_t width, uint16_t height) {
+#ifdef S3UI_FIXED_WIDTH
+  // A display of another size than the build was specialized for cannot be drawn on
+  gfx = (width == displayWidth && height == displayHeight) ? display : nullptr;
+#else
   gfx = display;
   displayWidth = width;
   displayHeight = height;
+#endif
+  if (framebuffer.attached())
+    framebuffer.attach(framebuffer.data(), displayWidth, displayHeight, framebuffer.bufferLayout());
+  logLayoutValid = false;
+  logDirty = true;
+  screenKind = SCREEN_NONE;
+  barVisible = false;
+  return gfx != nullptr;
+}
+
+void s3ui::setFramebuffer(uint8_t *buffer, s3uiBufferLayout layout) {
+  framebuffer.attach(buffer, displayWidth, displayHeight, layout);
+  screenKind = SCREEN_NONE;
+  barVisible = false;
+}
+
+// Double buffering: the new buffer already shows the current screen, so all retained state stays valid
+void s3ui::swapFramebuffer(uint8_t *buffer) {
+  if (framebuffer.attached() && buffer)
+    framebuffer.attach(buffer, displayWidth, displayHeight, framebuffer.bufferLayout());
 }
 
 // Font configuration methods
 void s3ui::setTitleFont(const GFXfont *font) {
   titleFont = font;
-  titleFontHeight = font->yAdvance;
+  buildMetrics(titleMetrics, font, titleSize);
+  applyFontSizes();
+  S3UI_STAT(allocations += (titleMetrics.advance != nullptr));
+  S3UI_STAT(allocatedBytes += titleMetrics.advance ? titleMetrics.last - titleMetrics.first + 1 : 0);
+  screenKind = SCREEN_NONE;
+  barVisible = false;
 }
 
 void s3ui::setContentFont(const GFXfont *font) {
   contentFont = font;
-  contentFontHeight = font->yAdvance;
+  buildMetrics(contentMetrics, font, contentSize);
+  applyFontSizes();
+  S3UI_STAT(allocations += (contentMetrics.advance != nullptr));
+  S3UI_STAT(allocatedBytes += contentMetrics.advance ? contentMetrics.last - contentMetrics.first + 1 : 0);
+  logLayoutValid = false;
+  logDirty = true;
+  screenKind = SCREEN_NONE;
+}
+
+void s3ui::setTitleSize(uint8_t size) {
+  titleSize = size ? size : 1;
+  measureGlyphs(titleMetrics, titleFont, titleSize);
+  applyFontSizes();
+  screenKind = SCREEN_NONE;
+  barVisible = false;
+}
+
+void s3ui::setContentSize(uint8_t size) {
+  contentSize = size ? size : 1;
+  measureGlyphs(contentMetrics, contentFont, contentSize);
+  applyFontSizes();
+  logLayoutValid = false;
+  logDirty = true;
+  screenKind = SCREEN_NONE;
 }
 
-void s3ui::setTitleSize(uint8_t size) { titleSize = size; }
+void s3ui::applyFontSizes() {
+  titleFontHeight = titleFont ? pgm_read_byte(&titleFont->yAdvance) * titleSize : 0;
+  contentFontHeight = contentFont ? pgm_read_byte(&contentFont->yAdvance) * contentSize : 0;
+  glyphCache.setFonts(titleFont, titleSize, contentFont, contentSize);
+}
 
-void s3ui::setContentSize(uint8_t size) { contentSize = size; }
+bool s3ui::setGlyphCache(uint16_t bytes) {
+  bool ok = glyphCache.configure(bytes);
+  S3UI_STAT(allocations += (bytes && ok));
+  S3UI_STAT(allocatedBytes += ok ? bytes : 0);
+  return ok;
+}
 
-void s3ui::showTitleAndBorder(const String &title, const String &batteryPercentage) {
+void s3ui::showTitleAndBorder(const s3uiText &title, const s3uiText &batteryPercentage) {
   if (!gfx)
     return;
 
-  // Title
-  gfx->setTextColor(1);
-  gfx->setTextWrap(false);
-  gfx->setFont(titleFont);
-  gfx->setCursor(titleFontHeight / 3, titleFontHeight - 1);
-  gfx->print(title);
-
-  // BatteryPercentage
-  int16_t batteryWidth = strWidth(batteryPercentage, titleFont, titleSize);
-  gfx->setCursor(displayWidth - batteryWidth - titleFontHeight / 3, titleFontHeight - 1);
-  gfx->print(batteryPercentage);
+  // Title, battery percentage and status fields
+  storeBarText(BAR_TITLE, title);
+  storeBarText(BAR_BATTERY, batteryPercentage);
+  drawStatusBar();
 
   // MenuBoxOutline
-  gfx->fillRect(0, titleFontHeight + titleMargin, displayWidth, displayHeight - (titleFontHeight + titleMargin), 1);
+  fillArea(0, titleFontHeight + titleMargin, displayWidth, displayHeight - (titleFontHeight + titleMargin), 1);
   // MenuBox
-  gfx->fillRect(contentBoxThickness, titleFontHeight + titleMargin + contentBoxThickness,
-                displayWidth - 2 * contentBoxThickness,
-                displayHeight - (titleFontHeight + titleMargin) - 2 * contentBoxThickness, 0);
+  fillArea(contentBoxThickness, titleFontHeight + titleMargin + contentBoxThickness,
+           displayWidth - 2 * contentBoxThickness,
+           displayHeight - (titleFontHeight + titleMargin) - 2 * contentBoxThickness, 0);
 }
 
-// OptionSelect: Display a list of selectable options
-void s3ui::showOptionSelect(const String *options, uint8_t numOptions, uint8_t cursorPos) {
-  if (!gfx)
-    return;
+bool s3ui::updateTitleBar(const s3uiText &title, const s3uiText &batteryPercentage) {
+  uint32_t changed = 0;
+  if (!barTextEquals(BAR_TITLE, title))
+    changed |= 1UL << BAR_TITLE;
+  if (!barTextEquals(BAR_BATTERY, batteryPercentage))
+    changed |= 1UL << BAR_BATTERY;
+  if (!changed)
+    return true;
+  // Content drawn above the border would be lost
+  if (!barVisible || contentOverflow || (optionScreen != OPTION_NONE && optionOverflow))
+    return false;
+  storeBarText(BAR_TITLE, title);
+  storeBarText(BAR_BATTERY, batteryPercentage);
+  repaintStatusBar(changed);
+  return true;
+}
 
-  // Content metrics
-  uint16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
-  uint16_t contentHeight = displayHeight - (titleFontHeight + titleMargin) - 2 * contentBoxThickness;
-  uint8_t optionHeight = contentFontHeight + 2 * optionPadding;
-  uint16_t sliderBoxHeight = contentHeight - 2 * sliderPadding;
+bool s3ui::barTextEquals(uint8_t element, const s3uiText &text) const {
+  s3uiText stored = barText(element);
+  uint16_t capacity = (element == BAR_TITLE ? S3UI_TITLE_TEXT_MAX : S3UI_STATUS_TEXT_MAX) - 1;
+  uint16_t length = text.length() < capacity ? text.length() : capacity;
+  if (stored.length() != length)
+    return false;
+  for (uint16_t i = 0; i < length; i++) {
+    if (stored[i] != text[i])
+      return false;
+  }
+  return true;
+}
 
-  // SliderBox
-  gfx->drawRect(displayWidth - contentBoxThickness - sliderWidth - sliderPadding, contentTop + sliderPadding,
-                sliderWidth, sliderBoxHeight, 1);
+void s3ui::storeBarText(uint8_t element, const s3uiText &text) {
+  char *buffer = (element == BAR_TITLE) ? titleText : statusText[element - BAR_BATTERY];
+  uint16_t capacity = (element == BAR_TITLE ? S3UI_TITLE_TEXT_MAX : S3UI_STATUS_TEXT_MAX) - 1;
+  uint16_t length = text.length() < capacity ? text.length() : capacity;
+  for (uint16_t i = 0; i < length; i++) {
+    buffer[i] = text[i];
+  }
+  buffer[length] = '\0';
+}
 
-  // Compute how many options to render (always +1 to show partial option as visual indicator)
-  uint8_t fullyVisibleCount = (optionHeight == 0) ? 1 : (contentHeight / optionHeight);
-  if (fullyVisibleCount == 0)
-    fullyVisibleCount = 1;
-  uint8_t visibleCount = (numOptions > fullyVisibleCount) ? (fullyVisibleCount + 1) : numOptions;
+void s3ui::setBarText(uint8_t element, const s3uiText &text) {
+  if (barTextEquals(element, text))
+    return;
+  storeBarText(element, text);
+  if (!gfx || !barVisible)
+    return;
+  repaintStatusBar(1UL << element);
+  // Content drawn over the title bar may have been erased; the next screen call renders everything again
+  if (contentOverflow || (optionScreen != OPTION_NONE && optionOverflow))
+    screenKind = SCREEN_NONE;
+}
 
-  // Slider height calculation
-  uint8_t sliderHeight;
-  if (numOptions <= fullyVisibleCount) {
-    // All options fit - slider is 100% of box height
-    sliderHeight = sliderBoxHeight;
-  } else {
-    // Not all options fit - slider height proportional to visible content
-    sliderHeight = (fullyVisibleCount * sliderBoxHeight) / numOptions;
-    // Minimum slider height is 4px
-    if (sliderHeight < 4)
-      sliderHeight = 4;
-  }
+void s3ui::setTitle(const s3uiText &title) { setBarText(BAR_TITLE, title); }
 
-  // Slider position calculation
-  uint16_t sliderPos;
-  if (numOptions <= 1) {
-    sliderPos = titleFontHeight + titleMargin + contentBoxThickness + sliderPadding;
-  } else {
-    // Position based on cursor, accounting for slider height
-    sliderPos =
-        contentTop + sliderPadding + (uint16_t)(cursorPos * (sliderBoxHeight - sliderHeight)) / (numOptions - 1);
-  }
+void s3ui::setBatteryText(const s3uiText &batteryPercentage) { setBarText(BAR_BATTERY, batteryPercentage); }
 
-  gfx->drawRect(displayWidth - contentBoxThickness - sliderWidth - sliderPadding + 1, sliderPos, 1, sliderHeight, 1);
+int8_t s3ui::addStatusField(uint8_t width) {
+  if (statusFieldCount >= S3UI_MAX_STATUS_FIELDS)
+    return -1;
+  uint8_t field = statusFieldCount++;
+  statusWidth[field] = width;
+  statusText[1 + field][0] = '\0';
+  barInkLeft[BAR_FIELDS + field] = 0;
+  barInkRight[BAR_FIELDS + field] = -1;
+  return field;
+}
 
-  // Options with windowed scrolling to avoid drawing off-screen
-  gfx->setFont(contentFont);
-  uint8_t topIndex = 0;
-  if (numOptions > fullyVisibleCount) {
-    // Try to center the selected item when possible
-    int16_t desiredTop = (int16_t)cursorPos - (int16_t)(fullyVisibleCount / 2);
+bool s3ui::setStatusField(uint8_t field, const s3uiText &text) {
+  if (field >= statusFieldCount)
+    return false;
+  setBarText(BAR_FIELDS + field, text);
+  return true;
+}
 
-    // Maximum topIndex allows us to render visibleCount rows with last one partial
-    // We need topIndex + fullyVisibleCount <= numOptions - 1 for last option to exist
-    // So: topIndex <= numOptions - fullyVisibleCount - 1
-    int16_t maxTop = (int16_t)numOptions - (int16_t)fullyVisibleCount - 1;
-    if (maxTop < 0)
-      maxTop = 0;
+void s3ui::clearStatusFields() {
+  statusFieldCount = 0;
+  if (gfx && barVisible)
+    repaintStatusBar(0);
+}
 
-    if (desiredTop < 0)
-      desiredTop = 0;
-    if (desiredTop > maxTop)
-      desiredTop = maxTop;
+void s3ui::layoutStatusBar(int16_t *x) {
+  // The battery text is right-aligned; status fields follow right to left, each right-aligned in its slot
+  int16_t margin = titleFontHeight / 3;
+  x[BAR_TITLE] = margin;
+  x[BAR_BATTERY] = displayWidth - strWidth(barText(BAR_BATTERY), titleFont, titleSize) - margin;
+  int16_t right = x[BAR_BATTERY] - margin;
+  for (uint8_t field = 0; field < statusFieldCount; field++) {
+    x[BAR_FIELDS + field] = right - strWidth(barText(BAR_FIELDS + field), titleFont, titleSize);
+    right -= statusWidth[field] + margin;
+  }
+}
 
-    topIndex = (uint8_t)desiredTop;
-    if (cursorPos == numOptions - 1) {
-      contentTop = contentTop - contentBoxThickness - (optionHeight - contentFontHeight) / 2 -
-                   optionPadding; // Adjust contentTop to show last option properly
+void s3ui::barInk(uint8_t element, int16_t x, int16_t &left, int16_t &right) {
+  // Same extent printText() marks dirty
+  left = x + titleMetrics.left;
+  right = x + strWidth(barText(element), titleFont, titleSize) + titleMetrics.right;
+}
+
+void s3ui::drawStatusBar() {
+  int16_t x[BAR_FIELDS + S3UI_MAX_STATUS_FIELDS];
+  layoutStatusBar(x);
+  for (uint8_t element = 0; element < BAR_FIELDS + statusFieldCount; element++) {
+    printText(FONT_TITLE, x[element], titleFontHeight - 1, barText(element), 1);
+    barInk(element, x[element], barInkLeft[element], barInkRight[element]);
+  }
+  barVisible = true;
+}
+
+void s3ui::repaintStatusBar(uint32_t changed) {
+  int16_t x[BAR_FIELDS + S3UI_MAX_STATUS_FIELDS];
+  int16_t left[BAR_FIELDS + S3UI_MAX_STATUS_FIELDS];
+  int16_t right[BAR_FIELDS + S3UI_MAX_STATUS_FIELDS];
+  layoutStatusBar(x);
+
+  // Elements that changed or moved, and removed status fields, are erased at their old and new place
+  uint8_t count = BAR_FIELDS + statusFieldCount;
+  uint32_t erase = 0;
+  for (uint8_t element = 0; element < BAR_FIELDS + S3UI_MAX_STATUS_FIELDS; element++) {
+    if (element < count) {
+      barInk(element, x[element], left[element], right[element]);
+    } else {
+      left[element] = 0;
+      right[element] = -1;
     }
+    if ((changed & (1UL << element)) || left[element] != barInkLeft[element] ||
+        right[element] != barInkRight[element])
+      erase |= 1UL << element;
   }
+  if (!erase)
+    return;
 
-  for (uint8_t row = 0; row < visibleCount; row++) {
-    uint8_t i = topIndex + row;
-    if (i >= numOptions)
-      break;
-    uint16_t optionPos = contentTop + optionHeight * row;
-    bool selected = (i == cursorPos);
-    if (selected) {
-      gfx->fillRect(contentBoxThickness + optionPadding, optionPos + optionPadding,
-                    displayWidth - 2 * contentBoxThickness - 2 * optionPadding - sliderWidth - sliderPadding,
-                    optionHeight, 1);
+  // Everything below the bar is covered by the border in a full repaint, so clearing the columns within the
+  // bar and replaying the (color 1) elements that reach into them reproduces it exactly
+  int16_t barHeight = titleFontHeight + titleMargin;
+  for (uint8_t element = 0; element < BAR_FIELDS + S3UI_MAX_STATUS_FIELDS; element++) {
+    if (!(erase & (1UL << element)))
+      continue;
+    if (barInkRight[element] >= barInkLeft[element])
+      fillArea(barInkLeft[element], 0, barInkRight[element] - barInkLeft[element] + 1, barHeight, 0);
+    if (right[element] >= left[element])
+      fillArea(left[element], 0, right[element] - left[element] + 1, barHeight, 0);
+  }
+  setRowClip(0, barHeight);
+  for (uint8_t element = 0; element < count; element++) {
+    for (uint8_t other = 0; other < BAR_FIELDS + S3UI_MAX_STATUS_FIELDS; other++) {
+      if (!(erase & (1UL << other)))
+        continue;
+      bool hitsOld = left[element] <= barInkRight[other] && right[element] >= barInkLeft[other];
+      bool hitsNew = left[element] <= right[other] && right[element] >= left[other];
+      if (hitsOld || hitsNew) {
+        printText(FONT_TITLE, x[element], titleFontHeight - 1, barText(element), 1);
+        break;
+      }
     }
-    gfx->setCursor(contentBoxThickness + 2 * optionPadding + (selected ? 4 : 0),
-                   optionPos + (optionHeight + contentFontHeight) / 2 - 1);
-    gfx->setTextColor(selected ? 0 : 1);
-    gfx->print(options[i]);
   }
+  clearRowClip();
+  memcpy(barInkLeft, left, sizeof(barInkLeft));
+  memcpy(barInkRight, right, sizeof(barInkRight));
 }
 
-// OptionSelect: Display a list of selectable options (screen wrapper)
-void s3ui::optionSelectScreen(const String &title, const String &batteryPercentage, const String *options,
-                              uint8_t numOptions, uint8_t cursorPos) {
-  gfx->fillScreen(0);
+uint32_t s3ui::hashText(uint32_t hash, const s3uiText &text) {
+  for (uint16_t i = 0; i < text.length(); i++) {
+    hash = (hash ^ (uint8_t)text[i]) * kHashPrime;
+  }
+  // The length keeps adjacent texts from running together ("ab" + "c" vs "a" + "bc")
+  return hashValue(hash, text.length());
+}
 
-  animationActive = false;
+uint32_t s3ui::hashValue(uint32_t hash, uint32_t value) {
+  for (uint8_t i = 0; i < 4; i++, value >>= 8) {
+    hash = (hash ^ (uint8_t)value) * kHashPrime;
+  }
+  return hash;
+}
+
+bool s3ui::beginScreen(ScreenKind kind, const s3uiText &title, const s3uiText &batteryPercentage, uint32_t content) {
+  if (!gfx)
+    return false;
+  if (screenKind == kind && updateTitleBar(title, batteryPercentage)) {
+    if (content == contentHash)
+      return false;
+    // Content drawn outside the content box cannot be erased in place
+    if (!contentOverflow) {
+      clearContent();
+      contentHash = content;
+      trackOverflow = true;
+      return true;
+    }
+  }
 
+  clearScreen();
   showTitleAndBorder(title, batteryPercentage);
-  showOptionSelect(options, numOptions, cursorPos);
+  screenKind = kind;
+  contentHash = content;
+  trackOverflow = true;
+  return true;
 }
 
-// OptionValueSet: Display options with editable values
-void s3ui::showOptionValueSet(const String *optionNames, const String *optionValues, uint8_t numOptions,
-                              uint8_t cursorPos, bool optionSelected) {
+// OptionSelect: Display a list of selectable options
+void s3ui::showOptionSelect(const s3uiTextList &options, uint16_t numOptions, uint16_t cursorPos) {
   if (!gfx)
     return;
 
+  // Remember the list so moveOptionCursor() can repaint it incrementally
+  optionScreen = OPTION_SELECT;
+  listNames = options;
+  listValues = s3uiTextList();
+  optionCount = numOptions;
+  optionCursor = cursorPos;
+  optionEditing = false;
+  drawOptionList(optionLayout(cursorPos));
+}
+
+s3ui::OptionLayout s3ui::optionLayout(uint16_t cursorPos) {
+  OptionLayout layout;
+
   // Content metrics
   uint16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
   uint16_t contentHeight = displayHeight - (titleFontHeight + titleMargin) - 2 * contentBoxThickness;
-  uint8_t optionHeight = contentFontHeight + 4 * optionPadding;
+  uint8_t optionHeight = contentFontHeight + (optionScreen == OPTION_VALUE_SET ? 4 : 2) * optionPadding;
   uint16_t sliderBoxHeight = contentHeight - 2 * sliderPadding;
-
-  // SliderBox
-  gfx->drawRect(displayWidth - contentBoxThickness - sliderWidth - sliderPadding, contentTop + sliderPadding,
-                sliderWidth, sliderBoxHeight, 1);
+  uint16_t numOptions = optionCount;
 
   // Compute how many options to render (always +1 to show partial option as visual indicator)
   uint8_t fullyVisibleCount = (optionHeight == 0) ? 1 : (contentHeight / optionHeight);
@@ -199,23 +412,28 @@ void s3ui::showOptionValueSet(const String *optionNames, const String *optionVal
     sliderPos = titleFontHeight + titleMargin + contentBoxThickness + sliderPadding;
   } else {
     // Position based on cursor, accounting for slider height
-    sliderPos =
-        contentTop + sliderPadding + (uint16_t)(cursorPos * (sliderBoxHeight - sliderHeight)) / (numOptions - 1);
+    int32_t travel = (int32_t)sliderBoxHeight - sliderHeight;
+    if (travel < 0)
+      travel = 0;
+    sliderPos = contentTop + sliderPadding + (uint32_t)cursorPos * travel / (numOptions - 1);
   }
 
-  gfx->drawRect(displayWidth - contentBoxThickness - sliderWidth - sliderPadding + 1, sliderPos, 1, sliderHeight, 1);
+  layout.sliderX = displayWidth - contentBoxThickness - sliderWidth - sliderPadding;
+  layout.sliderTop = contentTop + sliderPadding;
+  layout.sliderBoxHeight = sliderBoxHeight;
+  layout.thumbTop = sliderPos;
+  layout.thumbHeight = sliderHeight;
 
   // Options with windowed scrolling to avoid drawing off-screen
-  gfx->setFont(contentFont);
-  uint8_t topIndex = 0;
+  uint16_t topIndex = 0;
   if (numOptions > fullyVisibleCount) {
     // Try to center the selected item when possible
-    int16_t desiredTop = (int16_t)cursorPos - (int16_t)(fullyVisibleCount / 2);
+    int32_t desiredTop = (int32_t)cursorPos - (int32_t)(fullyVisibleCount / 2);
 
     // Maximum topIndex allows us to render visibleCount rows with last one partial
     // We need topIndex + fullyVisibleCount <= numOptions - 1 for last option to exist
     // So: topIndex <= numOptions - fullyVisibleCount - 1
-    int16_t maxTop = (int16_t)numOptions - (int16_t)fullyVisibleCount - 1;
+    int32_t maxTop = (int32_t)numOptions - (int32_t)fullyVisibleCount - 1;
     if (maxTop < 0)
       maxTop = 0;
 
@@ -224,71 +442,445 @@ void s3ui::showOptionValueSet(const String *optionNames, const String *optionVal
     if (desiredTop > maxTop)
       desiredTop = maxTop;
 
-    topIndex = (uint8_t)desiredTop;
+    topIndex = (uint16_t)desiredTop;
     if (cursorPos == numOptions - 1) {
       contentTop = contentTop - contentBoxThickness - (optionHeight - contentFontHeight) / 2 -
                    optionPadding; // Adjust contentTop to show last option properly
     }
   }
 
-  for (uint8_t row = 0; row < visibleCount; row++) {
-    uint8_t i = topIndex + row;
-    if (i >= numOptions)
-      break;
-    uint16_t optionPos = contentTop + optionHeight * row;
-    bool selected = (i == cursorPos);
+  layout.rowTop = contentTop;
+  layout.rowHeight = optionHeight;
+  layout.topIndex = topIndex;
+  layout.visibleCount = visibleCount;
+  return layout;
+}
+
+void s3ui::drawOptionList(const OptionLayout &layout) {
+  scrollActive = false;
+  optionOverflow = optionListOverflows(layout);
+  drawOptionSlider(layout);
+  for (uint8_t row = 0; row < layout.visibleCount; row++) {
+    drawOptionRow(layout, row);
+  }
+}
+
+void s3ui::drawOptionSlider(const OptionLayout &layout) {
+  drawSlider(layout.sliderX, layout.sliderTop, layout.sliderBoxHeight, layout.thumbTop, layout.thumbHeight);
+}
+
+void s3ui::drawSlider(int16_t x, int16_t top, uint16_t boxHeight, int16_t thumbTop, uint16_t thumbHeight) {
+  // SliderBox
+  outlineArea(x, top, sliderWidth, boxHeight, 1);
+  // Slider
+  outlineArea(x + 1, thumbTop, 1, thumbHeight, 1);
+}
+
+void s3ui::drawOptionRow(const OptionLayout &layout, uint8_t row) {
+  uint16_t i = layout.topIndex + row;
+  if (i >= optionCount)
+    return;
+  uint8_t optionHeight = layout.rowHeight;
+  int16_t optionPos = layout.rowTop + optionHeight * row;
+  bool selected = (i == optionCursor);
+  int16_t rowWidth = displayWidth - 2 * contentBoxThickness - 2 * optionPadding - sliderWidth - sliderPadding;
+  int16_t baselineY = optionPos + (optionHeight + contentFontHeight) / 2 - 1;
+
+  if (optionScreen == OPTION_SELECT) {
     if (selected) {
-      if (optionSelected) {
-        // Highlight value area
-        gfx->fillRect(contentBoxThickness + optionPadding, optionPos + optionPadding,
-                      displayWidth - 2 * contentBoxThickness - 2 * optionPadding - sliderWidth - sliderPadding,
-                      optionHeight, 1);
-      } else {
-        // Highlight entire option
-        gfx->drawRect(contentBoxThickness + optionPadding, optionPos + optionPadding,
-                      displayWidth - 2 * contentBoxThickness - 2 * optionPadding - sliderWidth - sliderPadding,
-                      optionHeight, 1);
-      }
+      fillArea(contentBoxThickness + optionPadding, optionPos + optionPadding, rowWidth, optionHeight, 1);
+    }
+    printText(FONT_CONTENT, contentBoxThickness + 2 * optionPadding + (selected ? 4 : 0), baselineY,
+              listItem(listNames, i, 0), selected ? 0 : 1);
+    return;
+  }
+
+  bool editing = selected && optionEditing;
+  if (selected) {
+    if (optionEditing) {
+      // Highlight value area
+      fillArea(contentBoxThickness + optionPadding, optionPos + optionPadding, rowWidth, optionHeight, 1);
+    } else {
+      // Highlight entire option
+      outlineArea(contentBoxThickness + optionPadding, optionPos + optionPadding, rowWidth, optionHeight, 1);
     }
-    gfx->setCursor(contentBoxThickness + 2 * optionPadding + (selected ? 4 : 0),
-                   optionPos + (optionHeight + contentFontHeight) / 2 - 1);
-    gfx->setTextColor((selected && optionSelected) ? 0 : 1);
-    gfx->print(optionNames[i]);
-
-    // Draw increment/decrement icons if selected and editing
-    if (selected && optionSelected) {
-      String spacing = "  ";
-      String value = "<" + spacing + optionValues[i] + spacing + ">";
-      int16_t valueX = displayWidth - contentBoxThickness - sliderWidth - sliderPadding - optionPadding -
-                       strWidth(value, contentFont, contentSize);
-      gfx->setCursor(valueX, optionPos + (optionHeight + contentFontHeight) / 2 - 1);
-      gfx->setTextColor(0);
-      gfx->print(value);
+  }
+  printText(FONT_CONTENT, contentBoxThickness + 2 * optionPadding + (selected ? 4 : 0), baselineY,
+            listItem(listNames, i, 0), editing ? 0 : 1);
+
+  // Draw increment/decrement icons if selected and editing
+  if (editing) {
+    // "<  value  >" is printed as three consecutive runs instead of building a String
+    s3uiText value = listItem(listValues, i, 1);
+    int16_t valueWidth = strWidth("<  ", contentFont, contentSize) + strWidth(value, contentFont, contentSize) +
+                         strWidth("  >", contentFont, contentSize);
+    int16_t valueX = displayWidth - contentBoxThickness - sliderWidth - sliderPadding - optionPadding - valueWidth;
+    valueX = printText(FONT_CONTENT, valueX, baselineY, "<  ", 0);
+    valueX = printText(FONT_CONTENT, valueX, baselineY, value, 0);
+    printText(FONT_CONTENT, valueX, baselineY, "  >", 0);
+  } else {
+    // Draw value right-aligned when not editing
+    s3uiText value = listItem(listValues, i, 1);
+    int16_t valueX = displayWidth - contentBoxThickness - sliderWidth - sliderPadding - optionPadding -
+                     strWidth(value, contentFont, contentSize);
+    printText(FONT_CONTENT, valueX, baselineY, value, 1);
+  }
+}
+
+void s3ui::optionRowExtent(const OptionLayout &layout, uint8_t row, int16_t &top, int16_t &bottom) {
+  // Union of the highlight box (which reaches optionPadding into the next row) and the glyph boxes
+  int16_t optionPos = layout.rowTop + layout.rowHeight * row;
+  int16_t baselineY = optionPos + (layout.rowHeight + contentFontHeight) / 2 - 1;
+  top = optionPos + optionPadding;
+  bottom = optionPos + optionPadding + layout.rowHeight - 1;
+  if (baselineY + contentMetrics.top < top)
+    top = baselineY + contentMetrics.top;
+  if (baselineY + contentMetrics.bottom > bottom)
+    bottom = baselineY + contentMetrics.bottom;
+}
+
+bool s3ui::optionRowInside(const OptionLayout &layout, uint8_t row) {
+  uint16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
+  uint16_t contentHeight = displayHeight - (titleFontHeight + titleMargin) - 2 * contentBoxThickness;
+  int16_t top;
+  int16_t bottom;
+  optionRowExtent(layout, row, top, bottom);
+  return top >= (int16_t)contentTop && bottom < (int16_t)(contentTop + contentHeight);
+}
+
+bool s3ui::moveOptionCursor(uint16_t cursorPos) {
+  if (!gfx || optionScreen == OPTION_NONE || cursorPos >= optionCount)
+    return false;
+  if (cursorPos == optionCursor)
+    return true;
+
+  OptionLayout before = optionLayout(optionCursor);
+  OptionLayout after = optionLayout(cursorPos);
+  uint8_t previousRow = optionCursor - before.topIndex;
+  uint8_t currentRow = cursorPos - after.topIndex;
+
+  // Smooth scrolling: tween from wherever the list is now to the new window; frames are drawn by update()
+  bool windowMoved = after.topIndex != before.topIndex || after.rowTop != before.rowTop;
+  if (scrollDuration && (scrollActive || windowMoved)) {
+    if (optionOverflow)
+      return false;
+    unsigned long now = millis();
+    if (scrollActive) {
+      scrollPosition(now, scrollFrom, thumbFrom);
     } else {
-      // Draw value right-aligned when not editing
-      int16_t valueX = displayWidth - contentBoxThickness - sliderWidth - sliderPadding - optionPadding -
-                       strWidth(optionValues[i], contentFont, contentSize);
-      gfx->setCursor(valueX, optionPos + (optionHeight + contentFontHeight) / 2 - 1);
-      gfx->setTextColor((selected && optionSelected) ? 0 : 1);
-      gfx->print(optionValues[i]);
+      scrollFrom = optionListOffset(before);
+      thumbFrom = before.thumbTop;
+    }
+    optionCursor = cursorPos;
+    scrollTo = optionListOffset(after);
+    thumbTo = after.thumbTop;
+    scrollStart = now;
+    nextScrollTime = now + scrollFrameMs;
+    drawScrolledList(scrollFrom, thumbFrom);
+    scrollActive = true;
+    return true;
+  }
+
+  // Selected rows clear pixels and must stay inside the content box to be repainted in place
+  if (!optionRowInside(before, previousRow) || !optionRowInside(after, currentRow))
+    return false;
+
+  uint16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
+  uint16_t contentHeight = displayHeight - (titleFontHeight + titleMargin) - 2 * contentBoxThickness;
+  if (windowMoved) {
+    // The window scrolled. A row above the content box (the window shifts up when the last option is selected)
+    // has drawn over the border or title bar, which only a full screen repaint restores.
+    int16_t top;
+    int16_t bottom;
+    optionRowExtent(before, 0, top, bottom);
+    if (top < (int16_t)contentTop)
+      return false;
+    // Otherwise repaint the whole list; title bar and border stay
+    optionCursor = cursorPos;
+    fillArea(contentBoxThickness, contentTop, displayWidth - 2 * contentBoxThickness, contentHeight, 0);
+    drawOptionList(after);
+    return true;
+  }
+  optionCursor = cursorPos;
+
+  // Slider thumb: clear the old one, restore the box edges it may have covered, draw the new one
+  fillArea(before.sliderX + 1, before.thumbTop, 1, before.thumbHeight, 0);
+  drawOptionSlider(after);
+
+  repaintOptionRows(after, rowBit(previousRow) | rowBit(currentRow));
+  optionOverflow = optionListOverflows(after);
+  return true;
+}
+
+void s3ui::repaintOptionRows(const OptionLayout &layout, uint32_t rows) {
+  int16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
+  int16_t contentBottom = displayHeight - contentBoxThickness - 1;
+
+  // Clear the bands of the rows that changed (inside the content box, left of the slider), then replay every
+  // row that reaches into one in list order so overlapping rows compose exactly as in a full repaint
+  for (uint8_t row = 0; row < layout.visibleCount; row++) {
+    if (!(rows & rowBit(row)))
+      continue;
+    int16_t top;
+    int16_t bottom;
+    optionRowExtent(layout, row, top, bottom);
+    if (top < contentTop)
+      top = contentTop;
+    if (bottom > contentBottom)
+      bottom = contentBottom;
+    fillArea(contentBoxThickness, top, layout.sliderX - contentBoxThickness, bottom - top + 1, 0);
+  }
+  for (uint8_t row = 0; row < layout.visibleCount; row++) {
+    int16_t top;
+    int16_t bottom;
+    optionRowExtent(layout, row, top, bottom);
+    for (uint8_t band = 0; band < layout.visibleCount; band++) {
+      int16_t bandTop;
+      int16_t bandBottom;
+      if (!(rows & rowBit(band)))
+        continue;
+      optionRowExtent(layout, band, bandTop, bandBottom);
+      if (top <= bandBottom && bottom >= bandTop) {
+        drawOptionRow(layout, row);
+        break;
+      }
     }
   }
 }
 
+void s3ui::optionRowHashes(const OptionLayout &layout, uint32_t *hashes) {
+  for (uint8_t slot = 0; slot < S3UI_MAX_TRACKED_ROWS; slot++) {
+    hashes[slot] = kHashSeed;
+  }
+  for (uint8_t row = 0; row < layout.visibleCount; row++) {
+    uint16_t i = layout.topIndex + row;
+    if (i >= optionCount)
+      break;
+    uint32_t &hash = hashes[row < S3UI_MAX_TRACKED_ROWS ? row : S3UI_MAX_TRACKED_ROWS - 1];
+    hash = hashText(hash, listItem(listNames, i, 0));
+    if (optionScreen == OPTION_VALUE_SET)
+      hash = hashText(hash, listItem(listValues, i, 1));
+  }
+}
+
+bool s3ui::updateOptionList(const s3uiTextList &names, const s3uiTextList &values, uint16_t numOptions,
+                            uint16_t cursorPos, bool editing) {
+  if (optionScreen == OPTION_NONE || cursorPos >= numOptions)
+    return false;
+  listNames = names;
+  listValues = values;
+
+  // A different length changes the row window and slider throughout: repaint the list
+  if (numOptions != optionCount) {
+    if (optionOverflow)
+      return false;
+    optionCount = numOptions;
+    optionCursor = cursorPos;
+    optionEditing = editing;
+    OptionLayout layout = optionLayout(cursorPos);
+    clearContent();
+    drawOptionList(layout);
+    rowHashTop = layout.topIndex;
+    optionRowHashes(layout, rowHash);
+    return true;
+  }
+
+  OptionLayout before = optionLayout(optionCursor);
+  OptionLayout after = optionLayout(cursorPos);
+  uint32_t hashes[S3UI_MAX_TRACKED_ROWS];
+  optionRowHashes(after, hashes);
+
+  // When the window scrolls (or a scroll is running) every row is drawn again from the new lists anyway. Smooth
+  // scrolls are clipped to the content box, so they cannot end on a window that reaches above it.
+  int16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
+  bool windowMoved = after.topIndex != before.topIndex || after.rowTop != before.rowTop;
+  if (windowMoved || scrollActive) {
+    int16_t top;
+    int16_t bottom;
+    optionRowExtent(after, 0, top, bottom);
+    if (scrollDuration && top < contentTop)
+      return false;
+    optionEditing = editing;
+    if (!moveOptionCursor(cursorPos))
+      return false;
+    rowHashTop = after.topIndex;
+    memcpy(rowHash, hashes, sizeof(rowHash));
+    return true;
+  }
+
+  // Same window: repaint rows whose text changed (all of them if other rows were fingerprinted) and the rows
+  // whose selection or edit state changed
+  uint8_t previousRow = optionCursor - after.topIndex;
+  uint8_t currentRow = cursorPos - after.topIndex;
+  uint32_t rows = 0;
+  for (uint8_t row = 0; row < after.visibleCount; row++) {
+    uint8_t slot = row < S3UI_MAX_TRACKED_ROWS ? row : S3UI_MAX_TRACKED_ROWS - 1;
+    if (rowHashTop != after.topIndex || hashes[slot] != rowHash[slot])
+      rows |= rowBit(row);
+  }
+  if (cursorPos != optionCursor || editing != optionEditing)
+    rows |= rowBit(previousRow) | rowBit(currentRow);
+  if (!rows)
+    return true;
+
+  // Rows reaching above the content box drew over the border, and selected rows clear pixels: neither can be
+  // repainted in place
+  for (uint8_t row = 0; row < after.visibleCount; row++) {
+    int16_t top;
+    int16_t bottom;
+    if (!(rows & rowBit(row)))
+      continue;
+    optionRowExtent(after, row, top, bottom);
+    if (top < contentTop)
+      return false;
+  }
+  if (!optionRowInside(after, previousRow) || !optionRowInside(after, currentRow))
+    return false;
+
+  if (before.thumbTop != after.thumbTop) {
+    fillArea(before.sliderX + 1, before.thumbTop, 1, before.thumbHeight, 0);
+    drawOptionSlider(after);
+  }
+  optionCursor = cursorPos;
+  optionEditing = editing;
+  repaintOptionRows(after, rows);
+  optionOverflow = optionListOverflows(after);
+  rowHashTop = after.topIndex;
+  memcpy(rowHash, hashes, sizeof(rowHash));
+  return true;
+}
+
+void s3ui::retainOptionScreen(ScreenKind kind) {
+  if (optionScreen == OPTION_NONE)
+    return;
+  screenKind = kind;
+  OptionLayout layout = optionLayout(optionCursor);
+  rowHashTop = layout.topIndex;
+  optionRowHashes(layout, rowHash);
+}
+
+bool s3ui::optionListOverflows(const OptionLayout &layout) {
+  uint16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
+  int16_t top;
+  int16_t bottom;
+  optionRowExtent(layout, 0, top, bottom);
+  if (top < (int16_t)contentTop)
+    return true;
+  // The selected row clears pixels, so it must not reach the border either
+  if (optionCursor >= layout.topIndex && optionCursor - layout.topIndex < layout.visibleCount)
+    return !optionRowInside(layout, optionCursor - layout.topIndex);
+  return false;
+}
+
+int32_t s3ui::optionListOffset(const OptionLayout &layout) {
+  int16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
+  return (int32_t)layout.topIndex * layout.rowHeight + contentTop - layout.rowTop;
+}
+
+void s3ui::setSmoothScroll(uint16_t durationMs, uint8_t fps) {
+  scrollDuration = durationMs;
+  scrollFrameMs = fps ? 1000 / fps : 0;
+}
+
+void s3ui::scrollPosition(unsigned long now, int32_t &offset, int16_t &thumbTop) {
+  uint32_t elapsed = now - scrollStart;
+  if (elapsed >= scrollDuration) {
+    offset = scrollTo;
+    thumbTop = thumbTo;
+    return;
+  }
+  // Ease out: the distance still to go shrinks with the square of the remaining time (in 1/256 units)
+  uint32_t remaining = ((uint32_t)(scrollDuration - elapsed) << 8) / scrollDuration;
+  int32_t left = (remaining * remaining) >> 8;
+  offset = scrollTo - (scrollTo - scrollFrom) * left / 256;
+  thumbTop = thumbTo - (int32_t)(thumbTo - thumbFrom) * left / 256;
+}
+
+void s3ui::drawScrolledList(int32_t offset, int16_t thumbTop) {
+  uint16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
+  uint16_t contentHeight = displayHeight - (titleFontHeight + titleMargin) - 2 * contentBoxThickness;
+  OptionLayout layout = optionLayout(optionCursor);
+  if (layout.rowHeight == 0)
+    return;
+
+  // Clear the list area and the thumb column inside the slider box, then redraw box and thumb
+  fillArea(contentBoxThickness, contentTop, layout.sliderX - contentBoxThickness, contentHeight, 0);
+  fillArea(layout.sliderX + 1, layout.sliderTop, 1, layout.sliderBoxHeight, 0);
+  layout.thumbTop = thumbTop;
+  drawOptionSlider(layout);
+
+  // Rows from the one above the window (its highlight and glyphs can reach into it) to the first one below
+  int32_t first = offset / layout.rowHeight;
+  layout.topIndex = (first > 0) ? first - 1 : 0;
+  layout.rowTop = contentTop - (int16_t)(offset - (int32_t)layout.topIndex * layout.rowHeight);
+  layout.visibleCount = (contentTop + contentHeight - layout.rowTop) / layout.rowHeight + 2;
+  setRowClip(contentTop, contentTop + contentHeight);
+  for (uint8_t row = 0; row < layout.visibleCount; row++) {
+    drawOptionRow(layout, row);
+  }
+  clearRowClip();
+  optionOverflow = false;
+}
+
+// OptionSelect: Display a list of selectable options (screen wrapper)
+void s3ui::optionSelectScreen(const s3uiText &title, const s3uiText &batteryPercentage, const s3uiTextList &options,
+                              uint16_t numOptions, uint16_t cursorPos) {
+  S3UI_STAT_SCOPE(S3UI_STAT_OPTION_SELECT);
+  if (!gfx)
+    return;
+  if (screenKind == SCREEN_OPTION_SELECT && updateTitleBar(title, batteryPercentage) &&
+      updateOptionList(options, s3uiTextList(), numOptions, cursorPos, false))
+    return;
+
+  clearScreen();
+
+  animationActive = false;
+  logActive = false;
+
+  showTitleAndBorder(title, batteryPercentage);
+  showOptionSelect(options, numOptions, cursorPos);
+  retainOptionScreen(SCREEN_OPTION_SELECT);
+}
+
+// OptionValueSet: Display options with editable values
+void s3ui::showOptionValueSet(const s3uiTextList &optionNames, const s3uiTextList &optionValues, uint16_t numOptions,
+                              uint16_t cursorPos, bool optionSelected) {
+  if (!gfx)
+    return;
+
+  // Remember the list so moveOptionCursor() can repaint it incrementally
+  optionScreen = OPTION_VALUE_SET;
+  listNames = optionNames;
+  listValues = optionValues;
+  optionCount = numOptions;
+  optionCursor = cursorPos;
+  optionEditing = optionSelected;
+  drawOptionList(optionLayout(cursorPos));
+}
+
 // OptionValueSet: Display a list of options with editable values (screen wrapper)
-void s3ui::optionValueSetScreen(const String &title, const String &batteryPercentage, const String *optionNames,
-                                const String *optionValues, uint8_t numOptions, uint8_t cursorPos,
-                                bool optionSelected) {
-  gfx->fillScreen(0);
+void s3ui::optionValueSetScreen(const s3uiText &title, const s3uiText &batteryPercentage,
+                                const s3uiTextList &optionNames, const s3uiTextList &optionValues, uint16_t numOptions,
+                                uint16_t cursorPos, bool optionSelected) {
+  S3UI_STAT_SCOPE(S3UI_STAT_OPTION_VALUE_SET);
+  if (!gfx)
+    return;
+  if (screenKind == SCREEN_OPTION_VALUE_SET && updateTitleBar(title, batteryPercentage) &&
+      updateOptionList(optionNames, optionValues, numOptions, cursorPos, optionSelected))
+    return;
+
+  clearScreen();
 
   animationActive = false;
+  logActive = false;
 
   showTitleAndBorder(title, batteryPercentage);
   showOptionValueSet(optionNames, optionValues, numOptions, cursorPos, optionSelected);
+  retainOptionScreen(SCREEN_OPTION_VALUE_SET);
 }
 
 // RunningActivity: Display with static bitmap
-void s3ui::showRunningActivity(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const String &caption) {
+void s3ui::showRunningActivity(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const s3uiText &caption) {
   // center bitmap on contentBox considering that there has to be space for a caption
   if (!gfx)
     return;
@@ -300,44 +892,22 @@ void s3ui::showRunningActivity(const uint8_t *bitmap, uint16_t bitmapW, uint16_t
   uint16_t contentWidth = displayWidth - 2 * contentBoxThickness;
 
   // Prepare caption: auto-wrap and interpret \n and \r like live log
-  String capText = caption;
-  bool hasCaption = capText.length() > 0 && contentFont;
+  bool hasCaption = caption.length() > 0 && contentFont;
   uint16_t availWidth = contentWidth - 2 * optionPadding;
   uint16_t lineHeight = contentFontHeight + contentFontHeight * 0.2; // match live log spacing
 
-  // Compute wrapped caption lines
-  std::vector<String> captionLines;
+  // Count wrapped caption lines for the vertical layout
+  uint16_t captionLineCount = 0;
+  TextSpan line;
   if (hasCaption) {
-    int16_t segmentStart = 0;
-    for (int16_t pos = 0; pos <= (int16_t)capText.length(); pos++) {
-      bool isNewline = (pos < (int16_t)capText.length()) && (capText[pos] == '\n' || capText[pos] == '\r');
-      bool isEnd = (pos == (int16_t)capText.length());
-
-      if (isNewline || isEnd) {
-        String segment = capText.substring(segmentStart, pos);
-        if (segment.length() > 0) {
-          int16_t segmentWidth = strWidth(segment, contentFont, contentSize);
-          if (segmentWidth <= availWidth) {
-            captionLines.push_back(segment);
-          } else {
-            // Wrap segment into chunks
-            uint16_t chunkStart = 0;
-            while (chunkStart < segment.length()) {
-              uint16_t chunkLen = findWrapPoint(segment, chunkStart, availWidth);
-              if (chunkLen == 0)
-                chunkLen = 1;
-              captionLines.push_back(segment.substring(chunkStart, chunkStart + chunkLen));
-              chunkStart += chunkLen;
-            }
-          }
-        }
-        segmentStart = pos + 1;
-      }
+    uint16_t pos = 0;
+    while (nextWrappedLine(caption, pos, availWidth, WrapBreakLF | WrapBreakCR, line)) {
+      captionLineCount++;
     }
   }
 
   // Compute group vertical layout (bitmap + caption below)
-  uint16_t captionTotalHeight = hasCaption ? (uint16_t)captionLines.size() * lineHeight : 0;
+  uint16_t captionTotalHeight = captionLineCount * lineHeight;
   uint16_t groupHeight = bitmapH + captionTotalHeight;
   int16_t groupTop = (int16_t)contentTop;
   if (groupHeight <= contentHeight) {
@@ -350,77 +920,139 @@ void s3ui::showRunningActivity(const uint8_t *bitmap, uint16_t bitmapW, uint16_t
   int16_t bmpY = groupTop;
 
   // Draw bitmap
-  gfx->drawBitmap(bmpX, bmpY, bitmap, bitmapW, bitmapH, 1);
+  if (bitmap)
+    blitBitmap(bmpX, bmpY, bitmap, bitmapW, bitmapH);
 
-  // Draw wrapped caption lines below the bitmap
-  if (hasCaption && !captionLines.empty()) {
-    gfx->setFont(contentFont);
-    gfx->setTextColor(1);
-    gfx->setTextWrap(false);
+  // Remember the placement so animation ticks can repaint the bitmap alone
+  activityBitmapX = bmpX;
+  activityBitmapY = bmpY;
+  activityClipBottom = (int16_t)contentTop + (int16_t)contentHeight;
 
+  // Draw wrapped caption lines below the bitmap
+  if (captionLineCount > 0) {
     int16_t drawY = bmpY + (int16_t)bitmapH;
     int16_t maxBaseline = (int16_t)contentTop + (int16_t)contentHeight - 1;
-    for (size_t i = 0; i < captionLines.size(); i++) {
-      const String &line = captionLines[i];
-      int16_t lineW = strWidth(line, contentFont, contentSize);
-      int16_t lineX = (int16_t)contentLeft + ((int16_t)contentWidth - lineW) / 2;
+    uint16_t pos = 0;
+    while (nextWrappedLine(caption, pos, availWidth, WrapBreakLF | WrapBreakCR, line)) {
+      int16_t lineX = (int16_t)contentLeft + ((int16_t)contentWidth - line.width) / 2;
       int16_t baselineY = drawY + (int16_t)contentFontHeight - 1;
       if (baselineY > maxBaseline)
         break;
-      gfx->setCursor(lineX, baselineY);
-      gfx->print(line);
+      if (baselineY + contentMetrics.top < activityClipBottom)
+        activityClipBottom = baselineY + contentMetrics.top; // frames must not erase caption ink
+      printText(FONT_CONTENT, lineX, baselineY, caption.slice(line.offset, line.length), 1);
       drawY += lineHeight;
     }
   }
 }
 
 // RunningActivity: Display with static bitmap (screen wrapper)
-void s3ui::runningActivityScreen(const String &title, const String &batteryPercentage, const uint8_t *bitmap,
-                                 uint16_t bitmapW, uint16_t bitmapH, const String &caption) {
-  gfx->fillScreen(0);
+void s3ui::runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *bitmap,
+                                 uint16_t bitmapW, uint16_t bitmapH, const s3uiText &caption) {
+  S3UI_STAT_SCOPE(S3UI_STAT_ACTIVITY);
+  uint32_t content = hashValue(hashValue(hashValue(kHashSeed, (uintptr_t)bitmap), bitmapW), bitmapH);
+  if (!beginScreen(SCREEN_ACTIVITY, title, batteryPercentage, hashText(content, caption)))
+    return;
 
   animationActive = false;
+  logActive = false;
 
-  showTitleAndBorder(title, batteryPercentage);
   showRunningActivity(bitmap, bitmapW, bitmapH, caption);
+  endContent();
 }
 
 // RunningActivity: Display with animated bitmap (screen wrapper)
-void s3ui::runningActivityScreen(const String &title, const String &batteryPercentage, const uint8_t **bitmaps,
+void s3ui::runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t **bitmaps,
                                  uint8_t numFrames, uint16_t bitmapW, uint16_t bitmapH, uint16_t msPerFrame,
-                                 const String &caption) {
-  gfx->fillScreen(0);
+                                 const s3uiText &caption) {
+  S3UI_STAT_SCOPE(S3UI_STAT_ACTIVITY);
+  // Same frames, timing and caption: the running animation stays as it is
+  uint32_t content = hashValue(hashValue(kHashSeed, (uintptr_t)bitmaps), numFrames);
+  content = hashValue(hashValue(hashValue(content, bitmapW), bitmapH), msPerFrame);
+  if (!beginScreen(SCREEN_ANIMATION, title, batteryPercentage, hashText(content, caption)))
+    return;
+
+  animationActive = false;
+  logActive = false;
+
+  // Without frames there is nothing to animate: show the caption alone
+  if (!bitmaps || numFrames == 0) {
+    showRunningActivity(nullptr, 0, 0, caption);
+    endContent();
+    return;
+  }
 
   // Setup animation state
   animationActive = true;
   animationFrames = bitmaps;
+  encodedAnimation = nullptr;
   totalFrames = numFrames;
   currentFrame = 0;
   frameDelay = msPerFrame;
-  lastFrameTime = millis();
+  nextFrameTime = millis() + msPerFrame;
   bitmapWidth = bitmapW;
   bitmapHeight = bitmapH;
-  captionText = caption;
 
-  showTitleAndBorder(title, batteryPercentage);
-  showRunningActivity(animationFrames[currentFrame], bitmapW, bitmapH, captionText);
+  // The caption is laid out and drawn once here; update() only repaints the bitmap
+  showRunningActivity(animationFrames[currentFrame], bitmapW, bitmapH, caption);
+  endContent();
+}
+
+// RunningActivity: Display a compressed animation (screen wrapper)
+void s3ui::runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *animation,
+                                 uint8_t *frameBuffer, uint16_t msPerFrame, const s3uiText &caption) {
+  S3UI_STAT_SCOPE(S3UI_STAT_ACTIVITY);
+  uint32_t content = hashValue(hashValue(kHashSeed, (uintptr_t)animation), (uintptr_t)frameBuffer);
+  if (!beginScreen(SCREEN_ANIMATION, title, batteryPercentage, hashText(hashValue(content, msPerFrame), caption)))
+    return;
+
+  animationActive = false;
+  logActive = false;
+
+  s3uiAnimationHeader header;
+  if (!frameBuffer || !s3uiReadAnimationHeader(animation, header)) {
+    showRunningActivity(nullptr, 0, 0, caption);
+    endContent();
+    return;
+  }
+
+  animationActive = true;
+  animationFrames = nullptr;
+  encodedAnimation = animation;
+  animationScratch = frameBuffer;
+  totalFrames = header.frames;
+  currentFrame = 0;
+  frameDelay = msPerFrame;
+  nextFrameTime = millis() + msPerFrame;
+  bitmapWidth = header.width;
+  bitmapHeight = header.height;
+
+  // Lay out the bitmap area and draw the caption, then paint frame 0 over the blank area
+  showRunningActivity(nullptr, bitmapWidth, bitmapHeight, caption);
+  memset(animationScratch, 0, S3UI_ANIMATION_FRAME_BYTES(bitmapWidth, bitmapHeight));
+  decodeNextFrame();
+  endContent();
 }
 
 // ActivityLiveLog: Display scrolling log (screen wrapper)
-void s3ui::activityLiveLogScreen(const String &title, const String &batteryPercentage) {
-  gfx->fillScreen(0);
+void s3ui::activityLiveLogScreen(const s3uiText &title, const s3uiText &batteryPercentage) {
+  S3UI_STAT_SCOPE(S3UI_STAT_LOG);
+  // The log content is kept up to date by update()
+  if (!beginScreen(SCREEN_LOG, title, batteryPercentage, kHashSeed))
+    return;
 
   logActive = true;
   animationActive = false;
 
-  showTitleAndBorder(title, batteryPercentage);
   showActivityLiveLog();
+  endContent();
 }
 
 // ActivityLiveLog: Display scrolling log
 void s3ui::showActivityLiveLog() {
   if (!gfx || !contentFont)
     return;
+  logDirty = false;
 
   // Content box metrics
   uint16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
@@ -432,138 +1064,189 @@ void s3ui::showActivityLiveLog() {
   uint16_t labelHeight = contentFontHeight;
   uint16_t labelY = contentTop;
 
-  // Log sub-window position and size
+  // Log sub-window position and size, with the position slider on its right
   uint16_t logWindowTop = contentTop + labelHeight + optionPadding;
   uint16_t logWindowHeight = contentHeight - labelHeight - 2 * optionPadding;
   uint16_t logWindowLeft = contentLeft + optionPadding;
-  uint16_t logWindowWidth = contentWidth - 2 * optionPadding;
+  uint16_t logWindowWidth = contentWidth - 2 * optionPadding - sliderWidth - sliderPadding;
 
   // Draw "Log:" label
-  gfx->setFont(contentFont);
-  gfx->setTextColor(1);
-  gfx->setTextWrap(false);
-  gfx->setCursor(logWindowLeft, labelY + (labelHeight + contentFontHeight) / 2 - 1);
-  gfx->print("Log:");
+  printText(FONT_CONTENT, logWindowLeft, labelY + (labelHeight + contentFontHeight) / 2 - 1, "Log:", 1);
 
   // Draw log window border
-  gfx->drawRect(logWindowLeft, logWindowTop, logWindowWidth, logWindowHeight, 1);
+  outlineArea(logWindowLeft, logWindowTop, logWindowWidth, logWindowHeight, 1);
 
   // Render visible log lines
-  gfx->setFont(contentFont);
   uint8_t lineHeight = contentFontHeight + contentFontHeight * 0.2; // 1px spacing between lines
-  uint16_t availWidth = logWindowWidth - 4 * optionPadding;         // Space for padding on both sides
-  int16_t spaceWidth = strWidth(" ", contentFont, contentSize);
+  uint16_t availWidth = logWrapWidth();
+  uint32_t totalLines = logEntryCount();
+  uint32_t spilledOnly = logSpilledOnly();
+  char recordText[S3UI_LOG_RECORD_TEXT_MAX];
+  layoutLog();
+
+  // Find the top of the view: the newest entries that fit, or the scrolled-back position. A view that
+  // does not follow new entries is pinned to the lines it shows now
+  uint8_t visibleLineCount = logVisibleLines();
+  uint32_t startIndex;
+  uint8_t skipLines;
+  logViewTop(visibleLineCount, recordText, startIndex, skipLines);
+  if (logAtTail && !logFollowTail) {
+    logAtTail = false;
+    logTopSequence = logFirstSequence() + startIndex;
+    logTopLine = 0;
+  }
+
+  // Render from the top entry onwards, straight out of the log arena (records through recordText, spilled
+  // entries through the spill read buffer). Only the visible lines are drawn; records shown for the first
+  // time are measured on the way
+  uint16_t drawY = logWindowTop + optionPadding;
+  uint8_t drawnLines = 0;
+  TextSpan span;
+  for (uint32_t i = startIndex; i < totalLines && drawnLines < visibleLineCount; i++) {
+    s3uiText line = logEntryText(i, recordText);
+    uint8_t entryLines = 0;
+    uint16_t pos = 0;
+    while (entryLines < kLogMaxLines && nextWrappedLine(line, pos, availWidth, WrapBreakLF, span)) {
+      bool skipped = (i == startIndex && entryLines < skipLines);
+      entryLines++;
+      if (skipped || drawnLines == visibleLineCount)
+        continue;
+      printText(FONT_CONTENT, logWindowLeft + 2 * optionPadding, drawY + contentFontHeight - 1,
+                line.slice(span.offset, span.length), 1);
+      drawY += lineHeight;
+      drawnLines++;
+    }
+    if (i >= spilledOnly && logStore.displayLines(i - spilledOnly) == kLogLinesUnknown)
+      logStore.setDisplayLines(i - spilledOnly, entryLines);
+  }
 
-  // Calculate starting index to show the latest lines
-  uint16_t totalLines = logLines.size();
+  // Position slider: thumb size is the visible share of all display lines
+  uint32_t allLines = logTotalLines();
+  uint16_t thumbHeight = logWindowHeight;
+  uint16_t thumbTop = logWindowTop;
+  if (allLines > visibleLineCount) {
+    thumbHeight = (uint32_t)visibleLineCount * logWindowHeight / allLines;
+    if (thumbHeight < 4)
+      thumbHeight = 4;
+    uint16_t travel = (logWindowHeight > thumbHeight) ? logWindowHeight - thumbHeight : 0;
+    uint32_t maxTop = allLines - visibleLineCount;
+    uint32_t topLine = logAtTail ? maxTop : logLinesBefore(startIndex) + skipLines;
+    if (topLine > maxTop)
+      topLine = maxTop;
+    thumbTop += (uint32_t)topLine * travel / maxTop;
+  }
+  drawSlider(logWindowLeft + logWindowWidth + sliderPadding, logWindowTop, logWindowHeight, thumbTop, thumbHeight);
+}
 
-  // First pass: calculate how many display lines each log line consumes
-  std::vector<uint8_t> lineDisplayCounts;
-  uint16_t totalDisplayLines = 0;
+// Wrapped line counts are cached per entry; rebuild them only after a layout change. Records are formatted
+// lazily, so only those that become visible are ever measured
+void s3ui::layoutLog() {
+  if (logLayoutValid)
+    return;
+  uint16_t totalLines = logStore.count();
   for (uint16_t i = 0; i < totalLines; i++) {
-    uint8_t displayLines = 0;
-    const String &line = logLines[i];
+    uint8_t lines = kLogLinesUnknown;
+    if (!logStore.isRecord(i)) {
+      uint16_t len;
+      const char *line = logStore.text(i, len);
+      lines = countLogDisplayLines(s3uiText(line, len));
+    }
+    logStore.setDisplayLines(i, lines);
+  }
+  logLayoutValid = true;
+}
 
-    int16_t segmentStart = 0;
-    for (int16_t pos = 0; pos <= (int16_t)line.length(); pos++) {
-      bool isNewline = (pos < (int16_t)line.length()) && (line[pos] == '\n');
-      bool isEnd = (pos == (int16_t)line.length());
+uint8_t s3ui::logVisibleLines() {
+  uint16_t contentHeight = displayHeight - (titleFontHeight + titleMargin) - 2 * contentBoxThickness;
+  uint16_t logWindowHeight = contentHeight - contentFontHeight - 2 * optionPadding;
+  uint8_t lineHeight = contentFontHeight + contentFontHeight * 0.2;
+  uint8_t visible = lineHeight ? (logWindowHeight - 2 * optionPadding) / lineHeight : 1;
+  return visible ? visible : 1;
+}
 
-      if (isNewline || isEnd) {
-        String segment = line.substring(segmentStart, pos);
-
-        // Skip empty segments (e.g., at end of line after final newline)
-        if (segment.length() > 0) {
-          int16_t segmentWidth = strWidth(segment, contentFont, contentSize);
-
-          if (segmentWidth <= availWidth) {
-            displayLines++;
-          } else {
-            // Count how many wrapped lines this segment takes
-            uint16_t chunkStart = 0;
-            while (chunkStart < segment.length()) {
-              displayLines++;
-              chunkStart += findWrapPoint(segment, chunkStart, availWidth);
-            }
-          }
-        }
-        segmentStart = pos + 1;
-      }
-    }
-    lineDisplayCounts.push_back(displayLines);
-    totalDisplayLines += displayLines;
+// Walk backwards from the newest entry only as far as the visible window needs
+uint32_t s3ui::logTailStart(uint8_t visible, char *recordText) {
+  uint16_t accumulatedLines = 0;
+  for (uint32_t i = logEntryCount(); i > 0; i--) {
+    uint8_t entryLines = logEntryLines(i - 1, recordText);
+    if (accumulatedLines + entryLines > visible)
+      return i;
+    accumulatedLines += entryLines;
   }
+  return 0;
+}
 
-  // Calculate starting index so we show the latest lines that fit
-  uint8_t visibleLineCount = (logWindowHeight - 2 * optionPadding) / lineHeight;
-  if (visibleLineCount == 0)
-    visibleLineCount = 1;
-
-  int16_t startIndex = 0;
-  uint16_t accumulatedLines = 0;
-  for (int16_t i = (int16_t)totalLines - 1; i >= 0; i--) {
-    if (accumulatedLines + lineDisplayCounts[i] > visibleLineCount) {
-      startIndex = i + 1;
-      break;
-    }
-    accumulatedLines += lineDisplayCounts[i];
+void s3ui::logViewTop(uint8_t visible, char *recordText, uint32_t &index, uint8_t &line) {
+  index = 0;
+  line = 0;
+  if (logAtTail) {
+    index = logTailStart(visible, recordText);
+    return;
+  }
+  // A top entry that has been evicted continues the view at the oldest entry
+  uint32_t first = logFirstSequence();
+  if (logTopSequence < first)
+    return;
+  uint32_t offset = logTopSequence - first;
+  uint32_t count = logEntryCount();
+  if (offset >= count) {
+    index = count ? count - 1 : 0;
+    return;
   }
+  index = offset;
+  line = logTopLine;
+}
 
-  // Second pass: render from startIndex onwards
-  uint16_t drawY = logWindowTop + optionPadding;
-  for (uint16_t i = startIndex; i < totalLines; i++) {
-    const String &line = logLines[i];
-
-    int16_t segmentStart = 0;
-    for (int16_t pos = 0; pos <= (int16_t)line.length(); pos++) {
-      bool isNewline = (pos < (int16_t)line.length()) && (line[pos] == '\n');
-      bool isEnd = (pos == (int16_t)line.length());
-
-      if (isNewline || isEnd) {
-        String segment = line.substring(segmentStart, pos);
-
-        // Skip empty segments (don't render or advance if segment is empty)
-        if (segment.length() > 0) {
-          int16_t segmentWidth = strWidth(segment, contentFont, contentSize);
-
-          if (segmentWidth <= availWidth) {
-            // Segment fits on one line
-            gfx->setCursor(logWindowLeft + 2 * optionPadding, drawY + contentFontHeight - 1);
-            gfx->setTextColor(1);
-            gfx->print(segment);
-            drawY += lineHeight;
-          } else {
-            // Segment needs wrapping: break at whitespace when possible
-            uint16_t chunkStart = 0;
-            while (chunkStart < segment.length()) {
-              uint16_t chunkLen = findWrapPoint(segment, chunkStart, availWidth);
-              if (chunkLen == 0)
-                chunkLen = 1; // At least one character
-
-              String chunk = segment.substring(chunkStart, chunkStart + chunkLen);
-              gfx->setCursor(logWindowLeft + 2 * optionPadding, drawY + contentFontHeight - 1);
-              gfx->setTextColor(1);
-              gfx->print(chunk);
-              drawY += lineHeight;
-              chunkStart += chunkLen;
-            }
-          }
-        }
-        segmentStart = pos + 1;
-      }
-    }
+void s3ui::scrollLog(int32_t deltaLines) {
+  if (!gfx || !contentFont || logEntryCount() == 0 || deltaLines == 0)
+    return;
+  layoutLog();
+  char recordText[S3UI_LOG_RECORD_TEXT_MAX];
+  uint8_t visible = logVisibleLines();
+  uint32_t index;
+  uint8_t line;
+  logViewTop(visible, recordText, index, line);
+
+  // Seek in display lines through the line indexes, then pin the view to the entry found
+  uint32_t top = logLinesBefore(index) + line;
+  uint32_t allLines = logTotalLines();
+  uint32_t maxTop = (allLines > visible) ? allLines - visible : 0;
+  if (deltaLines < 0)
+    top = ((uint32_t)-deltaLines >= top) ? 0 : top + deltaLines;
+  else
+    top += deltaLines;
+  if (top >= maxTop && deltaLines > 0) {
+    logAtTail = true;
+  } else {
+    uint32_t entryStart;
+    index = logEntryAtLine(top > maxTop ? maxTop : top, entryStart);
+    logAtTail = false;
+    logTopSequence = logFirstSequence() + index;
+    logTopLine = (top > maxTop ? maxTop : top) - entryStart;
   }
+  logDirty = true;
+}
+
+void s3ui::scrollLogToEnd() {
+  logAtTail = true;
+  logDirty = true;
+}
+
+void s3ui::setLogFollowTail(bool follow) {
+  logFollowTail = follow;
+  logDirty = true;
 }
 
 // Confirm: content-only (no screen clear) without bitmap
-void s3ui::showConfirm(const String &question, const String *options, uint8_t numOptions, uint8_t selectedIndex) {
+void s3ui::showConfirm(const s3uiText &question, const s3uiTextList &options, uint8_t numOptions,
+                       uint8_t selectedIndex) {
   // Delegate to the bitmap overload with nullptr bitmap
   showConfirm(nullptr, 0, 0, question, options, numOptions, selectedIndex);
 }
 
 // Confirm: content-only (no screen clear) with optional bitmap
-void s3ui::showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const String &question,
-                       const String *options, uint8_t numOptions, uint8_t selectedIndex) {
+void s3ui::showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const s3uiText &question,
+                       const s3uiTextList &options, uint8_t numOptions, uint8_t selectedIndex) {
   if (!gfx || !contentFont)
     return;
 
@@ -592,14 +1275,10 @@ void s3ui::showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH
     bmpY = contentTop + optionPadding;
     bmpX = (bitmapW >= contentWidth) ? (int16_t)contentLeft
                                      : (int16_t)contentLeft + ((int16_t)contentWidth - (int16_t)bitmapW) / 2;
-    gfx->drawBitmap(bmpX, bmpY, bitmap, bitmapW, bitmapH, 1);
+    blitBitmap(bmpX, bmpY, bitmap, bitmapW, bitmapH);
   }
 
   // Question: wrap text to fit, placed half line below bitmap bottom (accounting for baseline positioning)
-  gfx->setFont(contentFont);
-  gfx->setTextColor(1);
-  gfx->setTextWrap(false);
-  
   int16_t maxQWidth = (int16_t)contentWidth - 2 * optionPadding;
   int16_t qStartY;
   if (hasBitmap) {
@@ -611,27 +1290,18 @@ void s3ui::showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH
   }
 
   // Wrap and render question text
-  String qText = question;
-  uint16_t qIdx = 0;
+  uint16_t qPos = 0;
   int16_t currentY = qStartY;
-  while (qIdx < qText.length()) {
-    uint16_t chunkLen = findWrapPoint(qText, qIdx, maxQWidth);
-    if (chunkLen == 0)
-      chunkLen = 1;
-    
-    String line = qText.substring(qIdx, qIdx + chunkLen);
-    int16_t lineW = strWidth(line, contentFont, contentSize);
-    int16_t lineX = (int16_t)contentLeft + ((int16_t)contentWidth - lineW) / 2;
-    
-    gfx->setCursor(lineX, currentY - 1);
-    gfx->print(line);
-    
+  TextSpan line;
+  while (nextWrappedLine(question, qPos, maxQWidth, WrapNoBreaks, line)) {
+    int16_t lineX = (int16_t)contentLeft + ((int16_t)contentWidth - line.width) / 2;
+    printText(FONT_CONTENT, lineX, currentY - 1, question.slice(line.offset, line.length), 1);
     currentY += contentFontHeight;
-    qIdx += chunkLen;
   }
 
   // Options: calculate layout (horizontal if they fit, otherwise stacked)
-  if (numOptions == 0 || options == nullptr)
+  confirmButtons = 0;
+  if (numOptions == 0 || options.empty())
     return;
 
   uint16_t buttonHeight = contentFontHeight + 2 * optionPadding;
@@ -642,7 +1312,8 @@ void s3ui::showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH
   int16_t btnWidths[3];
   int16_t totalWidth = 0;
   for (uint8_t i = 0; i < numOptions; i++) {
-    int16_t labelW = strWidth(options[i], contentFont, contentSize);
+    s3uiText label = listItem(options, i, 0);
+    int16_t labelW = strWidth(label, contentFont, contentSize);
     int16_t hPadding = 2 * optionPadding;
     btnWidths[i] = labelW + 2 * hPadding;
     totalWidth += btnWidths[i];
@@ -672,19 +1343,19 @@ void s3ui::showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH
     for (uint8_t i = 0; i < numOptions; i++) {
       bool selected = (i == selectedIndex);
       if (selected) {
-        gfx->fillRect(currentX, rowY, btnWidths[i], buttonHeight, 1);
-        gfx->drawRect(currentX, rowY, btnWidths[i], buttonHeight, 1);
+        fillArea(currentX, rowY, btnWidths[i], buttonHeight, 1);
+        outlineArea(currentX, rowY, btnWidths[i], buttonHeight, 1);
       } else {
-        gfx->drawRect(currentX, rowY, btnWidths[i], buttonHeight, 1);
+        outlineArea(currentX, rowY, btnWidths[i], buttonHeight, 1);
       }
 
       // Label
-      int16_t labelW = strWidth(options[i], contentFont, contentSize);
+      s3uiText label = listItem(options, i, 0);
+      int16_t labelW = strWidth(label, contentFont, contentSize);
       int16_t textX = currentX + (btnWidths[i] - labelW) / 2;
       int16_t textBaselineY = rowY + (buttonHeight + contentFontHeight - 1) / 2 - 1;
-      gfx->setCursor(textX, textBaselineY);
-      gfx->setTextColor(selected ? 0 : 1);
-      gfx->print(options[i]);
+      printText(FONT_CONTENT, textX, textBaselineY, label, selected ? 0 : 1);
+      recordButton(i, rowY, buttonHeight, textBaselineY);
 
       currentX += btnWidths[i] + hSpacing;
     }
@@ -702,18 +1373,18 @@ void s3ui::showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH
       bool selected = (i == selectedIndex);
       
       if (selected) {
-        gfx->fillRect(btnX, topRowY, btnWidths[i], buttonHeight, 1);
-        gfx->drawRect(btnX, topRowY, btnWidths[i], buttonHeight, 1);
+        fillArea(btnX, topRowY, btnWidths[i], buttonHeight, 1);
+        outlineArea(btnX, topRowY, btnWidths[i], buttonHeight, 1);
       } else {
-        gfx->drawRect(btnX, topRowY, btnWidths[i], buttonHeight, 1);
+        outlineArea(btnX, topRowY, btnWidths[i], buttonHeight, 1);
       }
 
-      int16_t labelW = strWidth(options[i], contentFont, contentSize);
+      s3uiText label = listItem(options, i, 0);
+      int16_t labelW = strWidth(label, contentFont, contentSize);
       int16_t textX = btnX + (btnWidths[i] - labelW) / 2;
       int16_t textBaselineY = topRowY + (buttonHeight + contentFontHeight - 1) / 2 - 1;
-      gfx->setCursor(textX, textBaselineY);
-      gfx->setTextColor(selected ? 0 : 1);
-      gfx->print(options[i]);
+      printText(FONT_CONTENT, textX, textBaselineY, label, selected ? 0 : 1);
+      recordButton(i, topRowY, buttonHeight, textBaselineY);
     }
     
     // Bottom row (button 2)
@@ -721,18 +1392,18 @@ void s3ui::showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH
     bool selected = (2 == selectedIndex);
     
     if (selected) {
-      gfx->fillRect(btnX, bottomRowY, btnWidths[2], buttonHeight, 1);
-      gfx->drawRect(btnX, bottomRowY, btnWidths[2], buttonHeight, 1);
+      fillArea(btnX, bottomRowY, btnWidths[2], buttonHeight, 1);
+      outlineArea(btnX, bottomRowY, btnWidths[2], buttonHeight, 1);
     } else {
-      gfx->drawRect(btnX, bottomRowY, btnWidths[2], buttonHeight, 1);
+      outlineArea(btnX, bottomRowY, btnWidths[2], buttonHeight, 1);
     }
 
-    int16_t labelW = strWidth(options[2], contentFont, contentSize);
+    s3uiText label = listItem(options, 2, 0);
+    int16_t labelW = strWidth(label, contentFont, contentSize);
     int16_t textX = btnX + (btnWidths[2] - labelW) / 2;
     int16_t textBaselineY = bottomRowY + (buttonHeight + contentFontHeight - 1) / 2 - 1;
-    gfx->setCursor(textX, textBaselineY);
-    gfx->setTextColor(selected ? 0 : 1);
-    gfx->print(options[2]);
+    printText(FONT_CONTENT, textX, textBaselineY, label, selected ? 0 : 1);
+    recordButton(2, bottomRowY, buttonHeight, textBaselineY);
   } else {
     // Vertical stack
     uint16_t totalButtonsHeight = (uint16_t)numOptions * buttonHeight + (uint16_t)(numOptions - 1) * vSpacing;
@@ -744,72 +1415,193 @@ void s3ui::showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH
 
       bool selected = (i == selectedIndex);
       if (selected) {
-        gfx->fillRect(btnX, btnY, btnWidths[i], buttonHeight, 1);
-        gfx->drawRect(btnX, btnY, btnWidths[i], buttonHeight, 1);
+        fillArea(btnX, btnY, btnWidths[i], buttonHeight, 1);
+        outlineArea(btnX, btnY, btnWidths[i], buttonHeight, 1);
       } else {
-        gfx->drawRect(btnX, btnY, btnWidths[i], buttonHeight, 1);
+        outlineArea(btnX, btnY, btnWidths[i], buttonHeight, 1);
       }
 
-      int16_t labelW = strWidth(options[i], contentFont, contentSize);
+      s3uiText label = listItem(options, i, 0);
+      int16_t labelW = strWidth(label, contentFont, contentSize);
       int16_t textX = btnX + (btnWidths[i] - labelW) / 2;
       int16_t textBaselineY = btnY + (buttonHeight + contentFontHeight - 1) / 2 - 1;
-      gfx->setCursor(textX, textBaselineY);
-      gfx->setTextColor(selected ? 0 : 1);
-      gfx->print(options[i]);
+      printText(FONT_CONTENT, textX, textBaselineY, label, selected ? 0 : 1);
+      recordButton(i, btnY, buttonHeight, textBaselineY);
     }
   }
 }
 
 // Confirm screen: wrapper without bitmap
-void s3ui::confirmScreen(const String &title, const String &batteryPercentage, const String &question,
-                         const String *options, uint8_t numOptions, uint8_t selectedIndex) {
-  gfx->fillScreen(0);
-
-  animationActive = false;
-  logActive = false;
-
-  showTitleAndBorder(title, batteryPercentage);
-  showConfirm(question, options, numOptions, selectedIndex);
+void s3ui::confirmScreen(const s3uiText &title, const s3uiText &batteryPercentage, const s3uiText &question,
+                         const s3uiTextList &options, uint8_t numOptions, uint8_t selectedIndex) {
+  confirmScreen(title, batteryPercentage, nullptr, 0, 0, question, options, numOptions, selectedIndex);
 }
 
 // Confirm screen: wrapper with optional bitmap
-void s3ui::confirmScreen(const String &title, const String &batteryPercentage, const uint8_t *bitmap, uint16_t bitmapW,
-                         uint16_t bitmapH, const String &question, const String *options, uint8_t numOptions,
-                         uint8_t selectedIndex) {
-  gfx->fillScreen(0);
+void s3ui::confirmScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *bitmap,
+                         uint16_t bitmapW, uint16_t bitmapH, const s3uiText &question, const s3uiTextList &options,
+                         uint8_t numOptions, uint8_t selectedIndex) {
+  S3UI_STAT_SCOPE(S3UI_STAT_CONFIRM);
+  // Everything but the selection makes up the content fingerprint
+  uint32_t content = hashValue(hashValue(hashValue(kHashSeed, (uintptr_t)bitmap), bitmapW), bitmapH);
+  content = hashValue(hashText(content, question), numOptions);
+  for (uint8_t i = 0; i < numOptions && i < 3 && !options.empty(); i++) {
+    content = hashText(content, listItem(options, i, 0));
+  }
+
+  if (gfx && screenKind == SCREEN_CONFIRM && content == contentHash && updateTitleBar(title, batteryPercentage)) {
+    if (selectedIndex == confirmSelected)
+      return;
+    if (!contentOverflow) {
+      repaintConfirmButtons(bitmap, bitmapW, bitmapH, question, options, numOptions, selectedIndex);
+      return;
+    }
+    screenKind = SCREEN_NONE; // buttons drawn outside the content box need a full repaint
+  }
+  if (!beginScreen(SCREEN_CONFIRM, title, batteryPercentage, content))
+    return;
 
   animationActive = false;
   logActive = false;
 
-  showTitleAndBorder(title, batteryPercentage);
+  confirmSelected = selectedIndex;
   showConfirm(bitmap, bitmapW, bitmapH, question, options, numOptions, selectedIndex);
+  endContent();
+}
+
+void s3ui::repaintConfirmButtons(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const s3uiText &question,
+                                 const s3uiTextList &options, uint8_t numOptions, uint8_t selectedIndex) {
+  uint8_t from = confirmSelected;
+  uint8_t to = selectedIndex;
+  confirmSelected = selectedIndex;
+  if (confirmButtons == 0)
+    return;
+  if (from >= confirmButtons)
+    from = confirmButtons - 1;
+  if (to >= confirmButtons)
+    to = confirmButtons - 1;
+  if (from == to)
+    return;
+
+  // Clear the rows of both buttons (one band when they share a row) and replay the content clipped to them;
+  // the content stays inside the content box, so this reproduces a full repaint
+  int16_t bandTop[2] = {buttonTop[from], buttonTop[to]};
+  int16_t bandBottom[2] = {buttonBottom[from], buttonBottom[to]};
+  uint8_t bands = 2;
+  if (bandTop[1] <= bandBottom[0] && bandBottom[1] >= bandTop[0]) {
+    if (bandTop[1] < bandTop[0])
+      bandTop[0] = bandTop[1];
+    if (bandBottom[1] > bandBottom[0])
+      bandBottom[0] = bandBottom[1];
+    bands = 1;
+  }
+  for (uint8_t b = 0; b < bands; b++) {
+    fillArea(contentBoxThickness, bandTop[b], displayWidth - 2 * contentBoxThickness, bandBottom[b] - bandTop[b] + 1,
+             0);
+    setRowClip(bandTop[b], bandBottom[b] + 1);
+    showConfirm(bitmap, bitmapW, bitmapH, question, options, numOptions, selectedIndex);
+    clearRowClip();
+  }
+}
+
+void s3ui::recordButton(uint8_t index, int16_t top, int16_t height, int16_t baselineY) {
+  buttonTop[index] = top;
+  buttonBottom[index] = top + height - 1;
+  if (baselineY + contentMetrics.top < buttonTop[index])
+    buttonTop[index] = baselineY + contentMetrics.top;
+  if (baselineY + contentMetrics.bottom > buttonBottom[index])
+    buttonBottom[index] = baselineY + contentMetrics.bottom;
+  confirmButtons = index + 1;
 }
 
 // Non-blocking update - handles animation frames and log screen refresh
-void s3ui::update() {
+bool s3ui::update() {
+  S3UI_STAT_SCOPE(S3UI_STAT_SCREENS);
   if (!gfx)
-    return;
+    return false;
 
-  // Handle animation frame updates
+  // Handle animation frame updates against absolute deadlines; a late call catches up by skipping frames
   if (animationActive) {
     unsigned long currentTime = millis();
+    if ((long)(currentTime - nextFrameTime) >= 0) {
+      uint32_t steps = frameDelay ? (currentTime - nextFrameTime) / frameDelay + 1 : 1;
+      nextFrameTime += steps * frameDelay;
+      advanceAnimation(steps);
+    }
+  }
 
-    // Check if it's time to advance to next frame
-    if (currentTime - lastFrameTime >= frameDelay) {
-      currentFrame++;
-      if (currentFrame >= totalFrames) {
-        currentFrame = 0; // Loop animation
-      }
-      lastFrameTime = currentTime;
-      clearContentBox();
-      showRunningActivity(animationFrames[currentFrame], bitmapWidth, bitmapHeight, captionText);
+  // Advance a running list scroll; frames follow absolute deadlines like animation frames
+  if (scrollActive) {
+    unsigned long currentTime = millis();
+    if (optionScreen == OPTION_NONE) {
+      scrollActive = false;
+    } else if ((long)(currentTime - nextScrollTime) >= 0) {
+      int32_t offset;
+      int16_t thumbTop;
+      scrollPosition(currentTime, offset, thumbTop);
+      drawScrolledList(offset, thumbTop);
+      if (currentTime - scrollStart >= scrollDuration)
+        scrollActive = false;
+      else if (scrollFrameMs)
+        nextScrollTime += ((currentTime - nextScrollTime) / scrollFrameMs + 1) * scrollFrameMs;
     }
   }
 
-  // Handle log screen refresh
-  if (logActive) {
-    clearContentBox();
+  // Handle log screen refresh, only when the log or its layout changed
+  drainLogQueue();
+  spillLog(false);
+  if (logActive && logDirty) {
+    clearContent();
+    trackOverflow = true;
     showActivityLiveLog();
+    trackOverflow = false;
+  }
+
+  // Report (and consume) whether anything was drawn since the last update()
+  bool flush = needsDisplay;
+  needsDisplay = false;
+  return flush;
+}
+
+uint32_t s3ui::msUntilNextUpdate() {
+  if (!gfx)
+    return S3UI_NO_DEADLINE;
+  if (needsDisplay || (logActive && (logDirty || logQueue.pending())))
+    return 0;
+  if (logSpill.attached() && logSpillPending() >= logSpillBatch)
+    return 0;
+  uint32_t wait = S3UI_NO_DEADLINE;
+  unsigned long now = millis();
+  if (animationActive) {
+    long remaining = (long)(nextFrameTime - now);
+    wait = remaining > 0 ? (uint32_t)remaining : 0;
+  }
+  if (scrollActive && optionScreen != OPTION_NONE) {
+    long remaining = (long)(nextScrollTime - now);
+    if (remaining <= 0)
+      return 0;
+    if ((uint32_t)remaining < wait)
+      wait = remaining;
+  }
+  return wait;
+}
+
+void s3ui::advanceAnimation(uint32_t steps) {
+  // Whole loops leave the picture unchanged
+  steps %= totalFrames;
+  if (steps == 0)
+    return;
+  if (!encodedAnimation) {
+    uint16_t previousFrame = currentFrame;
+    currentFrame = (currentFrame + steps) % totalFrames;
+    drawFrameDelta(animationFrames[previousFrame], animationFrames[currentFrame]);
+    return;
+  }
+  // Delta frames only decode in order, so skipped frames are decoded (and their changes painted) on the way
+  while (steps--) {
+    if (++currentFrame >= totalFrames)
+      currentFrame = 0;
+    decodeNextFrame();
   }
 }
 
@@ -817,75 +1609,1031 @@ void s3ui::update() {
 void s3ui::clear() {
   if (!gfx)
     return;
-  gfx->fillScreen(0);
+  clearScreen();
   animationActive = false;
+  logActive = false;
 }
 
 // Clear only the content box area
 void s3ui::clearContentBox() {
   if (!gfx)
     return;
+  clearContent();
+  optionScreen = OPTION_NONE;
+  screenKind = SCREEN_NONE;
+}
+
+void s3ui::clearContent() {
   uint16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
   uint16_t contentHeight = displayHeight - (titleFontHeight + titleMargin) - 2 * contentBoxThickness;
-  gfx->fillRect(contentBoxThickness, contentTop, displayWidth - 2 * contentBoxThickness, contentHeight, 0);
+  fillArea(contentBoxThickness, contentTop, displayWidth - 2 * contentBoxThickness, contentHeight, 0);
 }
 
-// Calculate the width in pixels of a string with given font and size
-int16_t s3ui::strWidth(const String &str, const GFXfont *font, uint8_t size) {
-  if (!gfx || !font)
+// Drawing primitives
+
+void s3ui::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (trackOverflow) {
+    int16_t contentTop = titleFontHeight + titleMargin + contentBoxThickness;
+    if (x < contentBoxThickness || y < contentTop || x + w > (int16_t)(displayWidth - contentBoxThickness) ||
+        y + h > (int16_t)(displayHeight - contentBoxThickness))
+      contentOverflow = true;
+  }
+  if (rowClip) {
+    if (y < clipTop) {
+      h -= clipTop - y;
+      y = clipTop;
+    }
+    if (y + h > clipBottom)
+      h = clipBottom - y;
+    if (h <= 0)
+      return;
+  }
+  needsDisplay = true;
+
+  // Clip to the display
+  int16_t x1 = x + w - 1;
+  int16_t y1 = y + h - 1;
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (x1 >= (int16_t)displayWidth)
+    x1 = displayWidth - 1;
+  if (y1 >= (int16_t)displayHeight)
+    y1 = displayHeight - 1;
+  if (x1 < x || y1 < y)
+    return;
+#ifdef S3UI_RENDER_STATS
+  renderStats.total.pixelsTouched += (uint32_t)(x1 - x + 1) * (y1 - y + 1);
+  if (framebuffer.attached() && framebuffer.bufferLayout() == S3UI_LAYOUT_VERTICAL)
+    renderStats.total.bytesTouched += (uint32_t)(x1 - x + 1) * (y1 / 8 - y / 8 + 1);
+  else
+    renderStats.total.bytesTouched += (uint32_t)(x1 / 8 - x / 8 + 1) * (y1 - y + 1);
+#endif
+
+  if (x < dirtyX0)
+    dirtyX0 = x;
+  if (y < dirtyY0)
+    dirtyY0 = y;
+  if (x1 > dirtyX1)
+    dirtyX1 = x1;
+  if (y1 > dirtyY1)
+    dirtyY1 = y1;
+
+  // Rows below the last tracked page fold into it
+  uint16_t firstPage = y / S3UI_PAGE_HEIGHT;
+  uint16_t lastPage = y1 / S3UI_PAGE_HEIGHT;
+  if (firstPage >= S3UI_MAX_DIRTY_PAGES)
+    firstPage = S3UI_MAX_DIRTY_PAGES - 1;
+  if (lastPage >= S3UI_MAX_DIRTY_PAGES)
+    lastPage = S3UI_MAX_DIRTY_PAGES - 1;
+  for (uint16_t page = firstPage; page <= lastPage; page++) {
+    if (x < dirtyPageX0[page])
+      dirtyPageX0[page] = x;
+    if (x1 > dirtyPageX1[page])
+      dirtyPageX1[page] = x1;
+  }
+}
+
+void s3ui::clearScreen() {
+  optionScreen = OPTION_NONE;
+  screenKind = SCREEN_NONE;
+  barVisible = false;
+  contentOverflow = false;
+  S3UI_STAT(fillCalls++);
+  if (framebuffer.attached())
+    framebuffer.fillRect(0, 0, displayWidth, displayHeight, 0);
+  else
+    gfx->fillScreen(0);
+  markDirty(0, 0, displayWidth, displayHeight);
+}
+
+// Degenerate rectangles (from layouts that do not fit the display) are skipped on both paths
+void s3ui::fillArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (rowClip) {
+    if (y < clipTop) {
+      h -= clipTop - y;
+      y = clipTop;
+    }
+    if (y + h > clipBottom)
+      h = clipBottom - y;
+  }
+  if (w <= 0 || h <= 0)
+    return;
+  S3UI_STAT(fillCalls++);
+  if (framebuffer.attached())
+    framebuffer.fillRect(x, y, w, h, color);
+  else
+    gfx->fillRect(x, y, w, h, color);
+  markDirty(x, y, w, h);
+}
+
+void s3ui::outlineArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (w <= 0 || h <= 0)
+    return;
+  if (rowClip && (y < clipTop || y + h > clipBottom)) {
+    // Clipped edges, drawn as the four lines of the outline
+    fillArea(x, y, w, 1, color);
+    fillArea(x, y + h - 1, w, 1, color);
+    fillArea(x, y, 1, h, color);
+    fillArea(x + w - 1, y, 1, h, color);
+    return;
+  }
+  S3UI_STAT(outlineCalls++);
+  if (framebuffer.attached())
+    framebuffer.drawRect(x, y, w, h, color);
+  else
+    gfx->drawRect(x, y, w, h, color);
+  markDirty(x, y, w, h);
+}
+
+void s3ui::blitBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint16_t w, uint16_t h) {
+  if (rowClip) {
+    // Draw only the bitmap rows inside the clip (rows are byte-padded)
+    int16_t skip = (clipTop > y) ? clipTop - y : 0;
+    int16_t end = (clipBottom - y < (int16_t)h) ? clipBottom - y : (int16_t)h;
+    if (end <= skip)
+      return;
+    bitmap += (uint16_t)skip * ((w + 7) / 8);
+    y += skip;
+    h = end - skip;
+  }
+  S3UI_STAT(bitmapCalls++);
+  if (framebuffer.attached())
+    framebuffer.drawBitmap(x, y, bitmap, w, h);
+  else
+    gfx->drawBitmap(x, y, bitmap, w, h, 1);
+  markDirty(x, y, w, h);
+}
+
+void s3ui::plotBits(int16_t x, int16_t y, uint8_t setBits, uint8_t clearBits) {
+  uint8_t bits = setBits | clearBits;
+  if (!bits)
+    return;
+  if (framebuffer.attached()) {
+    framebuffer.drawBits(x, y, setBits, true);
+    framebuffer.drawBits(x, y, clearBits, false);
+  } else {
+    for (uint8_t i = 0, mask = 0x80; i < 8; i++, mask >>= 1) {
+      if (bits & mask) {
+        S3UI_STAT(pixelCalls++);
+        gfx->drawPixel(x + i, y, (setBits & mask) ? 1 : 0);
+      }
+    }
+  }
+
+  // Dirty span from the first to the last touched pixel
+  uint8_t first = 0;
+  while (!(bits & (0x80 >> first)))
+    first++;
+  uint8_t last = 7;
+  while (!(bits & (0x80 >> last)))
+    last--;
+  markDirty(x + first, y, last - first + 1, 1);
+}
+
+// Compare the frames byte by byte and touch only differing pixels
+void s3ui::drawFrameDelta(const uint8_t *from, const uint8_t *to) {
+  if (from == to)
+    return;
+
+  uint16_t byteWidth = (bitmapWidth + 7) / 8;
+  for (uint16_t j = 0; j < bitmapHeight; j++) {
+    const uint8_t *fromRow = from + j * byteWidth;
+    const uint8_t *toRow = to + j * byteWidth;
+    for (uint16_t k = 0; k < byteWidth; k++) {
+      uint8_t next = pgm_read_byte(toRow + k);
+      uint8_t diff = pgm_read_byte(fromRow + k) ^ next;
+      if (diff)
+        drawFrameByte(j, k, diff, next);
+    }
+  }
+}
+
+// Inside the content box (above the caption) this reproduces clear + redraw; where the bitmap overhangs the
+// box, frames were only ever ORed in, so pixels there are only set
+void s3ui::drawFrameByte(uint16_t row, uint16_t col, uint8_t diff, uint8_t next) {
+  if (col == (bitmapWidth - 1) / 8 && (bitmapWidth & 7))
+    diff &= (uint8_t)(0xFF << (8 - (bitmapWidth & 7))); // padding bits are not pixels
+  if (!diff)
+    return;
+
+  int16_t x = activityBitmapX + 8 * col;
+  int16_t y = activityBitmapY + row;
+  int16_t clipX0 = contentBoxThickness;
+  int16_t clipX1 = displayWidth - contentBoxThickness - 1;
+  int16_t clipY0 = titleFontHeight + titleMargin + contentBoxThickness;
+  uint8_t inside = 0;
+  if (y >= clipY0 && y < activityClipBottom) {
+    inside = 0xFF;
+    if (x < clipX0)
+      inside = (clipX0 - x >= 8) ? 0 : (uint8_t)(inside >> (clipX0 - x));
+    if (x + 7 > clipX1)
+      inside &= (clipX1 < x) ? 0 : (uint8_t)(0xFF << (7 - (clipX1 - x)));
+  }
+  plotBits(x, y, diff & next, diff & ~next & inside);
+}
+
+// Expand the RLE stream of the current frame, apply it to the scratch frame and repaint changed bytes.
+// Zero runs of delta frames (unchanged areas) are skipped without touching the scratch buffer.
+void s3ui::decodeNextFrame() {
+  uint16_t byteWidth = (bitmapWidth + 7) / 8;
+  uint16_t frameBytes = S3UI_ANIMATION_FRAME_BYTES(bitmapWidth, bitmapHeight);
+  if (currentFrame == 0)
+    encodedReadPos = encodedAnimation + S3UI_ANIMATION_HEADER_BYTES;
+
+  const uint8_t *p = encodedReadPos;
+  bool delta = pgm_read_byte(p++) == S3UI_FRAME_DELTA;
+  uint16_t i = 0;
+  uint16_t row = 0;
+  uint16_t col = 0;
+  while (i < frameBytes) {
+    uint8_t control = pgm_read_byte(p++);
+    bool repeat = control & 0x80;
+    uint16_t count = repeat ? (control & 0x7F) + 2 : control + 1;
+    if (count > frameBytes - i)
+      count = frameBytes - i; // malformed stream; never write past the frame
+    uint8_t value = repeat ? pgm_read_byte(p++) : 0;
+
+    if (repeat && delta && value == 0) {
+      i += count;
+      col += count;
+      while (col >= byteWidth) {
+        col -= byteWidth;
+        row++;
+      }
+      continue;
+    }
+
+    for (uint16_t n = 0; n < count; n++, i++) {
+      if (!repeat)
+        value = pgm_read_byte(p++);
+      uint8_t current = animationScratch[i];
+      uint8_t next = delta ? (current ^ value) : value;
+      if (next != current) {
+        animationScratch[i] = next;
+        drawFrameByte(row, col, current ^ next, next);
+      }
+      if (++col == byteWidth) {
+        col = 0;
+        row++;
+      }
+    }
+  }
+  encodedReadPos = p;
+}
+
+void s3ui::setRowClip(int16_t top, int16_t bottom) {
+  rowClip = true;
+  clipTop = top;
+  clipBottom = bottom;
+  if (framebuffer.attached())
+    framebuffer.setRowClip(top, bottom);
+}
+
+void s3ui::clearRowClip() {
+  rowClip = false;
+  if (framebuffer.attached())
+    framebuffer.clearRowClip();
+}
+
+void s3ui::printTextClipped(const GFXfont *font, uint8_t size, int16_t &cursorX, int16_t &cursorY,
+                            const s3uiText &text, uint16_t color) {
+  // Same glyph placement as Adafruit_GFX::write() with a custom font
+  uint8_t first = pgm_read_word(&font->first);
+  uint8_t last = pgm_read_word(&font->last);
+  uint8_t yAdvance = pgm_read_byte(&font->yAdvance);
+  const uint8_t *bitmap = fontBitmap(font);
+
+  for (uint16_t i = 0; i < text.length(); i++) {
+    uint8_t c = (uint8_t)text[i];
+    if (c == '\n') {
+      cursorX = 0;
+      cursorY += (int16_t)yAdvance * size;
+      continue;
+    }
+    if (c == '\r' || c < first || c > last)
+      continue;
+
+    const GFXglyph *glyph = fontGlyph(font, c - first);
+    uint8_t w = pgm_read_byte(&glyph->width);
+    uint8_t h = pgm_read_byte(&glyph->height);
+    const uint8_t *bits = bitmap + pgm_read_word(&glyph->bitmapOffset);
+    int16_t xOffset = (int8_t)pgm_read_byte(&glyph->xOffset);
+    int16_t yOffset = (int8_t)pgm_read_byte(&glyph->yOffset);
+    uint16_t bit = 0;
+    for (uint8_t yy = 0; yy < h; yy++) {
+      int16_t top = cursorY + (yOffset + yy) * size;
+      int16_t bottom = top + size;
+      if (top < clipTop)
+        top = clipTop;
+      if (bottom > clipBottom)
+        bottom = clipBottom;
+      for (uint8_t xx = 0; xx < w; xx++, bit++) {
+        if (top < bottom && (pgm_read_byte(bits + (bit >> 3)) & (0x80 >> (bit & 7)))) {
+          int16_t left = cursorX + (xOffset + xx) * size;
+          if (size == 1) {
+            S3UI_STAT(pixelCalls++);
+            gfx->drawPixel(left, top, color);
+          } else {
+            S3UI_STAT(fillCalls++);
+            gfx->fillRect(left, top, size, bottom - top, color);
+          }
+        }
+      }
+    }
+    cursorX += pgm_read_byte(&glyph->xAdvance) * size;
+  }
+}
+
+void s3ui::printTextCached(FontRole role, int16_t &cursorX, int16_t &cursorY, const s3uiText &text,
+                           uint16_t color) {
+  const FontMetrics &metrics = (role == FONT_TITLE) ? titleMetrics : contentMetrics;
+  uint8_t size = (role == FONT_TITLE) ? titleSize : contentSize;
+  int16_t lineHeight = (role == FONT_TITLE) ? titleFontHeight : contentFontHeight;
+  bool toFramebuffer = framebuffer.attached();
+  int16_t top = rowClip ? clipTop : INT16_MIN;
+  int16_t bottom = rowClip ? clipBottom : INT16_MAX;
+
+  for (uint16_t i = 0; i < text.length(); i++) {
+    uint8_t c = (uint8_t)text[i];
+    if (c == '\n') {
+      cursorX = 0;
+      cursorY += lineHeight;
+      continue;
+    }
+    if (c == '\r' || c < metrics.first || c > metrics.last)
+      continue;
+
+    const s3uiGlyphCache::Glyph *glyph = glyphCache.lookup(role, c);
+    if (glyph) {
+      int16_t gx = cursorX + glyph->xOffset * size;
+      int16_t gy = cursorY + glyph->yOffset * size;
+      const uint8_t *row = glyph->rows;
+      for (uint8_t yy = 0; yy < glyph->height; yy++, row += glyph->stride, gy += size) {
+        if (toFramebuffer) {
+          framebuffer.drawRow(gx, gy, row, glyph->width, size, color);
+          continue;
+        }
+        int16_t y0 = (gy < top) ? top : gy;
+        int16_t y1 = (gy + size > bottom) ? bottom : gy + size;
+        if (y0 >= y1)
+          continue;
+        // One pixel, line or rectangle per run of set pixels, covering the size rows the source row becomes
+        for (uint16_t x = 0; x < glyph->width;) {
+          if (!(row[x >> 3] & (0x80 >> (x & 7)))) {
+            x++;
+            continue;
+          }
+          uint16_t run = x;
+          while (run < glyph->width && (row[run >> 3] & (0x80 >> (run & 7))))
+            run++;
+          if (run - x == 1 && y1 - y0 == 1) {
+            S3UI_STAT(pixelCalls++);
+            gfx->drawPixel(gx + x, y0, color);
+          } else if (y1 - y0 == 1) {
+            S3UI_STAT(fillCalls++);
+            gfx->drawFastHLine(gx + x, y0, run - x, color);
+          } else {
+            S3UI_STAT(fillCalls++);
+            gfx->fillRect(gx + x, y0, run - x, y1 - y0, color);
+          }
+          x = run;
+        }
+      }
+    }
+    cursorX += metrics.advance[c - metrics.first] * size;
+  }
+}
+
+int16_t s3ui::printText(FontRole role, int16_t x, int16_t y, const s3uiText &text, uint16_t color) {
+  const GFXfont *font = (role == FONT_TITLE) ? titleFont : contentFont;
+  uint8_t size = (role == FONT_TITLE) ? titleSize : contentSize;
+  // A scaled glyph's baseline row covers size rows below the cursor; keep its last one on y, as at size 1
+  int16_t cursorY = y - (size - 1);
+  int16_t endX = x;
+  int16_t endY = cursorY;
+  const FontMetrics &ext = (role == FONT_TITLE) ? titleMetrics : contentMetrics;
+  S3UI_STAT(textCalls++);
+  S3UI_STAT(charsPrinted += text.length());
+  // The framebuffer blits font rows directly at size 1; the cache pays off for scaled text and on the GFX path
+  if (glyphCache.active() && ext.advance && (size > 1 || !framebuffer.attached())) {
+    printTextCached(role, endX, endY, text, color);
+  } else if (framebuffer.attached()) {
+    framebuffer.drawText(font, endX, endY, text, color, size);
+  } else if (rowClip && (y + ext.top < clipTop || y + ext.bottom >= clipBottom)) {
+    printTextClipped(font, size, endX, endY, text, color);
+  } else {
+    gfx->setFont(font);
+    gfx->setTextSize(size);
+    gfx->setTextWrap(false);
+    gfx->setTextColor(color);
+    gfx->setCursor(x, cursorY);
+#ifdef __AVR__
+    if (text.inFlash()) {
+      for (uint16_t i = 0; i < text.length(); i++) {
+        gfx->write((uint8_t)text[i]);
+      }
+    } else
+#endif
+      gfx->write((const uint8_t *)text.data(), text.length());
+    endX = gfx->getCursorX();
+    endY = gfx->getCursorY();
+  }
+  endY += size - 1;
+
+  // The cursor tells how far the text advanced; glyph extents cover ink outside the advance box
+  if (endY == y) {
+    int16_t left = x + ext.left;
+    int16_t right = ((endX > x) ? endX : x) + ext.right;
+    markDirty(left, y + ext.top, right - left + 1, ext.bottom - ext.top + 1);
+  } else {
+    // Embedded newlines moved the cursor: cover every affected row
+    markDirty(0, y + ext.top, displayWidth, endY - y + ext.bottom - ext.top + 1);
+  }
+  return endX;
+}
+
+void s3ui::buildMetrics(FontMetrics &metrics, const GFXfont *font, uint8_t size) {
+  delete[] metrics.advance;
+  metrics = FontMetrics();
+  if (!font)
+    return;
+
+  metrics.first = pgm_read_word(&font->first);
+  metrics.last = pgm_read_word(&font->last);
+  if (metrics.last < metrics.first)
+    return;
+  metrics.advance = new uint8_t[metrics.last - metrics.first + 1];
+  for (uint16_t i = 0; i <= metrics.last - metrics.first; i++) {
+    metrics.advance[i] = pgm_read_byte(&fontGlyph(font, i)->xAdvance);
+  }
+  measureGlyphs(metrics, font, size);
+}
+
+// Glyph pixels become size x size squares, so every bound scales from the glyph's own edges; rows are counted
+// from the last row of the baseline, where printText() puts its y
+void s3ui::measureGlyphs(FontMetrics &metrics, const GFXfont *font, uint8_t size) {
+  metrics.top = metrics.bottom = metrics.left = metrics.right = 0;
+  if (!font || !metrics.advance)
+    return;
+
+  for (uint16_t i = 0; i <= metrics.last - metrics.first; i++) {
+    const GFXglyph *glyph = fontGlyph(font, i);
+    uint8_t w = pgm_read_byte(&glyph->width);
+    uint8_t h = pgm_read_byte(&glyph->height);
+    if (w == 0 || h == 0)
+      continue;
+
+    int16_t xOffset = (int8_t)pgm_read_byte(&glyph->xOffset);
+    int16_t yOffset = (int8_t)pgm_read_byte(&glyph->yOffset);
+    int16_t top = yOffset * size - (size - 1);
+    int16_t bottom = (yOffset + h - 1) * size;
+    int16_t right = (xOffset + w - metrics.advance[i]) * size;
+    if (top < metrics.top)
+      metrics.top = top;
+    if (bottom > metrics.bottom)
+      metrics.bottom = bottom;
+    if (xOffset * size < metrics.left)
+      metrics.left = xOffset * size;
+    if (right > metrics.right)
+      metrics.right = right;
+  }
+}
+
+const s3ui::FontMetrics *s3ui::metricsFor(const GFXfont *font) const {
+  if (font && font == contentFont)
+    return &contentMetrics;
+  if (font && font == titleFont)
+    return &titleMetrics;
+  return nullptr;
+}
+
+// Damage tracking
+
+bool s3ui::getDirtyRegion(s3uiRect &region) const {
+  if (dirtyX1 < dirtyX0)
+    return false;
+  region.x = dirtyX0;
+  region.y = dirtyY0;
+  region.w = dirtyX1 - dirtyX0 + 1;
+  region.h = dirtyY1 - dirtyY0 + 1;
+  return true;
+}
+
+uint8_t s3ui::getDirtyBands(s3uiRect *bands, uint8_t maxBands) const {
+  if (!bands || maxBands == 0)
     return 0;
 
-  int16_t totalWidth = 0;
-  gfx->setFont(font);
-  for (size_t i = 0; i < str.length(); i++) {
-    char c = str.charAt(i);
-    if (c < font->first || c > font->last) {
-      continue; // Character not in font
+  uint8_t count = 0;
+  uint16_t pageCount = (displayHeight + S3UI_PAGE_HEIGHT - 1) / S3UI_PAGE_HEIGHT;
+  if (pageCount > S3UI_MAX_DIRTY_PAGES)
+    pageCount = S3UI_MAX_DIRTY_PAGES;
+
+  for (uint16_t page = 0; page < pageCount; page++) {
+    if (dirtyPageX1[page] < dirtyPageX0[page])
+      continue;
+
+    int16_t y = page * S3UI_PAGE_HEIGHT;
+    int16_t bottom = (page == S3UI_MAX_DIRTY_PAGES - 1) ? (int16_t)displayHeight : y + S3UI_PAGE_HEIGHT;
+    if (bottom > (int16_t)displayHeight)
+      bottom = displayHeight;
+
+    // Extend the previous band when this page directly follows it (or when out of band slots)
+    s3uiRect *prev = (count > 0) ? &bands[count - 1] : nullptr;
+    if (prev && (prev->y + prev->h == y || count == maxBands)) {
+      int16_t x0 = (dirtyPageX0[page] < prev->x) ? dirtyPageX0[page] : prev->x;
+      int16_t x1 = (dirtyPageX1[page] > prev->x + prev->w - 1) ? dirtyPageX1[page] : prev->x + prev->w - 1;
+      prev->x = x0;
+      prev->w = x1 - x0 + 1;
+      prev->h = bottom - prev->y;
+    } else {
+      s3uiRect &band = bands[count++];
+      band.x = dirtyPageX0[page];
+      band.y = y;
+      band.w = dirtyPageX1[page] - dirtyPageX0[page] + 1;
+      band.h = bottom - y;
     }
-    GFXglyph *glyph = &font->glyph[c - font->first];
-    totalWidth += (glyph->xAdvance * size);
   }
-  return totalWidth;
+  return count;
+}
+
+void s3ui::resetDirtyRegion() {
+  dirtyX0 = dirtyY0 = INT16_MAX;
+  dirtyX1 = dirtyY1 = -1;
+  for (uint8_t page = 0; page < S3UI_MAX_DIRTY_PAGES; page++) {
+    dirtyPageX0[page] = INT16_MAX;
+    dirtyPageX1[page] = -1;
+  }
 }
 
-// Find wrap point: returns the number of characters from startIdx that fit within maxWidth
-// Tries to break at whitespace; if no whitespace found, breaks at character limit
-uint16_t s3ui::findWrapPoint(const String &str, uint16_t startIdx, uint16_t maxWidth) {
-  if (startIdx >= str.length())
+// Calculate the width in pixels of a string with given font and size
+int16_t s3ui::strWidth(const s3uiText &str, const GFXfont *font, uint8_t size) {
+  const FontMetrics *metrics = metricsFor(font);
+  if (!metrics || !metrics->advance)
     return 0;
 
-  // Find how many characters fit within maxWidth
-  uint16_t endIdx = startIdx;
-  int16_t lastSpaceIdx = -1;
+  // Sum advances from the table; characters outside the font contribute nothing
+  const uint8_t *advance = metrics->advance;
+  uint16_t first = metrics->first;
+  uint16_t span = metrics->last - first;
+  uint16_t len = str.length();
+  S3UI_STAT(charsMeasured += len);
+  int16_t totalWidth = 0;
+  for (uint16_t i = 0; i < len; i++) {
+    uint16_t index = (uint8_t)str[i] - first;
+    if (index <= span)
+      totalWidth += advance[index];
+  }
+  return totalWidth * size;
+}
 
-  while (endIdx < str.length()) {
-    String chunk = str.substring(startIdx, endIdx + 1);
-    int16_t chunkWidth = strWidth(chunk, contentFont, contentSize);
+int16_t s3ui::getTextWidth(const s3uiText &text, bool useTitleFont) {
+  if (useTitleFont)
+    return strWidth(text, titleFont, titleSize);
+  return strWidth(text, contentFont, contentSize);
+}
 
-    if (chunkWidth > maxWidth) {
-      // This character doesn't fit; break before it
-      if (lastSpaceIdx > startIdx) {
-        // Use the last space we found (skip the space itself; next iteration will skip it)
-        return lastSpaceIdx - startIdx + 1;
+// Wrap engine: produce the next display line of text starting at pos, in a single scan with a running width.
+// Lines break before the character that would exceed maxWidth, preferring just after the last space
+// (the space stays on the line). Characters selected by breaks end a segment; empty segments yield no line.
+bool s3ui::nextWrappedLine(const s3uiText &text, uint16_t &pos, uint16_t maxWidth, uint8_t breaks, TextSpan &line) {
+  S3UI_STAT(wrapCalls++);
+  const uint8_t *advance = contentMetrics.advance;
+  if (!advance)
+    return false;
+  uint16_t first = contentMetrics.first;
+  uint16_t span = contentMetrics.last - first;
+  uint8_t size = contentSize;
+  uint16_t len = text.length();
+
+  // Skip segment separators (consecutive ones form empty segments, which produce no line)
+  while (pos < len && isWrapBreak(text[pos], breaks)) {
+    pos++;
+  }
+  if (pos >= len)
+    return false;
+
+  uint16_t start = pos;
+  uint16_t i = start;
+  int16_t width = 0;
+  int16_t lastSpace = -1;
+  int16_t widthAtSpace = 0;
+  while (i < len && !isWrapBreak(text[i], breaks)) {
+    uint16_t index = (uint8_t)text[i] - first;
+    int16_t next = width + ((index <= span) ? advance[index] * size : 0);
+
+    if (next > (int16_t)maxWidth) {
+      if (lastSpace > (int16_t)start) {
+        // Break after the last space that fit
+        line.length = lastSpace - start + 1;
+        line.width = widthAtSpace;
+      } else if (i > start) {
+        // No space found, break before this character
+        line.length = i - start;
+        line.width = width;
       } else {
-        // No space found, break at previous character
-        return (endIdx > startIdx) ? (endIdx - startIdx) : 1;
+        // A single character wider than the line still takes a line of its own
+        line.length = 1;
+        line.width = next;
       }
+      line.offset = start;
+      pos = start + line.length;
+      return true;
     }
 
-    // Character fits; remember if it's a space
-    if (str[endIdx] == ' ') {
-      lastSpaceIdx = endIdx;
+    width = next;
+    if (text[i] == ' ') {
+      lastSpace = i;
+      widthAtSpace = width;
+    }
+    i++;
+  }
+
+  // Rest of the segment fits
+  line.offset = start;
+  line.length = i - start;
+  line.width = width;
+  pos = i;
+  return true;
+}
+
+// Width available to log text: content box minus the position slider and log window padding on both sides
+uint16_t s3ui::logWrapWidth() {
+  uint16_t contentWidth = displayWidth - 2 * contentBoxThickness;
+  uint16_t logWindowWidth = contentWidth - 2 * optionPadding - sliderWidth - sliderPadding;
+  return logWindowWidth - 4 * optionPadding;
+}
+
+// Count how many display lines a log entry consumes once split on '\n' and wrapped. The count is capped below
+// kLogLinesUnknown so that it fits the cached uint8_t; showActivityLiveLog() cuts longer entries at the same line
+uint8_t s3ui::countLogDisplayLines(const s3uiText &line) {
+  uint16_t availWidth = logWrapWidth();
+  uint8_t displayLines = 0;
+  uint16_t pos = 0;
+  TextSpan span;
+  while (displayLines < kLogMaxLines && nextWrappedLine(line, pos, availWidth, WrapBreakLF, span)) {
+    displayLines++;
+  }
+  return displayLines;
+}
+
+// Append a line to the log, measuring its wrapped height once up front
+void s3ui::appendLogLine(const s3uiText &line) {
+  bool canMeasure = logLayoutValid && gfx && contentFont;
+  uint8_t displayLines = canMeasure ? countLogDisplayLines(line) : 0;
+  if (!canMeasure)
+    logLayoutValid = false;
+  logStore.append(line, displayLines);
+  logDirty = true;
+#ifdef S3UI_RENDER_STATS
+  countLogAllocations();
+#endif
+}
+
+// Append a structured record: a fixed-size copy, formatted and measured only once it becomes visible
+void s3ui::logRecord(s3uiLogLevel level, const __FlashStringHelper *format, s3uiLogArg a0, s3uiLogArg a1,
+                     s3uiLogArg a2, s3uiLogArg a3) {
+  if (level < logLevel())
+    return;
+  logRecord(s3uiMakeLogRecord(level, format, a0, a1, a2, a3));
+}
+
+void s3ui::logRecord(const s3uiLogRecord &record) {
+  // Records not built by s3uiMakeLogRecord() may carry any level; clamp it the same way for the prefix lookup
+  if (record.level >= S3UI_LOG_LEVELS) {
+    s3uiLogRecord clamped = record;
+    clamped.level = S3UI_LOG_ERROR;
+    logRecord(clamped);
+    return;
+  }
+  if (record.level < logLevel())
+    return;
+  logStore.appendRecord(&record, sizeof(record), kLogLinesUnknown);
+  logDirty = true;
+#ifdef S3UI_RENDER_STATS
+  countLogAllocations();
+#endif
+}
+
+bool s3ui::setLogQueue(uint16_t capacity, s3uiQueueProducers producers, s3uiQueueOverflow overflow) {
+  bool ok = logQueue.configure(capacity, sizeof(s3uiLogRecord), producers, overflow);
+#ifdef S3UI_RENDER_STATS
+  if (ok && capacity) {
+    renderStats.total.allocations++;
+    renderStats.total.allocatedBytes += logQueue.capacityBytes();
+  }
+#endif
+  return ok;
+}
+
+// Producer side: runs in interrupt handlers and other tasks, so it only reads settings and pushes a copy
+bool s3ui::queueLogRecord(s3uiLogLevel level, const __FlashStringHelper *format, s3uiLogArg a0, s3uiLogArg a1,
+                          s3uiLogArg a2, s3uiLogArg a3) {
+  if (level < logLevel())
+    return true;
+  s3uiLogRecord record = s3uiMakeLogRecord(level, format, a0, a1, a2, a3);
+  return logQueue.push(&record);
+}
+
+// Consumer side: bounded so producers that keep pushing cannot hold update() in the loop
+void s3ui::drainLogQueue() {
+  s3uiLogRecord record;
+  uint16_t budget = logQueue.capacity();
+  while (budget-- && logQueue.pop(&record)) {
+    logStore.appendRecord(&record, sizeof(record), kLogLinesUnknown);
+    logDirty = true;
+  }
+#ifdef S3UI_RENDER_STATS
+  countLogAllocations();
+#endif
+}
+
+// Format a log entry for display; text entries are returned straight from the arena
+s3uiText s3ui::logStoredText(uint16_t index, char *buffer) {
+  uint16_t length;
+  const char *data = logStore.text(index, length);
+  if (!logStore.isRecord(index))
+    return s3uiText(data, length);
+
+  // Arena bytes are not aligned for the record's members
+  s3uiLogRecord record;
+  memcpy(&record, data, sizeof(record));
+
+  uint16_t used = 0;
+  if (logTimestamps) {
+    uint32_t seconds = record.timestamp / 1000;
+    s3uiLogRecord stamp;
+    stamp.format = PSTR("%02lu:%02lu ");
+    stamp.args[0] = seconds / 60;
+    stamp.args[1] = seconds % 60;
+    used = s3uiFormatLogRecord(stamp, buffer, S3UI_LOG_RECORD_TEXT_MAX);
+  }
+  const s3uiText &prefix = logPrefix[record.level];
+  for (uint16_t i = 0; i < prefix.length() && used + 1 < S3UI_LOG_RECORD_TEXT_MAX; i++)
+    buffer[used++] = prefix[i];
+  used += s3uiFormatLogRecord(record, buffer + used, S3UI_LOG_RECORD_TEXT_MAX - used);
+  return s3uiText(buffer, used);
+}
+
+// With spilling, the log is the spilled entries from logSpillBase on, minus those still in RAM (the written
+// ones occupy RAM entries [0, overlap)), then all RAM entries
+uint32_t s3ui::logSpilledOnly() {
+  if (!logSpill.attached())
+    return 0;
+  uint32_t first = logStore.firstSequence();
+  if (logSpillNext < first) {
+    logSpillLost += first - logSpillNext;
+    logSpillNext = first;
+  }
+  uint32_t overlap = logSpillNext - first;
+  uint32_t spilled = logSpill.count() - logSpillBase;
+  return spilled > overlap ? spilled - overlap : 0;
+}
+
+uint16_t s3ui::logSpillPending() {
+  if (!logSpill.attached())
+    return 0;
+  logSpilledOnly();
+  return logStore.count() - (uint16_t)(logSpillNext - logStore.firstSequence());
+}
+
+s3uiText s3ui::logEntryText(uint32_t index, char *buffer) {
+  uint32_t spilledOnly = logSpilledOnly();
+  if (index < spilledOnly)
+    return logSpill.text(logSpillBase + index);
+  return logStoredText(index - spilledOnly, buffer);
+}
+
+uint8_t s3ui::logEntryLines(uint32_t index, char *buffer) {
+  uint32_t spilledOnly = logSpilledOnly();
+  if (index < spilledOnly)
+    return logSpill.displayLines(logSpillBase + index);
+  uint16_t stored = index - spilledOnly;
+  uint8_t lines = logStore.displayLines(stored);
+  if (lines == kLogLinesUnknown) {
+    lines = countLogDisplayLines(logStoredText(stored, buffer));
+    logStore.setDisplayLines(stored, lines);
+  }
+  return lines;
+}
+
+uint32_t s3ui::logLinesBefore(uint32_t index) {
+  uint32_t spilledOnly = logSpilledOnly();
+  if (spilledOnly == 0)
+    return logStore.linesBefore(index);
+  uint32_t baseLines = logSpill.linesBefore(logSpillBase);
+  if (index < spilledOnly)
+    return logSpill.linesBefore(logSpillBase + index) - baseLines;
+  return logSpill.linesBefore(logSpillBase + spilledOnly) - baseLines + logStore.linesBefore(index - spilledOnly);
+}
+
+uint32_t s3ui::logEntryAtLine(uint32_t line, uint32_t &entryStart) {
+  uint32_t spilledOnly = logSpilledOnly();
+  if (spilledOnly == 0)
+    return logStore.entryAtLine(line, entryStart);
+  uint32_t baseLines = logSpill.linesBefore(logSpillBase);
+  uint32_t spilledLines = logSpill.linesBefore(logSpillBase + spilledOnly) - baseLines;
+  if (line >= spilledLines && logStore.count()) {
+    uint32_t index = spilledOnly + logStore.entryAtLine(line - spilledLines, entryStart);
+    entryStart += spilledLines;
+    return index;
+  }
+  uint32_t index = logSpill.entryAtLine(baseLines + line, logSpillBase, spilledOnly, entryStart) - logSpillBase;
+  entryStart -= baseLines;
+  return index;
+}
+
+// One batch per call: the text of each entry (records formatted) with its wrapped line count, measured now if
+// needed so the count stored in the index matches what the view shows
+bool s3ui::spillLog(bool all) {
+  uint16_t pending = logSpillPending();
+  if (pending == 0 || (!all && pending < logSpillBatch))
+    return true;
+  bool canMeasure = gfx && contentFont;
+  if (canMeasure)
+    layoutLog();
+  char recordText[S3UI_LOG_RECORD_TEXT_MAX];
+  uint16_t first = logStore.count() - pending;
+  for (uint16_t i = first; i < logStore.count(); i++) {
+    s3uiText text = logStoredText(i, recordText);
+    uint8_t lines = logStore.displayLines(i);
+    if (lines == kLogLinesUnknown || !logLayoutValid) {
+      lines = canMeasure ? countLogDisplayLines(text) : 1;
+      if (canMeasure)
+        logStore.setDisplayLines(i, lines);
     }
-    endIdx++;
+    logSpill.append(text, lines);
   }
+  if (!logSpill.commit()) {
+    logSpill.detach();
+    logAtTail = true;
+    logDirty = true;
+    return false;
+  }
+  logSpillNext += pending;
+  return true;
+}
 
-  // All remaining characters fit - consume them all (don't break at space)
-  return endIdx - startIdx;
+bool s3ui::setLogSpill(s3uiLogStorage *data, s3uiLogStorage *index, uint16_t batchEntries) {
+  logSpill.detach();
+  logAtTail = true;
+  logDirty = true;
+  if (!data || !index)
+    return true;
+  if (!logStore.isFixedCapacity() || !logSpill.attach(data, index))
+    return false;
+#ifdef S3UI_RENDER_STATS
+  renderStats.total.allocations++;
+  renderStats.total.allocatedBytes += s3uiLogSpill::bufferBytes();
+#endif
+  logSpillNext = logStore.firstSequence();
+  logSpillBase = 0;
+  logSpillBatch = batchEntries ? batchEntries : 1;
+  return true;
 }
 
-// Append a line to the log
-void s3ui::appendLogLine(const String &line) { logLines.push_back(line); }
+bool s3ui::flushLogSpill() { return logSpill.attached() && spillLog(true); }
+
+// queueLogRecord() reads the level concurrently; a single byte, so a volatile access is atomic on AVR
+void s3ui::setLogLevel(s3uiLogLevel level) {
+#ifdef __AVR__
+  *(volatile s3uiLogLevel *)&logMinLevel = level;
+#else
+  __atomic_store_n(&logMinLevel, level, __ATOMIC_RELEASE);
+#endif
+}
+
+s3uiLogLevel s3ui::logLevel() const {
+#ifdef __AVR__
+  return *(const volatile s3uiLogLevel *)&logMinLevel;
+#else
+  return __atomic_load_n(&logMinLevel, __ATOMIC_ACQUIRE);
+#endif
+}
+
+// Changing how records are shown invalidates their cached line counts
+void s3ui::setLogLevelPrefix(s3uiLogLevel level, const s3uiText &prefix) {
+  if (level >= S3UI_LOG_LEVELS)
+    return;
+  logPrefix[level] = prefix;
+  logLayoutValid = false;
+  logDirty = true;
+}
+
+void s3ui::setLogTimestamps(bool show) {
+  if (show == logTimestamps)
+    return;
+  logTimestamps = show;
+  logLayoutValid = false;
+  logDirty = true;
+}
 
 // Clear all log lines
-void s3ui::clearLog() { logLines.clear(); }
+void s3ui::clearLog() {
+  logStore.clear();
+  logSpillNext = logStore.firstSequence();
+  logSpillBase = logSpill.count();
+  logAtTail = true;
+  logDirty = true;
+}
+
+// Switch the log to a preallocated ring arena (or back to growable storage with (0, 0))
+bool s3ui::setLogCapacity(uint32_t bytes, uint16_t entries) {
+  bool ok = logStore.configure(bytes, entries);
+  if (!logStore.isFixedCapacity())
+    logSpill.detach();
+  logSpillNext = logStore.firstSequence();
+  logAtTail = true;
+  logLayoutValid = false;
+  logDirty = true;
+#ifdef S3UI_RENDER_STATS
+  countLogAllocations();
+#endif
+  return ok;
+}
+
+#ifdef S3UI_RENDER_STATS
+// Render instrumentation
+
+s3ui::StatScope::StatScope(s3ui &owner, uint8_t screenType)
+    : ui(owner), mark(owner.renderStats.total), start(micros()), screen(screenType), active(!owner.statsTiming) {
+  ui.statsTiming = true;
+}
+
+s3ui::StatScope::~StatScope() {
+  if (!active)
+    return;
+  ui.statsTiming = false;
+  uint32_t elapsed = micros() - start;
+  s3uiRenderStats &stats = ui.renderStats;
+  if (screen == S3UI_STAT_SCREENS) {
+    stats.total.updateCalls++;
+    stats.total.updateMicros += elapsed;
+    if (elapsed > stats.maxUpdateMicros)
+      stats.maxUpdateMicros = elapsed;
+  } else {
+    stats.total.screenCalls++;
+    stats.total.screenMicros += elapsed;
+    stats.screenCalls[screen]++;
+    stats.screenMicros[screen] += elapsed;
+    if (elapsed > stats.maxScreenMicros)
+      stats.maxScreenMicros = elapsed;
+  }
+
+  // The counters are all uint32_t: the call's share is the counter-wise difference
+  const uint32_t *now = (const uint32_t *)&stats.total;
+  const uint32_t *before = (const uint32_t *)&mark;
+  uint32_t *last = (uint32_t *)&stats.last;
+  for (uint8_t i = 0; i < sizeof(s3uiRenderCounters) / sizeof(uint32_t); i++)
+    last[i] = now[i] - before[i];
+}
+
+void s3ui::countLogAllocations() {
+  renderStats.total.allocations += logStore.allocations() - logAllocsSeen;
+  renderStats.total.allocatedBytes += logStore.allocatedBytes() - logAllocBytesSeen;
+  logAllocsSeen = logStore.allocations();
+  logAllocBytesSeen = logStore.allocatedBytes();
+}
+
+void s3ui::resetRenderStats() { memset(&renderStats, 0, sizeof(renderStats)); }
+
+// Counter names in s3uiRenderCounters member order, and screen names in s3uiStatScreen order
+static const char kCounterNames[] PROGMEM = "fill_calls\0outline_calls\0bitmap_calls\0text_calls\0pixel_calls\0"
+                                            "pixels_touched\0bytes_touched\0chars_measured\0chars_printed\0"
+                                            "allocations\0allocated_bytes\0wrap_calls\0screen_calls\0screen_us\0"
+                                            "update_calls\0update_us\0";
+static const char kScreenNames[] PROGMEM = "option_select\0option_value_set\0activity\0log\0confirm\0";
+
+void s3ui::printRenderStats(Print &out) const {
+  const uint32_t *total = (const uint32_t *)&renderStats.total;
+  const uint32_t *last = (const uint32_t *)&renderStats.last;
+  const char *name = kCounterNames;
+  out.println(F("counter,total,last"));
+  for (uint8_t i = 0; i < sizeof(s3uiRenderCounters) / sizeof(uint32_t); i++) {
+    out.print((const __FlashStringHelper *)name);
+    out.print(',');
+    out.print(total[i]);
+    out.print(',');
+    out.println(last[i]);
+    name += strlen_P(name) + 1;
+  }
+  out.print(F("max_screen_us,"));
+  out.print(renderStats.maxScreenMicros);
+  out.println(',');
+  out.print(F("max_update_us,"));
+  out.print(renderStats.maxUpdateMicros);
+  out.println(',');
+
+  name = kScreenNames;
+  out.println(F("screen,calls,us"));
+  for (uint8_t i = 0; i < S3UI_STAT_SCREENS; i++) {
+    out.print((const __FlashStringHelper *)name);
+    out.print(',');
+    out.print(renderStats.screenCalls[i]);
+    out.print(',');
+    out.println(renderStats.screenMicros[i]);
+    name += strlen_P(name) + 1;
+  }
+}
+#endif
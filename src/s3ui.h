@@ -13,7 +13,66 @@
 
 #include "Adafruit_GFX.h"
 #include "Arduino.h"
-#include <vector>
+#include "s3uiAnimation.h"
+#include "s3uiFramebuffer.h"
+#include "s3uiGlyphCache.h"
+#include "s3uiLogRecord.h"
+#include "s3uiLogSpill.h"
+#include "s3uiLogStore.h"
+#include "s3uiQueue.h"
+#include "s3uiStats.h"
+#include "s3uiText.h"
+
+#ifndef S3UI_MAX_DIRTY_PAGES
+/** @brief Display pages tracked individually by the dirty region; lower rows fold into the last page. */
+#define S3UI_MAX_DIRTY_PAGES 16
+#endif
+
+/** @brief Returned by s3ui::msUntilNextUpdate() when nothing is scheduled. */
+#define S3UI_NO_DEADLINE 0xFFFFFFFFUL
+
+#ifndef S3UI_ITEM_TEXT_MAX
+/** @brief Size of each buffer virtual list (s3uiItemProvider) items are formatted into. */
+#define S3UI_ITEM_TEXT_MAX 32
+#endif
+
+#ifndef S3UI_MAX_TRACKED_ROWS
+/** @brief Option rows fingerprinted individually by repeated screen calls; lower rows share the last slot. */
+#define S3UI_MAX_TRACKED_ROWS 8
+#endif
+#if S3UI_MAX_TRACKED_ROWS < 1 || S3UI_MAX_TRACKED_ROWS > 31
+#error "S3UI_MAX_TRACKED_ROWS must be between 1 and 31"
+#endif
+
+#ifndef S3UI_MAX_STATUS_FIELDS
+/** @brief Status fields that can be registered with s3ui::addStatusField() (left of the battery text). */
+#define S3UI_MAX_STATUS_FIELDS 2
+#endif
+
+#ifndef S3UI_STATUS_TEXT_MAX
+/** @brief Buffer size of the battery text and each status field; longer texts are truncated. */
+#define S3UI_STATUS_TEXT_MAX 10
+#endif
+
+#ifndef S3UI_TITLE_TEXT_MAX
+/** @brief Buffer size of the title; longer titles are truncated. */
+#define S3UI_TITLE_TEXT_MAX 32
+#endif
+
+#if defined(S3UI_FIXED_WIDTH) != defined(S3UI_FIXED_HEIGHT)
+#error "Define both S3UI_FIXED_WIDTH and S3UI_FIXED_HEIGHT, or neither"
+#endif
+
+/** @brief Height in pixels of one display page (PCF8814, SSD1306 and similar controllers). */
+#define S3UI_PAGE_HEIGHT 8
+
+/** @brief Axis-aligned rectangle in display coordinates. */
+struct s3uiRect {
+  int16_t x; ///< Left edge in pixels.
+  int16_t y; ///< Top edge in pixels.
+  int16_t w; ///< Width in pixels.
+  int16_t h; ///< Height in pixels.
+};
 
 /**
  * @class s3ui
@@ -24,67 +83,485 @@
  * - Configure fonts and sizes using setTitleFont()/setContentFont() etc.
  * - Render screens such as optionSelectScreen(), runningActivityScreen(), activityLiveLogScreen().
  * - Call update() from your loop() to advance animations and refresh the log.
+ *
+ * Text parameters are s3uiText views and option arrays are s3uiTextList, so String, C strings, F() strings,
+ * (pointer, length) views and PROGMEM tables are all rendered in place without building heap Strings.
  */
 class s3ui {
 private:
   /** @brief Target graphics context (must be set via setDisplay()). */
   Adafruit_GFX *gfx;
+#ifdef S3UI_FIXED_WIDTH
+  // Display size fixed at build time (S3UI_FIXED_WIDTH/S3UI_FIXED_HEIGHT): layout math folds into constants
+  static constexpr uint16_t displayWidth = S3UI_FIXED_WIDTH;   ///< Physical display width in pixels.
+  static constexpr uint16_t displayHeight = S3UI_FIXED_HEIGHT; ///< Physical display height in pixels.
+#else
   /** @brief Physical display width in pixels. */
   uint16_t displayWidth;
   /** @brief Physical display height in pixels. */
   uint16_t displayHeight;
+#endif
+  /** @brief Optional direct renderer into the display buffer (bypasses gfx drawing when attached). */
+  s3uiFramebuffer framebuffer;
 
   // Animation state for RunningActivity (non-blocking)
   bool animationActive;            ///< True while an animated activity is active.
-  const uint8_t **animationFrames; ///< Frame pointers for the current animation.
-  uint8_t currentFrame;            ///< Current frame index.
-  uint8_t totalFrames;             ///< Total number of frames in the animation.
+  const uint8_t **animationFrames; ///< Frame pointers for the current animation (raw frames).
+  const uint8_t *encodedAnimation; ///< Compressed animation being played (nullptr for raw frames).
+  const uint8_t *encodedReadPos;   ///< Start of the next frame to decode in encodedAnimation.
+  uint8_t *animationScratch;       ///< Caller-provided buffer holding the decoded frame on screen.
+  uint16_t currentFrame;           ///< Current frame index.
+  uint16_t totalFrames;            ///< Total number of frames in the animation.
   uint16_t frameDelay;             ///< Milliseconds per frame.
-  unsigned long lastFrameTime;     ///< Millis timestamp of last frame switch.
+  unsigned long nextFrameTime;     ///< Millis deadline of the next frame switch.
   uint16_t bitmapWidth;            ///< Width of the animated bitmap.
   uint16_t bitmapHeight;           ///< Height of the animated bitmap.
-  String captionText;              ///< Caption to render under the bitmap.
+  int16_t activityBitmapX;         ///< Left edge of the bitmap as laid out by showRunningActivity().
+  int16_t activityBitmapY;         ///< Top edge of the bitmap as laid out by showRunningActivity().
+  int16_t activityClipBottom;      ///< First row below the bitmap area owned by the frames (content box or caption).
 
   // Logging state for ActivityLiveLog
-  bool logActive;               ///< True while the live log screen is active.
-  std::vector<String> logLines; ///< Stored log lines for display.
+  bool logActive;        ///< True while the live log screen is active.
+  s3uiLogStore logStore; ///< Stored log lines and their cached wrapped display-line counts.
+  bool logLayoutValid;   ///< False when the cached display-line counts must be recomputed.
+  bool logDirty;         ///< True when the log changed since it was last rendered.
+  s3uiLogLevel logMinLevel;               ///< Records below this level are dropped; access through logLevel().
+  bool logTimestamps;                     ///< True to show record timestamps as mm:ss.
+  s3uiText logPrefix[S3UI_LOG_LEVELS];    ///< Text shown before record messages, per level.
+  s3uiQueue logQueue;                     ///< Records queued by other tasks and interrupts, drained by update().
+  bool logFollowTail;                     ///< True to keep following new entries while the view is at the end.
+  bool logAtTail;                         ///< True while the view shows the newest entries.
+  uint8_t logTopLine;                     ///< Wrapped line of the top entry shown first while scrolled back.
+  uint32_t logTopSequence;                ///< logFirstSequence() + index of the top entry while scrolled back.
+  s3uiLogSpill logSpill;                  ///< Files older entries are written to (see setLogSpill()).
+  uint32_t logSpillNext;                  ///< Log store sequence number of the next entry to write to the files.
+  uint32_t logSpillBase;                  ///< First spilled entry shown in the log (earlier ones were cleared).
+  uint32_t logSpillLost;                  ///< Entries evicted from RAM before they were written.
+  uint16_t logSpillBatch;                 ///< Unwritten entries that make update() write a batch.
+
+  // Option list shown by showOptionSelect()/showOptionValueSet(), kept for moveOptionCursor()
+  /** @brief Kind of option list on screen. */
+  enum OptionScreen : uint8_t { OPTION_NONE, OPTION_SELECT, OPTION_VALUE_SET };
+  OptionScreen optionScreen; ///< Option list on screen (OPTION_NONE after any other screen or clear).
+  s3uiTextList listNames;    ///< Option names of the list on screen.
+  s3uiTextList listValues;   ///< Option values of the list on screen (value lists only).
+  uint16_t optionCount;      ///< Number of options in the list on screen.
+  uint16_t optionCursor;     ///< Selected option of the list on screen.
+  bool optionEditing;        ///< True while the selected value is being edited (value lists only).
+  char itemBuffer[2][S3UI_ITEM_TEXT_MAX]; ///< Scratch for provider items (0: names/labels, 1: values).
+  bool optionOverflow;       ///< True if list rows on screen were drawn outside the content box.
+
+  // Smooth scrolling of option lists (see setSmoothScroll())
+  uint16_t scrollDuration;      ///< Length of a scroll tween in ms (0 = the window jumps).
+  uint16_t scrollFrameMs;       ///< Ms between tween frames (0 = a frame on every update()).
+  bool scrollActive;            ///< True while a scroll tween is running.
+  int32_t scrollFrom;           ///< List offset (px scrolled past the first option) at the tween start.
+  int32_t scrollTo;             ///< List offset at the tween end.
+  int16_t thumbFrom;            ///< Slider thumb top at the tween start.
+  int16_t thumbTo;              ///< Slider thumb top at the tween end.
+  unsigned long scrollStart;    ///< Millis timestamp of the tween start.
+  unsigned long nextScrollTime; ///< Millis deadline of the next tween frame.
+
+  // Row clip applied to every drawing primitive while rowClip is set
+  bool rowClip;      ///< True while drawing is restricted to [clipTop, clipBottom).
+  int16_t clipTop;    ///< First row that may be drawn.
+  int16_t clipBottom; ///< Row after the last one that may be drawn.
+
+  // Retained screen state: what the screen methods last rendered, so repeated calls repaint only differences
+  /** @brief Screen drawn by the last screen method. */
+  enum ScreenKind : uint8_t {
+    SCREEN_NONE,
+    SCREEN_OPTION_SELECT,
+    SCREEN_OPTION_VALUE_SET,
+    SCREEN_ACTIVITY,
+    SCREEN_ANIMATION,
+    SCREEN_LOG,
+    SCREEN_CONFIRM
+  };
+  ScreenKind screenKind;    ///< Screen on display (SCREEN_NONE makes the next screen call render everything).
+  uint32_t contentHash;     ///< Fingerprint of the content inputs on screen (activity, log and confirm screens).
+  bool trackOverflow;       ///< True while content is drawn; markDirty() then maintains contentOverflow.
+  bool contentOverflow;     ///< True if content was drawn outside the content box (only a full repaint is exact).
+  uint16_t rowHashTop;      ///< Option index of the first fingerprinted row.
+  uint32_t rowHash[S3UI_MAX_TRACKED_ROWS]; ///< Fingerprints of the visible option rows.
+  uint8_t confirmSelected;  ///< Selected button of the confirm screen on display.
+  uint8_t confirmButtons;   ///< Buttons drawn by the last showConfirm().
+  int16_t buttonTop[3];     ///< First row each confirm button (box and label) can touch.
+  int16_t buttonBottom[3];  ///< Last row each confirm button can touch.
+
+  // Title bar elements, kept so each one can be repainted on its own
+  /** @brief Title bar elements; status field n is BAR_FIELDS + n. */
+  enum BarElement : uint8_t { BAR_TITLE, BAR_BATTERY, BAR_FIELDS };
+  char titleText[S3UI_TITLE_TEXT_MAX];                               ///< Title shown in the bar.
+  char statusText[1 + S3UI_MAX_STATUS_FIELDS][S3UI_STATUS_TEXT_MAX]; ///< Battery text, then the status fields.
+  uint8_t statusWidth[S3UI_MAX_STATUS_FIELDS];                       ///< Reserved width of each status field (px).
+  uint8_t statusFieldCount;                                          ///< Registered status fields.
+  bool barVisible;                                                   ///< True while the title bar is on screen.
+  int16_t barInkLeft[BAR_FIELDS + S3UI_MAX_STATUS_FIELDS];  ///< First column each element touched when drawn.
+  int16_t barInkRight[BAR_FIELDS + S3UI_MAX_STATUS_FIELDS]; ///< Last column each element touched (< left: none).
+
+  /** @brief Geometry of an option list for one cursor position. */
+  struct OptionLayout {
+    int16_t rowTop;           ///< Top of the first visible row (shifted up when the last option is selected).
+    uint8_t rowHeight;        ///< Height of one option row.
+    uint16_t topIndex;        ///< Index of the first visible option.
+    uint8_t visibleCount;     ///< Rows drawn, including a partially visible one.
+    int16_t sliderX;          ///< Left edge of the slider box.
+    uint16_t sliderTop;       ///< Top of the slider box.
+    uint16_t sliderBoxHeight; ///< Height of the slider box.
+    uint16_t thumbTop;        ///< Top of the slider thumb.
+    uint8_t thumbHeight;      ///< Height of the slider thumb.
+  };
+
+  // Change tracking
+  bool needsDisplay;                           ///< True when something was drawn since the last update().
+  int16_t dirtyX0, dirtyY0, dirtyX1, dirtyY1;  ///< Inclusive bounds of the dirty region (empty if dirtyX1 < dirtyX0).
+  int16_t dirtyPageX0[S3UI_MAX_DIRTY_PAGES];   ///< Leftmost dirty column per page.
+  int16_t dirtyPageX1[S3UI_MAX_DIRTY_PAGES];   ///< Rightmost dirty column per page (< dirtyPageX0 if clean).
+
+#ifdef S3UI_RENDER_STATS
+  // Render instrumentation (S3UI_RENDER_STATS builds only)
+  s3uiRenderStats renderStats; ///< Counters reported by getRenderStats().
+  uint32_t logAllocsSeen;      ///< logStore.allocations() already added to renderStats.
+  uint32_t logAllocBytesSeen;  ///< logStore.allocatedBytes() already added to renderStats.
+  bool statsTiming;            ///< True while a timed call runs; screen calls nested in it are not timed again.
+
+  /** @brief Times one screen method call or update() and stores its counters in renderStats.last. */
+  class StatScope {
+  public:
+    /**
+     * @param owner Instance being measured.
+     * @param screen Screen type (s3uiStatScreen), or S3UI_STAT_SCREENS for update().
+     */
+    StatScope(s3ui &owner, uint8_t screen);
+    ~StatScope();
+
+  private:
+    s3ui &ui;                 ///< Instance being measured.
+    s3uiRenderCounters mark;  ///< Cumulative counters when the call started.
+    unsigned long start;      ///< micros() when the call started.
+    uint8_t screen;           ///< Screen type, or S3UI_STAT_SCREENS for update().
+    bool active;              ///< False for nested calls.
+  };
+  /** @brief Add log storage allocations made since the last call to the counters. */
+  void countLogAllocations();
+#endif
+
+  /** @brief Metrics of a configured font, built once when the font is set. */
+  struct FontMetrics {
+    uint16_t first;   ///< First character covered by the font.
+    uint16_t last;    ///< Last character covered by the font.
+    uint8_t *advance; ///< xAdvance per character in [first, last] at text size 1 (nullptr if no font).
+    int16_t top;      ///< Max ascent at the text size: topmost glyph row relative to the baseline (usually < 0).
+    int16_t bottom;   ///< Max descent at the text size: bottommost glyph row relative to the baseline.
+    int16_t left;     ///< Leftmost glyph column relative to the cursor at the text size (<= 0).
+    int16_t right;    ///< Farthest a glyph reaches past its advance at the text size (>= 0).
+  };
+
+  /** @brief Which configured font (and text size) text is printed with; also the glyph cache font number. */
+  enum FontRole : uint8_t { FONT_TITLE, FONT_CONTENT };
 
   // Font configuration
   const GFXfont *titleFont;   ///< Font used for the title and battery.
   const GFXfont *contentFont; ///< Font used for content areas.
-  uint8_t titleSize;          ///< Logical scale factor applied to title metrics.
-  uint8_t contentSize;        ///< Logical scale factor applied to content metrics.
-  uint16_t titleFontHeight;   ///< Cached title font height (yAdvance).
-  uint16_t contentFontHeight; ///< Cached content font height (yAdvance).
-
-  // Constants that define how the UI looks
-  const uint8_t titleMargin = 2;         ///< Vertical margin under the title bar (px).
-  const uint8_t contentBoxThickness = 2; ///< Border thickness for the content box (px).
-  const uint8_t sliderWidth = 3;         ///< Slider width for lists (px).
-  const uint8_t sliderPadding = 1;       ///< Padding around slider (px).
-  const uint8_t optionPadding = 1;       ///< Padding inside option rows (px).
+  uint8_t titleSize;          ///< Scale factor title text is measured and drawn at.
+  uint8_t contentSize;        ///< Scale factor content text is measured and drawn at.
+  uint16_t titleFontHeight;   ///< Cached title line height (yAdvance times titleSize).
+  uint16_t contentFontHeight; ///< Cached content line height (yAdvance times contentSize).
+  FontMetrics titleMetrics;   ///< Advance table and glyph bounds of the title font.
+  FontMetrics contentMetrics; ///< Advance table and glyph bounds of the content font.
+  s3uiGlyphCache glyphCache;  ///< Glyphs rasterized at their text size (see setGlyphCache()).
+
+  // Constants that define how the UI looks (compile-time, so they take no RAM and fold into the layout math)
+  static constexpr uint8_t titleMargin = 2;         ///< Vertical margin under the title bar (px).
+  static constexpr uint8_t contentBoxThickness = 2; ///< Border thickness for the content box (px).
+  static constexpr uint8_t sliderWidth = 3;         ///< Slider width for lists (px).
+  static constexpr uint8_t sliderPadding = 1;       ///< Padding around slider (px).
+  static constexpr uint8_t optionPadding = 1;       ///< Padding inside option rows (px).
+
+  // Drawing primitives; each draws through the framebuffer (or gfx) and records the touched area in the dirty region
+  /** @brief Add a rectangle (clipped to the display) to the dirty region. */
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+  /** @brief Fill the whole display with color 0. */
+  void clearScreen();
+  /** @brief Fill a rectangle. */
+  void fillArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  /** @brief Draw a 1px rectangle outline. */
+  void outlineArea(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  /** @brief Draw the set bits of a 1-bit bitmap with color 1. */
+  void blitBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint16_t w, uint16_t h);
+  /** @brief Set and clear pixels of an 8-pixel run of one row (MSB = pixel x); other pixels are untouched. */
+  void plotBits(int16_t x, int16_t y, uint8_t setBits, uint8_t clearBits);
+  /**
+   * @brief Turn the displayed animation frame into another by repainting only the pixels that differ.
+   * @param from Frame currently on screen.
+   * @param to Frame to show.
+   */
+  void drawFrameDelta(const uint8_t *from, const uint8_t *to);
+  /**
+   * @brief Repaint one byte (8 pixels) of the animation bitmap that changed between frames.
+   * @param row Bitmap row.
+   * @param col Byte index within the row.
+   * @param diff Pixels that changed (XOR of old and new frame byte).
+   * @param next New frame byte.
+   */
+  void drawFrameByte(uint16_t row, uint16_t col, uint8_t diff, uint8_t next);
+  /** @brief Decode the frame at currentFrame of the compressed animation and repaint what changed. */
+  void decodeNextFrame();
+  /** @brief Advance the animation by steps frames (looping) and repaint the result. */
+  void advanceAnimation(uint32_t steps);
+  /** @brief Layout of the option list on screen with the cursor at cursorPos. */
+  OptionLayout optionLayout(uint16_t cursorPos);
+  /** @brief Item index of list, fetched into itemBuffer[slot] if the list is a provider. */
+  s3uiText listItem(const s3uiTextList &list, uint16_t index, uint8_t slot) {
+    return list.at(index, itemBuffer[slot], S3UI_ITEM_TEXT_MAX);
+  }
+  /** @brief Draw the slider and every visible row of the option list on screen. */
+  void drawOptionList(const OptionLayout &layout);
+  /** @brief Draw the slider box and thumb of an option list. */
+  void drawOptionSlider(const OptionLayout &layout);
+  /** @brief Draw a slider box and its 1-pixel thumb (option lists and the log). */
+  void drawSlider(int16_t x, int16_t top, uint16_t boxHeight, int16_t thumbTop, uint16_t thumbHeight);
+  /** @brief Draw one visible row (0 = topmost) of the option list on screen. */
+  void drawOptionRow(const OptionLayout &layout, uint8_t row);
+  /** @brief First and last pixel row that drawing a visible option row can touch. */
+  void optionRowExtent(const OptionLayout &layout, uint8_t row, int16_t &top, int16_t &bottom);
+  /** @brief True if everything a visible option row draws lies inside the content box. */
+  bool optionRowInside(const OptionLayout &layout, uint8_t row);
+  /** @brief True if drawing the list with this layout (unclipped) reaches out of the content box. */
+  bool optionListOverflows(const OptionLayout &layout);
+  /** @brief Pixels the list is scrolled past the top of its first option. */
+  int32_t optionListOffset(const OptionLayout &layout);
+  /** @brief Eased list offset and thumb position of the running scroll tween at time now. */
+  void scrollPosition(unsigned long now, int32_t &offset, int16_t &thumbTop);
+  /**
+   * @brief Repaint the option list scrolled to an arbitrary pixel offset, clipped to the content box.
+   * @param offset Pixels scrolled past the top of the first option.
+   * @param thumbTop Top of the slider thumb.
+   */
+  void drawScrolledList(int32_t offset, int16_t thumbTop);
+  /** @brief Repaint the visible rows of the option list whose bits are set (bit r = row r, row 31 and below share
+   *  bit 31) by clearing their bands and replaying every row that reaches into them. */
+  void repaintOptionRows(const OptionLayout &layout, uint32_t rows);
+  /** @brief Bit of a visible row in repaintOptionRows() masks. */
+  static uint32_t rowBit(uint8_t row) { return 1UL << (row < 31 ? row : 31); }
+  /** @brief Fingerprint the visible rows of the option list on screen (rows past the last slot share it). */
+  void optionRowHashes(const OptionLayout &layout, uint32_t *hashes);
+  /**
+   * @brief Bring the option list on screen up to date with new inputs, repainting only rows that changed.
+   * @return False (possibly after drawing) when the screen must be rendered from scratch instead.
+   */
+  bool updateOptionList(const s3uiTextList &names, const s3uiTextList &values, uint16_t numOptions,
+                        uint16_t cursorPos, bool editing);
+  /** @brief Remember a freshly rendered option screen for the next call. */
+  void retainOptionScreen(ScreenKind kind);
+  /**
+   * @brief Start a non-list screen method: decide how much of the screen must be drawn again.
+   * @param kind Screen being drawn.
+   * @param title Title text.
+   * @param batteryPercentage Battery text.
+   * @param content Fingerprint of the content inputs.
+   * @return False if the content on screen is already up to date (the title bar was repainted if it changed).
+   *         True if the caller must draw the content: the content box was cleared, or the whole screen was
+   *         cleared and the title and border drawn. Call endContent() afterwards.
+   */
+  bool beginScreen(ScreenKind kind, const s3uiText &title, const s3uiText &batteryPercentage, uint32_t content);
+  /** @brief Stop tracking content drawing started by beginScreen(). */
+  void endContent() { trackOverflow = false; }
+  /** @brief Repaint the title or battery if they changed. @return False if only a full repaint is exact. */
+  bool updateTitleBar(const s3uiText &title, const s3uiText &batteryPercentage);
+  /** @brief Stored text of a title bar element. */
+  s3uiText barText(uint8_t element) const {
+    return element == BAR_TITLE ? s3uiText(titleText) : s3uiText(statusText[element - BAR_BATTERY]);
+  }
+  /** @brief True if text (truncated like stored texts) equals the stored text of a title bar element. */
+  bool barTextEquals(uint8_t element, const s3uiText &text) const;
+  /** @brief Copy text into the buffer of a title bar element, truncating it to the buffer. */
+  void storeBarText(uint8_t element, const s3uiText &text);
+  /** @brief Store a title bar element and repaint it in place if the bar is on screen. */
+  void setBarText(uint8_t element, const s3uiText &text);
+  /** @brief Cursor x of every title bar element (title, battery, then status fields right to left). */
+  void layoutStatusBar(int16_t *x);
+  /** @brief Columns an element drawn at cursor x touches. */
+  void barInk(uint8_t element, int16_t x, int16_t &left, int16_t &right);
+  /** @brief Draw every title bar element (no clearing) and remember where. */
+  void drawStatusBar();
+  /**
+   * @brief Repaint title bar elements in place: clear the columns of the old and new placement of every element
+   *        that changed or moved, then replay each element reaching into them.
+   * @param changed Bit e set if the text of element e changed.
+   */
+  void repaintStatusBar(uint32_t changed);
+  /** @brief Mix text (characters and length) into an FNV-1a fingerprint. */
+  static uint32_t hashText(uint32_t hash, const s3uiText &text);
+  /** @brief Mix a 32-bit value into an FNV-1a fingerprint. */
+  static uint32_t hashValue(uint32_t hash, uint32_t value);
+  /** @brief Remember the rows a confirm button (box and label) touches. */
+  void recordButton(uint8_t index, int16_t top, int16_t height, int16_t baselineY);
+  /** @brief Move the confirm selection by repainting the bands of the old and new selected buttons. */
+  void repaintConfirmButtons(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const s3uiText &question,
+                             const s3uiTextList &options, uint8_t numOptions, uint8_t selectedIndex);
+  /** @brief Fill the inside of the content box with color 0. */
+  void clearContent();
+  /** @brief Restrict drawing to rows [top, bottom). */
+  void setRowClip(int16_t top, int16_t bottom);
+  /** @brief Allow drawing on every row again. */
+  void clearRowClip();
+  /** @brief Print text like printText() on the Adafruit_GFX path, plotting only pixels inside the row clip. */
+  void printTextClipped(const GFXfont *font, uint8_t size, int16_t &cursorX, int16_t &cursorY, const s3uiText &text,
+                        uint16_t color);
+  /**
+   * @brief Print text from the glyph cache: cached rows are blitted into the framebuffer, or sent to
+   *        Adafruit_GFX as one line or rectangle per run of set pixels, clipped to the row clip.
+   * @note Places glyphs exactly like Adafruit_GFX::write() at the role's text size.
+   */
+  void printTextCached(FontRole role, int16_t &cursorX, int16_t &cursorY, const s3uiText &text, uint16_t color);
+  /**
+   * @brief Print characters with their baseline at (x, y).
+   * @param role Font and text size to print with.
+   * @param x Cursor x position.
+   * @param y Baseline y position; at text sizes above 1 it is the last of the rows the baseline row becomes,
+   *        so text stays inside the same line box at every size.
+   * @param text Characters to print, straight from the caller's buffer (RAM or flash).
+   * @param color Text color.
+   * @return Cursor x position after the last character, for printing consecutive runs.
+   */
+  int16_t printText(FontRole role, int16_t x, int16_t y, const s3uiText &text, uint16_t color);
+  /**
+   * @brief (Re)build the advance table and glyph bounds for a font.
+   * @param metrics Metrics to fill; any previous table is released.
+   * @param font Font to read (may live in PROGMEM).
+   * @param size Text size the glyph bounds are scaled to.
+   */
+  static void buildMetrics(FontMetrics &metrics, const GFXfont *font, uint8_t size);
+  /** @brief Recompute the glyph bounds of a font at a text size, keeping the advance table. */
+  static void measureGlyphs(FontMetrics &metrics, const GFXfont *font, uint8_t size);
+  /** @brief Line heights and glyph cache after a font or text size changed. */
+  void applyFontSizes();
+  /** @brief Metrics matching a configured font pointer (title or content), or nullptr. */
+  const FontMetrics *metricsFor(const GFXfont *font) const;
 
   // Private helper methods
   /**
    * @brief Compute text width using the given font and size.
-   * @param str String to measure.
+   * @note Uses the per-font advance tables and does not touch the GFX text state.
+   * @param str Text to measure.
    * @param font Font to use; must not be nullptr.
    * @param size Logical scale factor (1 = native font metrics).
    * @return Width in pixels.
    */
-  int16_t strWidth(const String &str, const GFXfont *font, uint8_t size);
+  int16_t strWidth(const s3uiText &str, const GFXfont *font, uint8_t size);
+  /** @brief One wrapped display line: a span of the source text and its measured width. */
+  struct TextSpan {
+    uint16_t offset; ///< Index of the first character in the source text.
+    uint16_t length; ///< Number of characters on the line.
+    int16_t width;   ///< Line width in pixels with the content font and size.
+  };
+  /** @brief Characters that end a segment in nextWrappedLine() (bit flags). */
+  enum WrapBreaks : uint8_t {
+    WrapNoBreaks = 0, ///< Wrap the text as one segment.
+    WrapBreakLF = 1,  ///< '\n' starts a new segment.
+    WrapBreakCR = 2   ///< '\r' starts a new segment.
+  };
+  /** @brief True if c ends a segment under the given break flags. */
+  static bool isWrapBreak(char c, uint8_t breaks) {
+    return (c == '\n' && (breaks & WrapBreakLF)) || (c == '\r' && (breaks & WrapBreakCR));
+  }
+  /**
+   * @brief Wrap engine shared by captions, the live log and the confirm question.
+   *
+   * Scans text once with a running width (content font and size) and returns the next display line as a
+   * span, without creating String objects. Lines prefer to break after the last space that fits; a word
+   * wider than maxWidth is split at the character limit. Empty segments produce no line.
+   * @param text Source characters.
+   * @param pos In: scan position (start with 0). Out: position after the returned line.
+   * @param maxWidth Maximum line width in pixels.
+   * @param breaks WrapBreaks flags selecting segment separators.
+   * @param line Receives the line span.
+   * @return False when no lines remain.
+   */
+  bool nextWrappedLine(const s3uiText &text, uint16_t &pos, uint16_t maxWidth, uint8_t breaks, TextSpan &line);
+  /**
+   * @brief Width available to log text inside the log window border.
+   * @return Wrap width in pixels for the current display and layout constants.
+   */
+  uint16_t logWrapWidth();
+  /**
+   * @brief Count the display lines a log entry occupies after '\n' splitting and word wrapping.
+   * @param line Log entry text.
+   * @return Number of wrapped display lines (empty segments are skipped), at most s3uiLogStore::kMaxLines.
+   */
+  uint8_t countLogDisplayLines(const s3uiText &line);
+  /**
+   * @brief Text of an entry in RAM as displayed.
+   * @param index Log store index (0 = oldest in RAM).
+   * @param buffer S3UI_LOG_RECORD_TEXT_MAX bytes a record is formatted into (timestamp, level prefix, message).
+   * @return View of the stored text, or of buffer for records.
+   */
+  s3uiText logStoredText(uint16_t index, char *buffer);
+  /**
+   * @brief Number of leading log entries that are only in the spill files (0 without spilling).
+   *
+   * The log shows these first, then the entries in RAM. Also counts RAM entries evicted before they were written.
+   */
+  uint32_t logSpilledOnly();
+  /** @brief Entries of the log: spilled-only ones followed by those in RAM. */
+  uint32_t logEntryCount() { return logSpilledOnly() + logStore.count(); }
+  /** @brief Sequence number of log entry 0; entry i has logFirstSequence() + i while appends evict entries. */
+  uint32_t logFirstSequence() { return logSpill.attached() ? logSpillBase : logStore.firstSequence(); }
   /**
-   * @brief Determine a wrapping point that fits within a maximum width.
-   * @param str Source string.
-   * @param startIdx Index to begin measuring.
-   * @param maxWidth Maximum allowed width for the chunk.
-   * @return Number of characters that fit, preferring a break at whitespace.
+   * @brief Text of a log entry as displayed, read back from the spill files if needed.
+   * @param index Log entry index (0 = oldest).
+   * @param buffer S3UI_LOG_RECORD_TEXT_MAX bytes for formatting records.
+   * @return View of the stored text, of buffer, or of the spill read buffer (valid until the next call).
    */
-  uint16_t findWrapPoint(const String &str, uint16_t startIdx, uint16_t maxWidth);
+  s3uiText logEntryText(uint32_t index, char *buffer);
+  /** @brief Display lines of a log entry, measuring an unmeasured record in RAM. */
+  uint8_t logEntryLines(uint32_t index, char *buffer);
+  /** @brief Display line a log entry starts at; O(log n). */
+  uint32_t logLinesBefore(uint32_t index);
+  /** @brief Display lines of the whole log. */
+  uint32_t logTotalLines() { return logLinesBefore(logEntryCount()); }
+  /** @brief Log entry shown at a display line and the line it starts at; O(log n). */
+  uint32_t logEntryAtLine(uint32_t line, uint32_t &entryStart);
+  /** @brief Entries in RAM not written to the spill files yet. */
+  uint16_t logSpillPending();
+  /**
+   * @brief Write the unwritten entries in RAM to the spill files as one batch.
+   * @param all False to wait until setLogSpill()'s batch size has accumulated.
+   * @return False if a write failed (spilling then stops).
+   */
+  bool spillLog(bool all);
+  /** @brief Move records queued by queueLogRecord() into the log (at most one queue's worth per call). */
+  void drainLogQueue();
+  /** @brief setLogLevel()'s level, read safely from queueLogRecord() on other tasks and interrupts. */
+  s3uiLogLevel logLevel() const;
+  /** @brief Recompute the cached display-line counts of all text entries after a layout change. */
+  void layoutLog();
+  /** @brief Number of display lines that fit in the log window. */
+  uint8_t logVisibleLines();
+  /**
+   * @brief First entry of the tail view: the newest whole entries that fit, measuring records on the way.
+   * @param visible Display lines in the log window.
+   * @param recordText S3UI_LOG_RECORD_TEXT_MAX bytes for formatting records.
+   */
+  uint32_t logTailStart(uint8_t visible, char *recordText);
+  /**
+   * @brief Entry and wrapped line shown at the top of the log window.
+   * @param visible Display lines in the log window.
+   * @param recordText S3UI_LOG_RECORD_TEXT_MAX bytes for formatting records.
+   * @param index Receives the logical index of the top entry.
+   * @param line Receives the wrapped line of that entry shown first.
+   */
+  void logViewTop(uint8_t visible, char *recordText, uint32_t &index, uint8_t &line);
 
 public:
   /** @brief Construct a new, uninitialized s3ui facade. */
   s3ui();
+  ~s3ui();
+
+  s3ui(const s3ui &) = delete;
+  s3ui &operator=(const s3ui &) = delete;
 
   // Display initialization - allows any Adafruit_GFX compatible display
   /**
@@ -92,18 +569,54 @@ public:
    * @param display Pointer to an Adafruit_GFX-compatible instance.
    * @param width Display width in pixels.
    * @param height Display height in pixels.
+   * @return True if the display was bound; false for a null display or, with S3UI_FIXED_WIDTH/S3UI_FIXED_HEIGHT
+   *         defined, for a size other than the build-time one (nothing is drawn until a matching display is set).
    */
-  void setDisplay(Adafruit_GFX *display, uint16_t width, uint16_t height);
+  bool setDisplay(Adafruit_GFX *display, uint16_t width, uint16_t height);
+
+  /**
+   * @brief Render directly into the display's 1-bpp buffer instead of through per-pixel gfx calls.
+   * @param buffer The display buffer (e.g. GFXcanvas1::getBuffer(), Adafruit_SSD1306::getBuffer()); nullptr
+   *        returns to drawing through gfx.
+   * @param layout Buffer memory layout: S3UI_LAYOUT_HORIZONTAL for GFXcanvas1-style rows, S3UI_LAYOUT_VERTICAL
+   *        for 8-row pages (SSD1306, PCF8814).
+   * @note The buffer must cover the setDisplay() dimensions with rotation 0. Output is pixel-identical to the
+   *       gfx path; the caller still pushes the buffer with the display's own display() call.
+   */
+  void setFramebuffer(uint8_t *buffer, s3uiBufferLayout layout = S3UI_LAYOUT_HORIZONTAL);
+  /**
+   * @brief Continue rendering into another buffer that already holds the image on screen (double buffering).
+   * @param buffer Buffer of the same size and layout as the one given to setFramebuffer().
+   * @note Unlike setFramebuffer() the screen state is kept, so later calls still repaint only what changed.
+   *       Does nothing unless a framebuffer is attached.
+   */
+  void swapFramebuffer(uint8_t *buffer);
 
   // Font configuration methods
   /** @brief Set the font used for the title and battery indicator. */
   void setTitleFont(const GFXfont *font);
   /** @brief Set the font used for content areas (lists, captions, logs). */
   void setContentFont(const GFXfont *font);
-  /** @brief Set the logical title text size used for layout calculations. */
+  /**
+   * @brief Set the title text size: title glyphs are drawn size times larger, as by Adafruit_GFX::setTextSize(),
+   *        and the title bar grows with them (0 is taken as 1).
+   */
   void setTitleSize(uint8_t size);
-  /** @brief Set the logical content text size used for layout calculations. */
+  /** @brief Set the content text size: content glyphs, line heights and wrapping scale with it (0 is taken as 1). */
   void setContentSize(uint8_t size);
+  /**
+   * @brief Keep recently printed glyphs pre-rasterized at their text size, so text is printed by row blits.
+   * @param bytes Cache buffer size, allocated once (0 frees the cache and prints through the font bits again).
+   *        It holds getGlyphCacheStats().slots glyphs, depending on the largest glyph of both fonts at their
+   *        sizes; around 1 KB keeps the characters of a typical screen at size 2.
+   * @return False if the buffer could not be allocated.
+   * @note Output is pixel for pixel the same with or without the cache.
+   */
+  bool setGlyphCache(uint16_t bytes);
+  /** @brief Glyph cache hits, misses, evictions and slots. */
+  const s3uiGlyphCacheStats &getGlyphCacheStats() const { return glyphCache.getStats(); }
+  /** @brief Zero the glyph cache hit, miss and eviction counters. */
+  void resetGlyphCacheStats() { glyphCache.resetStats(); }
 
   // Element rendering methods
   // These methods do not clear the screen by themselves; caller must do so if needed.
@@ -115,41 +628,63 @@ public:
    * @param batteryPercentage Battery status text (e.g. "84%") aligned to top-right.
    * @note This method does not clear the screen when called.
    */
-  void showTitleAndBorder(const String &title, const String &batteryPercentage);
+  void showTitleAndBorder(const s3uiText &title, const s3uiText &batteryPercentage);
 
   // OptionSelect: Display a list of selectable options with cursor
   /**
    * @brief Render selectable options list inside the content box.
-   * @param options Array of option strings.
-   * @param numOptions Number of entries in options (max 256).
+   * @param options Array of option strings, or an s3uiItemProvider for a virtual list.
+   * @param numOptions Number of entries in options.
    * @param cursorPos Zero-based index of the currently selected option.
-   * @note This method does not clear the screen when called.
+   * @note This method does not clear the screen when called. Only the visible rows are fetched from options.
    */
-  void showOptionSelect(const String *options, uint8_t numOptions, uint8_t cursorPos);
+  void showOptionSelect(const s3uiTextList &options, uint16_t numOptions, uint16_t cursorPos);
 
   // OptionValueSet: Display options with editable values
   /**
    * @brief Render options with right-aligned values; highlights selection and edit state.
-   * @param optionNames Array of option name strings.
-   * @param optionValues Array of value strings for each option.
-   * @param numOptions Number of entries (max 256).
+   * @param optionNames Array of option name strings, or an s3uiItemProvider for a virtual list.
+   * @param optionValues Array of value strings for each option, or an s3uiItemProvider.
+   * @param numOptions Number of entries.
    * @param cursorPos Zero-based index of the selection cursor.
    * @param optionSelected True while editing a value; false while navigating options.
-   * @note This method does not clear the screen when called.
+   * @note This method does not clear the screen when called. Only the visible rows are fetched from the lists.
    */
-  void showOptionValueSet(const String *optionNames, const String *optionValues, uint8_t numOptions, uint8_t cursorPos,
-                          bool optionSelected);
+  void showOptionValueSet(const s3uiTextList &optionNames, const s3uiTextList &optionValues, uint16_t numOptions,
+                          uint16_t cursorPos, bool optionSelected);
+
+  /**
+   * @brief Move the cursor of the option list on screen, repainting as little as possible.
+   * @param cursorPos Zero-based index of the option to select.
+   * @return True if the screen now shows the new cursor position. False (nothing drawn) if no option list
+   *         is on screen, cursorPos is out of range, or rows reach out of the content box (e.g. the window
+   *         shifted to show the last option); render the whole screen again in that case.
+   * @note While the scroll window stays put only the previously and newly selected rows and the slider
+   *       thumb are repainted; when it scrolls the list is repainted but the title bar and border are not.
+   *       The option arrays passed to the screen must still be valid. Any other screen, clear() or
+   *       clearContentBox() ends the list.
+   */
+  bool moveOptionCursor(uint16_t cursorPos);
+
+  /**
+   * @brief Scroll option lists smoothly when moveOptionCursor() changes the visible window.
+   * @param durationMs Length of the scroll animation in ms (0 turns smooth scrolling off).
+   * @param fps Target frame rate of the animation (0 draws a frame on every update()).
+   * @note Frames are drawn by update(), clipped to the content box; msUntilNextUpdate() reports the next one.
+   *       A cursor move during a running scroll retargets it from the current position.
+   */
+  void setSmoothScroll(uint16_t durationMs, uint8_t fps = 30);
 
   // RunningActivity: Display static bitmap with title and caption
   /**
    * @brief Render a centered static bitmap with an optional caption below it.
-   * @param bitmap Pointer to 1-bit bitmap data.
+   * @param bitmap Pointer to 1-bit bitmap data (nullptr reserves the space without drawing).
    * @param bitmapW Bitmap width in pixels.
    * @param bitmapH Bitmap height in pixels.
    * @param caption Caption text; truncated with ellipsis if too wide.
    * @note This method does not clear the screen when called.
    */
-  void showRunningActivity(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const String &caption);
+  void showRunningActivity(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const s3uiText &caption);
 
   // ActivityLiveLog: Display scrolling log of activity
   /**
@@ -167,7 +702,7 @@ public:
    * @param selectedIndex Zero-based index of the selected option.
    * @note This method does not clear the screen when called.
    */
-  void showConfirm(const String &question, const String *options, uint8_t numOptions, uint8_t selectedIndex);
+  void showConfirm(const s3uiText &question, const s3uiTextList &options, uint8_t numOptions, uint8_t selectedIndex);
 
   /**
    * @brief Render a confirmation content with an optional bitmap above the question.
@@ -180,8 +715,8 @@ public:
    * @param selectedIndex Zero-based index of the selected option.
    * @note This method does not clear the screen when called.
    */
-  void showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const String &question,
-                   const String *options, uint8_t numOptions, uint8_t selectedIndex);
+  void showConfirm(const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH, const s3uiText &question,
+                   const s3uiTextList &options, uint8_t numOptions, uint8_t selectedIndex);
 
   // Screen rendering methods
 
@@ -189,27 +724,31 @@ public:
    * @brief Convenience screen: title+border + option list.
    * @param title Title text to show in the top-left.
    * @param batteryPercentage Battery status text (e.g. "84%") aligned to top-right.
-   * @param options Array of option strings.
-   * @param numOptions Number of entries in options (max 256).
+   * @param options Array of option strings, or an s3uiItemProvider for a virtual list.
+   * @param numOptions Number of entries in options.
    * @param cursorPos Zero-based index of the currently selected option.
-   * @note This method clears the screen each time it is called.
+   * @note Calling it again with the same screen on display only repaints what changed: the title bar, the
+   *       option rows whose text differs, the old and new cursor rows and the slider thumb (the list when
+   *       its window scrolls). Unchanged inputs draw nothing, so it can be called on every loop().
    */
-  void optionSelectScreen(const String &title, const String &batteryPercentage, const String *options,
-                          uint8_t numOptions, uint8_t cursorPos);
+  void optionSelectScreen(const s3uiText &title, const s3uiText &batteryPercentage, const s3uiTextList &options,
+                          uint16_t numOptions, uint16_t cursorPos);
 
   /**
    * @brief Convenience screen: title+border + editable options list.
    * @param title Title text to show in the top-left.
    * @param batteryPercentage Battery status text (e.g. "84%") aligned to top-right.
-   * @param optionNames Array of option name strings.
-   * @param optionValues Array of value strings for each option.
-   * @param numOptions Number of entries (max 256).
+   * @param optionNames Array of option name strings, or an s3uiItemProvider for a virtual list.
+   * @param optionValues Array of value strings for each option, or an s3uiItemProvider.
+   * @param numOptions Number of entries.
    * @param cursorPos Zero-based index of the selection cursor.
    * @param optionSelected True while editing a value; false while navigating options.
-   * @note This method clears the screen each time it is called.
+   * @note Like optionSelectScreen(), repeated calls repaint only the title bar, rows whose name, value or
+   *       edit state changed and the slider thumb.
    */
-  void optionValueSetScreen(const String &title, const String &batteryPercentage, const String *optionNames,
-                            const String *optionValues, uint8_t numOptions, uint8_t cursorPos, bool optionSelected);
+  void optionValueSetScreen(const s3uiText &title, const s3uiText &batteryPercentage, const s3uiTextList &optionNames,
+                            const s3uiTextList &optionValues, uint16_t numOptions, uint16_t cursorPos,
+                            bool optionSelected);
 
   /**
    * @brief Convenience screen: title+border + static running activity.
@@ -219,10 +758,11 @@ public:
    * @param bitmapW Bitmap width in pixels.
    * @param bitmapH Bitmap height in pixels.
    * @param caption Caption text to show below the bitmap.
-   * @note This method clears the screen each time it is called.
+   * @note Repeated calls repaint only the title bar if it changed, and the content box if the bitmap (compared
+   *       by address), its size or the caption changed.
    */
-  void runningActivityScreen(const String &title, const String &batteryPercentage, const uint8_t *bitmap,
-                             uint16_t bitmapW, uint16_t bitmapH, const String &caption);
+  void runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *bitmap,
+                             uint16_t bitmapW, uint16_t bitmapH, const s3uiText &caption);
 
   /**
    * @brief Convenience screen: title+border + animated running activity.
@@ -233,20 +773,39 @@ public:
    * @param bitmapW Bitmap width in pixels.
    * @param bitmapH Bitmap height in pixels.
    * @param msPerFrame Milliseconds to display each frame.
-   * @param caption Caption text to show below the bitmap.
-   * @note This method clears the screen each time it is called.
+   * @param caption Caption text to show below the bitmap (drawn once; it need not outlive this call).
+   * @note Frame changes in update() repaint only the bitmap pixels that differ from the previous frame.
+   *       Calling it again with the same frames, timing and caption keeps the animation running and only
+   *       repaints the title bar if it changed; other changes restart the animation in the content box.
+   *       Null bitmaps or numFrames 0 show the caption alone.
    */
-  void runningActivityScreen(const String &title, const String &batteryPercentage, const uint8_t **bitmaps,
+  void runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t **bitmaps,
                              uint8_t numFrames, uint16_t bitmapW, uint16_t bitmapH, uint16_t msPerFrame,
-                             const String &caption);
+                             const s3uiText &caption);
+
+  /**
+   * @brief Convenience screen: title+border + animation stored in the compressed s3uiAnimation format.
+   * @param title Title text to show in the top-left.
+   * @param batteryPercentage Battery status text (e.g. "84%") aligned to top-right.
+   * @param animation Encoded animation (PROGMEM), e.g. generated by extras/s3ui_anim.py.
+   * @param frameBuffer Scratch buffer of S3UI_ANIMATION_FRAME_BYTES(width, height) bytes that holds the decoded
+   *        frame; it must stay valid while the animation runs.
+   * @param msPerFrame Milliseconds to display each frame.
+   * @param caption Caption text to show below the bitmap.
+   * @note update() decodes one frame per tick straight from flash and repaints only the pixels that changed.
+   *       An invalid animation or missing frameBuffer shows the caption alone. Repeated calls behave like the
+   *       raw-frame overload.
+   */
+  void runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *animation,
+                             uint8_t *frameBuffer, uint16_t msPerFrame, const s3uiText &caption);
 
   /**
    * @brief Convenience screen: title+border + live log.
    * @param title Title text to show in the top-left.
    * @param batteryPercentage Battery status text (e.g. "84%") aligned to top-right.
-   * @note This method clears the screen each time it is called.
+   * @note Repeated calls only repaint the title bar if it changed; update() repaints the log.
    */
-  void activityLiveLogScreen(const String &title, const String &batteryPercentage);
+  void activityLiveLogScreen(const s3uiText &title, const s3uiText &batteryPercentage);
 
   /**
    * @brief Convenience screen: title+border + confirm (no bitmap).
@@ -256,10 +815,11 @@ public:
    * @param options Array of option labels (1-3).
    * @param numOptions Number of options (1-3).
    * @param selectedIndex Zero-based index of the selected option.
-   * @note This method clears the screen each time it is called.
+   * @note Repeated calls repaint only the title bar if it changed and the rows of the previously and newly
+   *       selected buttons if only the selection changed; other changes repaint the content box.
    */
-  void confirmScreen(const String &title, const String &batteryPercentage, const String &question,
-                     const String *options, uint8_t numOptions, uint8_t selectedIndex);
+  void confirmScreen(const s3uiText &title, const s3uiText &batteryPercentage, const s3uiText &question,
+                     const s3uiTextList &options, uint8_t numOptions, uint8_t selectedIndex);
 
   /**
    * @brief Convenience screen: title+border + confirm (with optional bitmap).
@@ -272,45 +832,247 @@ public:
    * @param options Array of option labels (1-3).
    * @param numOptions Number of options (1-3).
    * @param selectedIndex Zero-based index of the selected option.
-   * @note This method clears the screen each time it is called.
+   * @note Repeated calls repaint only the title bar if it changed and the rows of the previously and newly
+   *       selected buttons if only the selection changed; other changes repaint the content box.
    */
-  void confirmScreen(const String &title, const String &batteryPercentage, const uint8_t *bitmap, uint16_t bitmapW,
-                     uint16_t bitmapH, const String &question, const String *options, uint8_t numOptions,
+  void confirmScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *bitmap, uint16_t bitmapW,
+                     uint16_t bitmapH, const s3uiText &question, const s3uiTextList &options, uint8_t numOptions,
                      uint8_t selectedIndex);
 
   /**
    * @brief Non-blocking update; advances animations and refreshes live log.
-   * @note Call this from loop() when using animated activity or live log screens.
+   * @return True if anything was drawn since the previous update() (including by screen methods),
+   *         i.e. the caller should push the buffer to the panel with its display() call.
+   * @note Call this from loop() when using animated activity or live log screens. Nothing is
+   *       redrawn unless an animation frame is due or the log changed. Frames follow absolute deadlines
+   *       (start time + n * msPerFrame), so loop jitter does not accumulate and a late call skips frames.
+   */
+  bool update();
+  /**
+   * @brief Time until update() next has work to do, for sleeping between frames.
+   * @return 0 if update() should be called now, milliseconds until the next animation frame is due, or
+   *         S3UI_NO_DEADLINE if nothing is scheduled (no animation or list scroll; call update() after
+   *         appendLogLine() or a screen change). Returns 0 while a spill batch is due (see setLogSpill()).
+   */
+  uint32_t msUntilNextUpdate();
+
+  // Title bar fields
+  /**
+   * @brief Change the title; when a screen is on display only the title is repainted.
+   * @param title New title (truncated to S3UI_TITLE_TEXT_MAX - 1 characters).
+   * @note The next screen method call sets the title it is given.
    */
-  void update();
+  void setTitle(const s3uiText &title);
+  /**
+   * @brief Change the battery text; when a screen is on display only the battery text (and status fields it
+   *        shifts) is repainted.
+   * @param batteryPercentage New battery text (truncated to S3UI_STATUS_TEXT_MAX - 1 characters).
+   * @note The next screen method call sets the battery text it is given.
+   */
+  void setBatteryText(const s3uiText &batteryPercentage);
+  /**
+   * @brief Register a right-aligned status field (RSSI, clock, ...) in the title bar, left of the battery text
+   *        and of the fields registered before it.
+   * @param width Width reserved for the field in pixels, e.g. getTextWidth("-99dBm", true); text is
+   *        right-aligned within it.
+   * @return Field index for setStatusField(), or -1 if S3UI_MAX_STATUS_FIELDS fields are registered.
+   * @note Fields start empty and are drawn by every screen until clearStatusFields().
+   */
+  int8_t addStatusField(uint8_t width);
+  /**
+   * @brief Change the text of a status field; when a screen is on display only that field is repainted.
+   * @param field Index returned by addStatusField().
+   * @param text New text (truncated to S3UI_STATUS_TEXT_MAX - 1 characters).
+   * @return False if field is not registered.
+   */
+  bool setStatusField(uint8_t field, const s3uiText &text);
+  /** @brief Remove all status fields (erasing them from the title bar on display). */
+  void clearStatusFields();
 
   // Utility methods
   /** @brief Clear entire display and stop any active animation. */
   void clear();
   /** @brief Clear only the content area inside the border box. */
   void clearContentBox();
+  /**
+   * @brief Forget what the screen methods drew, so the next screen call renders the whole screen.
+   * @note Call after drawing over a screen yourself (through getGFX() or the element methods).
+   */
+  void invalidate() { screenKind = SCREEN_NONE; }
   /** @brief Access the underlying graphics context (for custom drawing). */
   Adafruit_GFX *getGFX() { return gfx; }
 
+  /**
+   * @brief Measure text as s3ui lays it out (advance widths times the logical size).
+   * @param text Text to measure.
+   * @param useTitleFont Measure with the title font/size instead of the content font/size.
+   * @return Width in pixels (0 if the font is not set).
+   */
+  int16_t getTextWidth(const s3uiText &text, bool useTitleFont = false);
+
+  // Damage tracking for partial display flushes
+  /**
+   * @brief Bounding box of everything s3ui drew since the last resetDirtyRegion().
+   * @param region Receives the dirty rectangle, clipped to the display.
+   * @return False if nothing was drawn (region is left untouched).
+   */
+  bool getDirtyRegion(s3uiRect &region) const;
+  /**
+   * @brief Dirty area as page-aligned horizontal bands for page-addressed controllers.
+   * @param bands Output array; each band spans whole S3UI_PAGE_HEIGHT-row pages and the dirty columns within them.
+   * @param maxBands Capacity of bands; any remaining dirty pages are merged into the last band.
+   * @return Number of bands written (0 if nothing is dirty).
+   */
+  uint8_t getDirtyBands(s3uiRect *bands, uint8_t maxBands) const;
+  /** @brief Forget the accumulated dirty region (call after flushing it to the panel). */
+  void resetDirtyRegion();
+
   // Log management methods (line-by-line append model)
   /**
    * @brief Append a line to the live activity log.
    * @param line Text to append; embedded '\n' creates multi-line entries.
    */
-  void appendLogLine(const String &line);
+  void appendLogLine(const s3uiText &line);
   /** @brief Clear all stored log lines. */
   void clearLog();
-  /** @brief Number of stored log lines. */
-  uint16_t getLogLineCount() const { return logLines.size(); }
+  /** @brief Number of log lines stored in RAM (spilled ones not included). */
+  uint16_t getLogLineCount() const { return logStore.count(); }
+  /**
+   * @brief Store the log in one preallocated ring arena with a fixed byte and entry budget.
+   * @param bytes Arena size in bytes (each entry uses its length + 1). 0 derives it from entries.
+   * @param entries Maximum number of stored lines. 0 derives it from bytes.
+   * @return True if the arena was allocated.
+   * @note Once configured, appendLogLine() evicts the oldest lines instead of allocating. Existing
+   *       lines are discarded. Pass (0, 0) to return to the default growable storage.
+   */
+  bool setLogCapacity(uint32_t bytes, uint16_t entries);
+  /**
+   * @brief Append a structured record to the live activity log.
+   *
+   * Only the level, millis(), the format pointer and the arguments are copied (a fixed-size record, no
+   * formatting, measuring or wrapping); the text is produced when the record scrolls into view. With
+   * setLogCapacity() the append never touches the heap.
+   * @param level Record severity; records below setLogLevel() are dropped.
+   * @param format F() format string, see s3uiFormatLogRecord() for the supported conversions. It is kept by
+   *        pointer, so it must be a flash string literal.
+   * @param a0 First argument (integers or floats).
+   * @param a1 Second argument.
+   * @param a2 Third argument.
+   * @param a3 Fourth argument.
+   */
+  void logRecord(s3uiLogLevel level, const __FlashStringHelper *format, s3uiLogArg a0 = s3uiLogArg(),
+                 s3uiLogArg a1 = s3uiLogArg(), s3uiLogArg a2 = s3uiLogArg(), s3uiLogArg a3 = s3uiLogArg());
+  /**
+   * @brief Create the queue that queueLogRecord() pushes into.
+   * @param capacity Queued records before overflow, rounded up to a power of two. 0 removes the queue.
+   * @param producers S3UI_QUEUE_SINGLE_PRODUCER if one task or interrupt handler logs (wait-free pushes), or
+   *        S3UI_QUEUE_MULTI_PRODUCER for any number of them (lock-free pushes).
+   * @param overflow Drop the newest or the oldest record when the queue is full; either way the drop is counted.
+   * @return True if the queue was allocated.
+   * @note Call before any producer starts. This is the only allocation; pushes never touch the heap.
+   */
+  bool setLogQueue(uint16_t capacity, s3uiQueueProducers producers = S3UI_QUEUE_SINGLE_PRODUCER,
+                   s3uiQueueOverflow overflow = S3UI_QUEUE_DROP_NEWEST);
+  /**
+   * @brief Log a structured record from an interrupt handler or another task.
+   *
+   * Same arguments as logRecord(), but the record goes into the setLogQueue() queue without touching the log
+   * or the display; update() moves queued records into the log before rendering. Unlike every other s3ui
+   * method this one may run concurrently with the UI loop.
+   * @return False if the record was dropped (queue full with S3UI_QUEUE_DROP_NEWEST, or no queue).
+   */
+  bool queueLogRecord(s3uiLogLevel level, const __FlashStringHelper *format, s3uiLogArg a0 = s3uiLogArg(),
+                      s3uiLogArg a1 = s3uiLogArg(), s3uiLogArg a2 = s3uiLogArg(), s3uiLogArg a3 = s3uiLogArg());
+  /** @brief Records dropped by queueLogRecord() since setLogQueue(). */
+  uint32_t getLogQueueDropped() const { return logQueue.dropped(); }
+  /**
+   * @brief Append a record built with s3uiMakeLogRecord() (e.g. on another task), keeping its timestamp.
+   * @note A level outside the s3uiLogLevel range is stored as S3UI_LOG_ERROR, as s3uiMakeLogRecord() does.
+   */
+  void logRecord(const s3uiLogRecord &record);
+  /**
+   * @brief Drop records below level in logRecord() and queueLogRecord() (default S3UI_LOG_DEBUG keeps all).
+   * @note Safe to call while other tasks or interrupts are in queueLogRecord().
+   */
+  void setLogLevel(s3uiLogLevel level);
+  /**
+   * @brief Set the text shown before record messages of a level (defaults "D ", "", "W ", "E ").
+   * @param level Record level.
+   * @param prefix Prefix text in RAM or flash; it is referenced, not copied, and must stay valid.
+   */
+  void setLogLevelPrefix(s3uiLogLevel level, const s3uiText &prefix);
+  /** @brief Show record timestamps as minutes:seconds since boot before the prefix (default on). */
+  void setLogTimestamps(bool show);
+  /**
+   * @brief Scroll the live log by display lines; the slider next to the log window shows the position.
+   * @param deltaLines Negative scrolls back to older lines, positive towards the newest.
+   * @note Seeking costs O(log n) in the number of entries and the next update() draws only the visible lines.
+   *       While scrolled back the view keeps showing the same lines as entries are appended (if its top entry
+   *       is evicted, it moves to the oldest one). Scrolling down to the end follows new entries again.
+   */
+  void scrollLog(int32_t deltaLines);
+  /** @brief Show the newest log entries again. */
+  void scrollLogToEnd();
+  /**
+   * @brief Keep the newest entries in view as they are appended while the view is at the end (default on).
+   * @note When off, the view does not move by itself; new entries stay below it until scrolled to.
+   */
+  void setLogFollowTail(bool follow);
+  /** @brief True while the log view follows the newest entries. */
+  bool isLogFollowingTail() const { return logAtTail; }
+  /**
+   * @brief Keep the log in two files, with only a window of recent entries in RAM.
+   *
+   * The setLogCapacity() arena becomes a window of the newest entries: update() writes entries to an
+   * append-only data file and an entry offset index in batches, before the window evicts them, so appends
+   * stay as cheap as before and RAM use does not depend on the size of the log. The log view and scrollLog()
+   * cover every entry in the files; older entries are read back a few bytes at a time as they scroll into
+   * view. Entries the files already hold from a previous run are shown before the new ones.
+   * @param data Entry text file (see s3uiLogStorage; s3uiFileStorage wraps an Arduino File).
+   * @param index Entry index file (12 bytes per entry).
+   * @param batchEntries Unwritten entries that make update() write a batch. Keep it well below the RAM window's
+   *        entry count; entries evicted before they are written are counted by getLogSpillLost().
+   * @return True if spilling started; false without a setLogCapacity() window or if the buffer
+   *         (s3uiLogSpill::bufferBytes()) could not be allocated. Pass nullptr files to stop spilling.
+   * @note Records are written formatted (timestamp and prefix included) and wrapped line counts are stored
+   *       as measured at that time. A failed write stops spilling. clearLog() hides the spilled entries
+   *       without touching the files.
+   */
+  bool setLogSpill(s3uiLogStorage *data, s3uiLogStorage *index, uint16_t batchEntries = 8);
+  /**
+   * @brief Write all unwritten entries to the spill files now (e.g. before power-down).
+   * @return False if spilling is off or a write failed.
+   */
+  bool flushLogSpill();
+  /** @brief Entries evicted from RAM before update() could write them to the spill files. */
+  uint32_t getLogSpillLost() const { return logSpillLost; }
+
+#ifdef S3UI_RENDER_STATS
+  // Render instrumentation (define S3UI_RENDER_STATS as a build flag)
+  /** @brief Cumulative counters, the counters of the most recent screen call or update() and per-screen timings. */
+  const s3uiRenderStats &getRenderStats() const { return renderStats; }
+  /** @brief Zero all render counters. */
+  void resetRenderStats();
+  /**
+   * @brief Print the render counters as CSV (counter,total,last, then screen,calls,us), e.g. to Serial.
+   * @param out Destination stream.
+   */
+  void printRenderStats(Print &out) const;
+#endif
+
+  /** @brief Display width given to setDisplay(). */
+  uint16_t getDisplayWidth() const { return displayWidth; }
+  /** @brief Display height given to setDisplay(). */
+  uint16_t getDisplayHeight() const { return displayHeight; }
 
   // Font getters
   /** @brief Currently configured title font pointer. */
   const GFXfont *getTitleFont() { return titleFont; }
   /** @brief Currently configured content font pointer. */
   const GFXfont *getContentFont() { return contentFont; }
-  /** @brief Current logical title size. */
+  /** @brief Current title text size. */
   uint8_t getTitleSize() { return titleSize; }
-  /** @brief Current logical content size. */
+  /** @brief Current content text size. */
   uint8_t getContentSize() { return contentSize; }
 };
 
@@ -0,0 +1,60 @@
+#ifndef S3UI_ANIMATION_H
+#define S3UI_ANIMATION_H
+
+/**
+ * @file s3uiAnimation.h
+ * @brief Compressed animation format decoded frame by frame by s3ui::update().
+ *
+ * Layout (all multi-byte fields little-endian, the whole blob may live in PROGMEM):
+ * - Header (S3UI_ANIMATION_HEADER_BYTES): magic 'S', version, width (u16), height (u16), frame count (u16).
+ * - Frames, in order. Each starts with a type byte followed by an RLE stream that expands to exactly
+ *   S3UI_ANIMATION_FRAME_BYTES(width, height) bytes of byte-padded, MSB-first bitmap rows:
+ *   - S3UI_FRAME_KEY: the stream is the frame itself.
+ *   - S3UI_FRAME_DELTA: the stream is the XOR of this frame with the previous one.
+ * - RLE stream: a control byte c < 0x80 is followed by c + 1 literal bytes; c >= 0x80 is followed by one byte
+ *   repeated (c & 0x7F) + 2 times. Runs never cross frame boundaries.
+ *
+ * Frame 0 must be a key frame so the animation can loop. Use extras/s3ui_anim.py to convert images.
+ */
+
+#include "Arduino.h"
+
+/** @brief First header byte. */
+#define S3UI_ANIMATION_MAGIC 0x53
+/** @brief Format version written by the converter. */
+#define S3UI_ANIMATION_VERSION 1
+/** @brief Header size in bytes. */
+#define S3UI_ANIMATION_HEADER_BYTES 8
+/** @brief Bytes of one decoded frame (size of the scratch buffer the caller provides). */
+#define S3UI_ANIMATION_FRAME_BYTES(w, h) ((((uint16_t)(w) + 7) / 8) * (uint16_t)(h))
+
+/** @brief Frame type byte. */
+enum s3uiFrameType : uint8_t {
+  S3UI_FRAME_KEY = 0,  ///< Frame stored as is.
+  S3UI_FRAME_DELTA = 1 ///< Frame stored as XOR with the previous frame.
+};
+
+/** @brief Decoded animation header. */
+struct s3uiAnimationHeader {
+  uint16_t width;  ///< Frame width in pixels.
+  uint16_t height; ///< Frame height in pixels.
+  uint16_t frames; ///< Number of frames.
+};
+
+/**
+ * @brief Read and validate an animation header.
+ * @param animation Encoded animation (PROGMEM).
+ * @param header Receives the header fields.
+ * @return False if the magic, version or dimensions are invalid.
+ */
+static inline bool s3uiReadAnimationHeader(const uint8_t *animation, s3uiAnimationHeader &header) {
+  if (!animation || pgm_read_byte(animation) != S3UI_ANIMATION_MAGIC ||
+      pgm_read_byte(animation + 1) != S3UI_ANIMATION_VERSION)
+    return false;
+  header.width = pgm_read_byte(animation + 2) | (pgm_read_byte(animation + 3) << 8);
+  header.height = pgm_read_byte(animation + 4) | (pgm_read_byte(animation + 5) << 8);
+  header.frames = pgm_read_byte(animation + 6) | (pgm_read_byte(animation + 7) << 8);
+  return header.width > 0 && header.height > 0 && header.frames > 0;
+}
+
+#endif
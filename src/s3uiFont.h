@@ -0,0 +1,22 @@
+#ifndef S3UI_FONT_H
+#define S3UI_FONT_H
+
+/**
+ * @file s3uiFont.h
+ * @brief Internal GFXfont accessors shared by the s3ui renderers.
+ */
+
+#include "Adafruit_GFX.h"
+
+// Fonts usually live in PROGMEM; read them the way Adafruit_GFX does so AVR targets work too
+#ifdef __AVR__
+static inline const GFXglyph *fontGlyph(const GFXfont *font, uint16_t index) {
+  return ((const GFXglyph *)pgm_read_word(&font->glyph)) + index;
+}
+static inline const uint8_t *fontBitmap(const GFXfont *font) { return (const uint8_t *)pgm_read_word(&font->bitmap); }
+#else
+static inline const GFXglyph *fontGlyph(const GFXfont *font, uint16_t index) { return font->glyph + index; }
+static inline const uint8_t *fontBitmap(const GFXfont *font) { return font->bitmap; }
+#endif
+
+#endif
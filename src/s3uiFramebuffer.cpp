@@ -0,0 +1,297 @@
+#include "s3uiFramebuffer.h"
+#include "s3uiFont.h"
+
+/**
+ * @file s3uiFramebuffer.cpp
+ * @brief Implementation of the direct 1-bpp framebuffer renderer.
+ */
+
+void s3uiFramebuffer::attach(uint8_t *buf, int16_t w, int16_t h, s3uiBufferLayout bufferLayout) {
+  buffer = buf;
+  width = w;
+  height = h;
+  layout = bufferLayout;
+  stride = (layout == S3UI_LAYOUT_HORIZONTAL) ? (w + 7) / 8 : w;
+  clearRowClip();
+}
+
+void s3uiFramebuffer::setRowClip(int16_t top, int16_t bottom) {
+  clipTop = (top > 0) ? top : 0;
+  clipBottom = (bottom < height) ? bottom : height;
+}
+
+void s3uiFramebuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  // Clip to the buffer and the row clip
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < clipTop) {
+    h -= clipTop - y;
+    y = clipTop;
+  }
+  if (x + w > width)
+    w = width - x;
+  if (y + h > clipBottom)
+    h = clipBottom - y;
+  if (w <= 0 || h <= 0)
+    return;
+
+  if (layout == S3UI_LAYOUT_HORIZONTAL) {
+    // Partial first/last bytes are masked, whole bytes in between are stored directly
+    int16_t x1 = x + w - 1;
+    uint16_t b0 = x >> 3;
+    uint16_t b1 = x1 >> 3;
+    uint8_t mask0 = 0xFF >> (x & 7);
+    uint8_t mask1 = 0xFF << (7 - (x1 & 7));
+    if (b0 == b1)
+      mask0 = mask1 = mask0 & mask1;
+    uint8_t *row = buffer + (uint16_t)y * stride;
+    for (int16_t r = 0; r < h; r++, row += stride) {
+      if (color) {
+        row[b0] |= mask0;
+        if (b1 != b0) {
+          memset(row + b0 + 1, 0xFF, b1 - b0 - 1);
+          row[b1] |= mask1;
+        }
+      } else {
+        row[b0] &= ~mask0;
+        if (b1 != b0) {
+          memset(row + b0 + 1, 0x00, b1 - b0 - 1);
+          row[b1] &= ~mask1;
+        }
+      }
+    }
+    return;
+  }
+
+  // Vertical pages: one mask per page covers all rows of the rectangle inside it
+  int16_t y1 = y + h - 1;
+  for (int16_t page = y >> 3; page <= (y1 >> 3); page++) {
+    int16_t top = (page << 3);
+    uint8_t mask = 0xFF;
+    if (y > top)
+      mask &= 0xFF << (y - top);
+    if (y1 < top + 7)
+      mask &= 0xFF >> (top + 7 - y1);
+    uint8_t *col = buffer + (uint16_t)page * stride + x;
+    if (color) {
+      for (int16_t i = 0; i < w; i++)
+        col[i] |= mask;
+    } else {
+      for (int16_t i = 0; i < w; i++)
+        col[i] &= ~mask;
+    }
+  }
+}
+
+void s3uiFramebuffer::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+  fillRect(x, y + h - 1, w, 1, color);
+  fillRect(x, y, 1, h, color);
+  fillRect(x + w - 1, y, 1, h, color);
+}
+
+// Source byte from flash or RAM (the same read everywhere but on AVR)
+static inline uint8_t sourceByte(const uint8_t *p, bool inFlash) { return inFlash ? pgm_read_byte(p) : *p; }
+
+void s3uiFramebuffer::blitBits(int16_t x, int16_t y, const uint8_t *src, uint32_t bit, int16_t w, bool set,
+                               bool inFlash) {
+  if (y < clipTop || y >= clipBottom)
+    return;
+  if (x < 0) {
+    bit += -x;
+    w += x;
+    x = 0;
+  }
+  if (x + w > width)
+    w = width - x;
+  if (w <= 0)
+    return;
+
+  if (layout == S3UI_LAYOUT_HORIZONTAL) {
+    while (w > 0) {
+      // Gather up to 8 source bits (MSB-aligned), then shift them across at most two destination bytes
+      uint8_t n = (w < 8) ? w : 8;
+      uint8_t s = bit & 7;
+      uint16_t word = (uint16_t)sourceByte(src + (bit >> 3), inFlash) << 8;
+      if (s + n > 8)
+        word |= sourceByte(src + (bit >> 3) + 1, inFlash);
+      uint8_t chunk = (uint8_t)((word << s) >> 8) & (uint8_t)(0xFF << (8 - n));
+      if (chunk)
+        putBits(x, y, chunk, set);
+      bit += n;
+      x += n;
+      w -= n;
+    }
+    return;
+  }
+
+  // Vertical pages: every pixel of the row shares one bit mask; empty source bytes are skipped whole
+  uint8_t *col = buffer + (uint16_t)(y >> 3) * stride + x;
+  uint8_t mask = 1 << (y & 7);
+  while (w > 0) {
+    uint8_t s = bit & 7;
+    uint8_t b = sourceByte(src + (bit >> 3), inFlash) << s;
+    uint8_t n = 8 - s;
+    if (n > w)
+      n = w;
+    for (uint8_t i = 0; b && i < n; i++, b <<= 1) {
+      if (b & 0x80) {
+        if (set)
+          col[i] |= mask;
+        else
+          col[i] &= ~mask;
+      }
+    }
+    col += n;
+    bit += n;
+    w -= n;
+  }
+}
+
+void s3uiFramebuffer::putBits(int16_t x, int16_t y, uint8_t bits, bool set) {
+  if (layout == S3UI_LAYOUT_HORIZONTAL) {
+    // The run straddles at most two destination bytes
+    uint8_t *d = buffer + (uint16_t)y * stride + (x >> 3);
+    uint8_t dx = x & 7;
+    uint8_t hi = bits >> dx;
+    uint8_t lo = dx ? (uint8_t)(bits << (8 - dx)) : 0;
+    if (set) {
+      d[0] |= hi;
+      if (lo)
+        d[1] |= lo;
+    } else {
+      d[0] &= ~hi;
+      if (lo)
+        d[1] &= ~lo;
+    }
+    return;
+  }
+
+  uint8_t *col = buffer + (uint16_t)(y >> 3) * stride + x;
+  uint8_t mask = 1 << (y & 7);
+  for (uint8_t i = 0; bits; i++, bits <<= 1) {
+    if (bits & 0x80) {
+      if (set)
+        col[i] |= mask;
+      else
+        col[i] &= ~mask;
+    }
+  }
+}
+
+void s3uiFramebuffer::drawBits(int16_t x, int16_t y, uint8_t bits, bool set) {
+  if (y < clipTop || y >= clipBottom || x <= -8 || x >= width)
+    return;
+  if (x < 0) {
+    bits <<= -x;
+    x = 0;
+  }
+  if (x + 8 > width)
+    bits &= 0xFF << (x + 8 - width);
+  if (bits)
+    putBits(x, y, bits, set);
+}
+
+void s3uiFramebuffer::drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h) {
+  uint32_t rowBits = (uint32_t)((w + 7) / 8) * 8;
+  for (int16_t j = 0; j < h; j++) {
+    blitBits(x, y + j, bitmap, j * rowBits, w, true);
+  }
+}
+
+void s3uiFramebuffer::drawRow(int16_t x, int16_t y, const uint8_t *bits, int16_t w, uint8_t h, uint16_t color) {
+  int16_t top = (y > clipTop) ? y : clipTop;
+  int16_t bottom = (y + h < clipBottom) ? y + h : clipBottom;
+  if (top >= bottom)
+    return;
+  bool set = color != 0;
+  if (x < 0 || x + w > width) {
+    for (int16_t row = top; row < bottom; row++)
+      blitBits(x, row, bits, 0, w, set, false);
+    return;
+  }
+
+  // The row starts on a source byte boundary, so every source byte is an 8-pixel run as it is
+  if (layout == S3UI_LAYOUT_HORIZONTAL) {
+    for (int16_t k = 0; k < w; k += 8) {
+      uint8_t chunk = bits[k >> 3];
+      if (w - k < 8)
+        chunk &= 0xFF << (8 - (w - k));
+      if (!chunk)
+        continue;
+      for (int16_t row = top; row < bottom; row++)
+        putBits(x + k, row, chunk, set);
+    }
+    return;
+  }
+
+  // Vertical pages: the repeated rows inside one page share a mask, so each set pixel is one byte update per page
+  for (int16_t page = top >> 3; page <= ((bottom - 1) >> 3); page++) {
+    int16_t pageTop = page << 3;
+    uint8_t mask = 0xFF;
+    if (top > pageTop)
+      mask &= 0xFF << (top - pageTop);
+    if (bottom - 1 < pageTop + 7)
+      mask &= 0xFF >> (pageTop + 7 - (bottom - 1));
+    uint8_t *col = buffer + (uint16_t)page * stride + x;
+    for (int16_t k = 0; k < w; k += 8, col += 8) {
+      uint8_t b = bits[k >> 3];
+      if (w - k < 8)
+        b &= 0xFF << (8 - (w - k));
+      for (uint8_t i = 0; b && i < 8; i++, b <<= 1) {
+        if (b & 0x80) {
+          if (set)
+            col[i] |= mask;
+          else
+            col[i] &= ~mask;
+        }
+      }
+    }
+  }
+}
+
+void s3uiFramebuffer::drawText(const GFXfont *font, int16_t &cursorX, int16_t &cursorY, const s3uiText &text,
+                               uint16_t color, uint8_t size) {
+  uint8_t first = pgm_read_word(&font->first);
+  uint8_t last = pgm_read_word(&font->last);
+  uint8_t yAdvance = pgm_read_byte(&font->yAdvance);
+  const uint8_t *bitmap = fontBitmap(font);
+
+  for (uint16_t i = 0; i < text.length(); i++) {
+    uint8_t c = (uint8_t)text[i];
+    if (c == '\n') {
+      cursorX = 0;
+      cursorY += (int16_t)yAdvance * size;
+      continue;
+    }
+    if (c == '\r' || c < first || c > last)
+      continue;
+
+    // Glyph bits are packed continuously across rows, so row yy starts w * yy bits into the glyph
+    const GFXglyph *glyph = fontGlyph(font, c - first);
+    uint8_t w = pgm_read_byte(&glyph->width);
+    uint8_t h = pgm_read_byte(&glyph->height);
+    if (w > 0 && h > 0) {
+      const uint8_t *bits = bitmap + pgm_read_word(&glyph->bitmapOffset);
+      int16_t xOffset = (int8_t)pgm_read_byte(&glyph->xOffset);
+      int16_t yOffset = (int8_t)pgm_read_byte(&glyph->yOffset);
+      if (size == 1) {
+        for (uint8_t yy = 0; yy < h; yy++) {
+          blitBits(cursorX + xOffset, cursorY + yOffset + yy, bits, (uint32_t)yy * w, w, color != 0);
+        }
+      } else {
+        // One square per set bit, as Adafruit_GFX draws scaled glyphs
+        uint16_t bit = 0;
+        for (uint8_t yy = 0; yy < h; yy++) {
+          for (uint8_t xx = 0; xx < w; xx++, bit++) {
+            if (pgm_read_byte(bits + (bit >> 3)) & (0x80 >> (bit & 7)))
+              fillRect(cursorX + (xOffset + xx) * size, cursorY + (yOffset + yy) * size, size, size, color);
+          }
+        }
+      }
+    }
+    cursorX += pgm_read_byte(&glyph->xAdvance) * size;
+  }
+}
@@ -0,0 +1,117 @@
+#ifndef S3UI_FRAMEBUFFER_H
+#define S3UI_FRAMEBUFFER_H
+
+/**
+ * @file s3uiFramebuffer.h
+ * @brief Direct 1-bpp framebuffer renderer used instead of per-pixel Adafruit_GFX calls.
+ */
+
+#include "Adafruit_GFX.h"
+#include "Arduino.h"
+#include "s3uiText.h"
+
+/** @brief Memory layout of a 1-bpp display buffer. */
+enum s3uiBufferLayout : uint8_t {
+  S3UI_LAYOUT_HORIZONTAL, ///< Rows of (width + 7) / 8 bytes, MSB = leftmost pixel (GFXcanvas1).
+  S3UI_LAYOUT_VERTICAL    ///< Pages of 8 rows, one byte per column, LSB = top row (SSD1306, PCF8814).
+};
+
+/**
+ * @class s3uiFramebuffer
+ * @brief Renders rectangles, bitmaps and GFXfont text straight into a 1-bpp buffer.
+ *
+ * Output matches Adafruit_GFX pixel for pixel (unrotated, color 0 clears and any other
+ * color sets), including clipping at the buffer edges. Rectangles are filled with byte masks and glyph
+ * and bitmap rows are shifted into place a byte at a time instead of one virtual drawPixel() per pixel.
+ */
+class s3uiFramebuffer {
+private:
+  uint8_t *buffer;         ///< Attached buffer (nullptr when detached).
+  int16_t width;           ///< Buffer width in pixels.
+  int16_t height;          ///< Buffer height in pixels.
+  uint16_t stride;         ///< Bytes per row (horizontal) or per page (vertical).
+  s3uiBufferLayout layout; ///< Buffer memory layout.
+  int16_t clipTop;         ///< First row that may be drawn.
+  int16_t clipBottom;      ///< Row after the last one that may be drawn.
+
+  /**
+   * @brief Draw one row of packed MSB-first source bits; only set bits are drawn.
+   * @param x Left edge of the row.
+   * @param y Row position.
+   * @param src Source bits.
+   * @param bit Bit offset of the first pixel in src.
+   * @param w Number of pixels.
+   * @param set True to set pixels, false to clear them.
+   * @param inFlash True if src is in PROGMEM, false if it is in RAM.
+   */
+  void blitBits(int16_t x, int16_t y, const uint8_t *src, uint32_t bit, int16_t w, bool set, bool inFlash = true);
+  /** @brief Set or clear the pixels of an 8-pixel run (MSB = pixel x) that lies entirely inside the buffer. */
+  void putBits(int16_t x, int16_t y, uint8_t bits, bool set);
+
+public:
+  /** @brief Construct a detached framebuffer. */
+  s3uiFramebuffer()
+      : buffer(nullptr), width(0), height(0), stride(0), layout(S3UI_LAYOUT_HORIZONTAL), clipTop(0), clipBottom(0) {}
+
+  /**
+   * @brief Attach a buffer.
+   * @param buf Buffer to render into (nullptr detaches).
+   * @param w Width in pixels.
+   * @param h Height in pixels.
+   * @param bufferLayout Buffer memory layout.
+   * @note Resets the row clip to the whole buffer.
+   */
+  void attach(uint8_t *buf, int16_t w, int16_t h, s3uiBufferLayout bufferLayout);
+  /**
+   * @brief Restrict all drawing to a band of rows (on top of the buffer bounds).
+   * @param top First row that may be drawn.
+   * @param bottom Row after the last one that may be drawn.
+   */
+  void setRowClip(int16_t top, int16_t bottom);
+  /** @brief Allow drawing on every row again. */
+  void clearRowClip() { setRowClip(0, height); }
+  /** @brief True if a buffer is attached. */
+  bool attached() const { return buffer != nullptr; }
+  /** @brief Attached buffer. */
+  uint8_t *data() const { return buffer; }
+  /** @brief Layout of the attached buffer. */
+  s3uiBufferLayout bufferLayout() const { return layout; }
+
+  /** @brief Fill a rectangle (like Adafruit_GFX::fillRect() with w, h > 0). */
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  /** @brief Draw a 1px rectangle outline (like Adafruit_GFX::drawRect() with w, h > 0). */
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  /**
+   * @brief Set or clear up to 8 pixels of one row, clipped to the buffer.
+   * @param x Column of the MSB of bits.
+   * @param y Row.
+   * @param bits Pixel mask, MSB = pixel x; pixels whose bit is 0 are left untouched.
+   * @param set True to set the masked pixels, false to clear them.
+   */
+  void drawBits(int16_t x, int16_t y, uint8_t bits, bool set);
+  /** @brief Draw the set bits of a byte-padded, MSB-first bitmap (PROGMEM) with color 1. */
+  void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h);
+  /**
+   * @brief Draw the set bits of one row of packed MSB-first bits in RAM on rows [y, y + h).
+   * @param x Left edge of the row.
+   * @param y First row.
+   * @param bits Source bits, starting at the first bit of bits[0].
+   * @param w Number of pixels.
+   * @param h Number of rows the row is repeated on.
+   * @param color Color 0 clears, any other color sets.
+   */
+  void drawRow(int16_t x, int16_t y, const uint8_t *bits, int16_t w, uint8_t h, uint16_t color);
+  /**
+   * @brief Print text like Adafruit_GFX::write() with a custom font and wrapping off.
+   * @param font Font to print with.
+   * @param cursorX In: cursor x. Out: cursor x after the text.
+   * @param cursorY In: baseline y. Out: baseline y after the text ('\n' advances it).
+   * @param text Characters to print.
+   * @param color Text color.
+   * @param size Text size; above 1 every glyph pixel is drawn as a size x size square.
+   */
+  void drawText(const GFXfont *font, int16_t &cursorX, int16_t &cursorY, const s3uiText &text, uint16_t color,
+                uint8_t size = 1);
+};
+
+#endif
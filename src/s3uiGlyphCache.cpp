@@ -0,0 +1,189 @@
+#include "s3uiGlyphCache.h"
+#include "s3uiFont.h"
+
+/**
+ * @file s3uiGlyphCache.cpp
+ * @brief Implementation of the glyph cache.
+ */
+
+s3uiGlyphCache::s3uiGlyphCache()
+    : buffer(nullptr), bufferSize(0), map(nullptr), slotList(nullptr), rowData(nullptr), slotBytes(0),
+      shared(false), head(kNotCached), tail(kNotCached) {
+  fonts[0] = fonts[1] = nullptr;
+  sizes[0] = sizes[1] = 1;
+  first[0] = first[1] = 0;
+  span[0] = span[1] = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+s3uiGlyphCache::~s3uiGlyphCache() { free(buffer); }
+
+bool s3uiGlyphCache::configure(uint16_t bytes) {
+  free(buffer);
+  buffer = nullptr;
+  bufferSize = 0;
+  if (bytes) {
+    buffer = (uint8_t *)malloc(bytes);
+    if (buffer)
+      bufferSize = bytes;
+  }
+  layout();
+  return bytes == 0 || buffer != nullptr;
+}
+
+void s3uiGlyphCache::setFonts(const GFXfont *font0, uint8_t size0, const GFXfont *font1, uint8_t size1) {
+  if (font0 == fonts[0] && size0 == sizes[0] && font1 == fonts[1] && size1 == sizes[1])
+    return;
+  fonts[0] = font0;
+  fonts[1] = font1;
+  sizes[0] = size0 ? size0 : 1;
+  sizes[1] = size1 ? size1 : 1;
+  layout();
+}
+
+// Buffer: one map byte per character of both fonts, then the slot array, then slotBytes of rows per slot
+void s3uiGlyphCache::layout() {
+  stats.slots = 0;
+  stats.used = 0;
+  head = tail = kNotCached;
+  slotBytes = 0;
+  shared = fonts[1] == fonts[0] && sizes[1] == sizes[0];
+  uint16_t mapBytes = 0;
+  for (uint8_t f = 0; f < 2; f++) {
+    first[f] = span[f] = 0;
+    if (!fonts[f] || (f == 1 && shared))
+      continue;
+    first[f] = pgm_read_word(&fonts[f]->first);
+    uint16_t last = pgm_read_word(&fonts[f]->last);
+    if (last < first[f])
+      continue;
+    span[f] = last - first[f] + 1;
+    mapBytes += span[f];
+    for (uint16_t i = 0; i < span[f]; i++) {
+      const GFXglyph *glyph = fontGlyph(fonts[f], i);
+      uint32_t stride = ((uint32_t)pgm_read_byte(&glyph->width) * sizes[f] + 7) / 8;
+      uint32_t bytes = stride * pgm_read_byte(&glyph->height);
+      if (stride > 0xFF)
+        return;
+      if (bytes > slotBytes)
+        slotBytes = bytes;
+    }
+  }
+  if (!buffer || mapBytes == 0 || slotBytes == 0)
+    return;
+
+  uint16_t slotOffset = (mapBytes + sizeof(void *) - 1) & ~(uint16_t)(sizeof(void *) - 1);
+  if (slotOffset >= bufferSize)
+    return;
+  uint32_t slots = (bufferSize - slotOffset) / (sizeof(Slot) + slotBytes);
+  if (slots > kMaxSlots)
+    slots = kMaxSlots;
+  map = buffer;
+  slotList = (Slot *)(buffer + slotOffset);
+  rowData = buffer + slotOffset + slots * sizeof(Slot);
+  memset(map, kNotCached, mapBytes);
+  stats.slots = slots;
+}
+
+void s3uiGlyphCache::unlink(uint8_t slot) {
+  Slot &s = slotList[slot];
+  if (s.prev != kNotCached)
+    slotList[s.prev].next = s.next;
+  else
+    head = s.next;
+  if (s.next != kNotCached)
+    slotList[s.next].prev = s.prev;
+  else
+    tail = s.prev;
+}
+
+void s3uiGlyphCache::pushFront(uint8_t slot) {
+  Slot &s = slotList[slot];
+  s.prev = kNotCached;
+  s.next = head;
+  if (head != kNotCached)
+    slotList[head].prev = slot;
+  head = slot;
+  if (tail == kNotCached)
+    tail = slot;
+}
+
+// Each source pixel becomes size pixels of the row; rows are repeated when drawn
+void s3uiGlyphCache::rasterize(uint8_t font, uint16_t index, uint8_t slot) {
+  const GFXglyph *glyph = fontGlyph(fonts[font], index);
+  const uint8_t *bits = fontBitmap(fonts[font]) + pgm_read_word(&glyph->bitmapOffset);
+  uint8_t w = pgm_read_byte(&glyph->width);
+  uint8_t h = pgm_read_byte(&glyph->height);
+  uint8_t size = sizes[font];
+
+  Glyph &g = slotList[slot].glyph;
+  uint8_t *rows = rowData + (uint16_t)slot * slotBytes;
+  g.rows = rows;
+  g.width = (uint16_t)w * size;
+  g.stride = (g.width + 7) / 8;
+  g.height = h;
+  g.xOffset = (int8_t)pgm_read_byte(&glyph->xOffset);
+  g.yOffset = (int8_t)pgm_read_byte(&glyph->yOffset);
+  memset(rows, 0, (uint16_t)g.stride * h);
+
+  uint16_t bit = 0;
+  uint8_t source = 0;
+  for (uint8_t yy = 0; yy < h; yy++, rows += g.stride) {
+    uint16_t x = 0;
+    for (uint8_t xx = 0; xx < w; xx++, bit++) {
+      if ((bit & 7) == 0)
+        source = pgm_read_byte(bits + (bit >> 3));
+      bool on = source & (0x80 >> (bit & 7));
+      for (uint8_t i = 0; i < size; i++, x++) {
+        if (on)
+          rows[x >> 3] |= 0x80 >> (x & 7);
+      }
+    }
+  }
+}
+
+const s3uiGlyphCache::Glyph *s3uiGlyphCache::lookup(uint8_t font, uint8_t c) {
+  if (shared)
+    font = 0;
+  if (!stats.slots || c < first[font] || c - first[font] >= span[font])
+    return nullptr;
+  uint16_t index = c - first[font];
+  uint16_t key = (font ? span[0] : 0) + index;
+  uint8_t slot = map[key];
+  if (slot == kNoInk)
+    return nullptr;
+  if (slot != kNotCached) {
+    stats.hits++;
+    if (slot != head) {
+      unlink(slot);
+      pushFront(slot);
+    }
+    return &slotList[slot].glyph;
+  }
+
+  const GFXglyph *glyph = fontGlyph(fonts[font], index);
+  if (pgm_read_byte(&glyph->width) == 0 || pgm_read_byte(&glyph->height) == 0) {
+    map[key] = kNoInk;
+    return nullptr;
+  }
+  stats.misses++;
+  if (stats.used < stats.slots) {
+    slot = stats.used++;
+  } else {
+    slot = tail;
+    unlink(slot);
+    map[slotList[slot].key] = kNotCached;
+    stats.evictions++;
+  }
+  slotList[slot].key = key;
+  rasterize(font, index, slot);
+  map[key] = slot;
+  pushFront(slot);
+  return &slotList[slot].glyph;
+}
+
+void s3uiGlyphCache::resetStats() {
+  stats.hits = 0;
+  stats.misses = 0;
+  stats.evictions = 0;
+}
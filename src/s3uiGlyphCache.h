@@ -0,0 +1,121 @@
+#ifndef S3UI_GLYPH_CACHE_H
+#define S3UI_GLYPH_CACHE_H
+
+/**
+ * @file s3uiGlyphCache.h
+ * @brief Bounded LRU cache of glyphs pre-rasterized at their text size.
+ */
+
+#include "Adafruit_GFX.h"
+#include "Arduino.h"
+
+/**
+ * @struct s3uiGlyphCacheStats
+ * @brief Lookup counters of an s3uiGlyphCache.
+ */
+struct s3uiGlyphCacheStats {
+  uint32_t hits;      ///< Glyphs drawn from the cache.
+  uint32_t misses;    ///< Glyphs rasterized into the cache.
+  uint32_t evictions; ///< Least recently used glyphs dropped to make room.
+  uint8_t slots;      ///< Glyphs the cache holds with the current fonts and sizes (0 = cache off).
+  uint8_t used;       ///< Slots holding a glyph.
+};
+
+/**
+ * @class s3uiGlyphCache
+ * @brief Keeps the most recently printed glyphs of two fonts as packed 1-bpp rows in RAM, already widened to
+ *        their text size, so printing a character is a row blit instead of a walk over the font's glyph bits.
+ *
+ * One buffer of the configured size is allocated once and split into equal slots that fit the largest glyph
+ * of either font at its size, plus a character-to-slot map and the LRU list (one font's worth when both are
+ * the same font at the same size). Rows are stored at the scaled width; drawing repeats each row size times.
+ * Glyphs without ink are never stored. Changing a font or size drops all glyphs but keeps the buffer.
+ */
+class s3uiGlyphCache {
+public:
+  /** @brief A cached glyph; draw row r of rows at y + (yOffset + r) * size, size times. */
+  struct Glyph {
+    const uint8_t *rows; ///< height rows of stride bytes, MSB first.
+    uint16_t width;      ///< Row width in pixels (glyph width times size).
+    uint8_t stride;      ///< Bytes per row.
+    uint8_t height;      ///< Rows (glyph height before scaling).
+    int8_t xOffset;      ///< Glyph xOffset before scaling.
+    int8_t yOffset;      ///< Glyph yOffset before scaling.
+  };
+
+private:
+  static const uint8_t kNotCached = 0xFF; ///< Map value of a character without a slot.
+  static const uint8_t kNoInk = 0xFE;     ///< Map value of a character whose glyph has no pixels.
+  static const uint8_t kMaxSlots = 0xFE;  ///< Slot numbers stay below the map markers.
+
+  /** @brief Per-slot bookkeeping. */
+  struct Slot {
+    Glyph glyph;  ///< Geometry and rows of the cached glyph.
+    uint16_t key; ///< Map index of the cached character.
+    uint8_t prev; ///< More recently used slot (kNotCached at the head).
+    uint8_t next; ///< Less recently used slot (kNotCached at the tail).
+  };
+
+  uint8_t *buffer;             ///< Map, slot array and glyph rows.
+  uint16_t bufferSize;         ///< Buffer size in bytes.
+  uint8_t *map;                ///< Slot per character of font 0, then font 1.
+  Slot *slotList;              ///< Slot bookkeeping.
+  uint8_t *rowData;            ///< Glyph rows, slotBytes per slot.
+  uint16_t slotBytes;          ///< Row bytes per slot.
+  const GFXfont *fonts[2];     ///< Cached fonts.
+  uint8_t sizes[2];            ///< Text size of each font.
+  uint16_t first[2];           ///< First character of each font.
+  uint16_t span[2];            ///< Characters of each font.
+  bool shared;                 ///< Font 1 is font 0 at the same size and uses its glyphs.
+  uint8_t head;                ///< Most recently used slot.
+  uint8_t tail;                ///< Least recently used slot.
+  s3uiGlyphCacheStats stats;   ///< Counters.
+
+  /** @brief Carve the buffer for the current fonts and drop all glyphs. */
+  void layout();
+  /** @brief Unlink a slot from the LRU list. */
+  void unlink(uint8_t slot);
+  /** @brief Link a slot at the head of the LRU list. */
+  void pushFront(uint8_t slot);
+  /** @brief Widen a glyph's bits into slot rows. */
+  void rasterize(uint8_t font, uint16_t index, uint8_t slot);
+
+public:
+  s3uiGlyphCache();
+  ~s3uiGlyphCache();
+
+  s3uiGlyphCache(const s3uiGlyphCache &) = delete;
+  s3uiGlyphCache &operator=(const s3uiGlyphCache &) = delete;
+
+  /**
+   * @brief Allocate the cache buffer (or free it with 0).
+   * @param bytes Buffer size; glyphs that fit follow from the fonts and sizes (see getStats().slots).
+   * @return True if the buffer was allocated.
+   */
+  bool configure(uint16_t bytes);
+  /**
+   * @brief Set the fonts and text sizes glyphs are cached for, dropping cached glyphs if they changed.
+   * @param font0 First font (nullptr if unset).
+   * @param size0 Its text size.
+   * @param font1 Second font (may equal font0 at another size).
+   * @param size1 Its text size.
+   */
+  void setFonts(const GFXfont *font0, uint8_t size0, const GFXfont *font1, uint8_t size1);
+  /** @brief True if glyphs can be cached with the current fonts. */
+  bool active() const { return stats.slots != 0; }
+  /**
+   * @brief Glyph of a character, rasterized on the first use; the least recently used glyph makes room.
+   * @param font 0 or 1, as given to setFonts().
+   * @param c Character.
+   * @return The glyph, or nullptr if the character is outside the font or has no pixels.
+   * @note The returned rows stay valid until the next lookup().
+   */
+  const Glyph *lookup(uint8_t font, uint8_t c);
+
+  /** @brief Lookup counters. */
+  const s3uiGlyphCacheStats &getStats() const { return stats; }
+  /** @brief Zero the hit, miss and eviction counters. */
+  void resetStats();
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "s3uiLogRecord.h"
+
+/**
+ * @file s3uiLogRecord.cpp
+ * @brief Minimal printf-style formatter for structured log records.
+ */
+
+// Appends characters to a bounded buffer, silently dropping what does not fit
+struct RecordWriter {
+  char *buffer;
+  uint16_t size;
+  uint16_t length;
+
+  void put(char c) {
+    if (length + 1 < size)
+      buffer[length++] = c;
+  }
+  void pad(char c, uint8_t count) {
+    while (count--)
+      put(c);
+  }
+};
+
+// Write value in the given base, right-aligned to width with fill (sign before zero padding)
+static void writeNumber(RecordWriter &out, uint32_t value, uint8_t base, bool upper, bool negative, uint8_t width,
+                        char fill) {
+  char digits[10];
+  uint8_t count = 0;
+  do {
+    uint8_t d = value % base;
+    digits[count++] = (d < 10) ? (char)('0' + d) : (char)((upper ? 'A' : 'a') + d - 10);
+    value /= base;
+  } while (value);
+
+  uint8_t used = count + (negative ? 1 : 0);
+  if (fill == '0' && negative)
+    out.put('-');
+  if (width > used)
+    out.pad(fill, width - used);
+  if (fill != '0' && negative)
+    out.put('-');
+  while (count)
+    out.put(digits[--count]);
+}
+
+// Fixed-point float output without printf (AVR printf has no %f by default)
+static void writeFloat(RecordWriter &out, float value, uint8_t precision, uint8_t width, char fill) {
+  if (value != value) {
+    out.put('n');
+    out.put('a');
+    out.put('n');
+    return;
+  }
+  bool negative = value < 0;
+  if (negative)
+    value = -value;
+  if (value > 4294967040.0f) {
+    // Integer part would not fit the 32-bit digit loop
+    if (negative)
+      out.put('-');
+    out.put('o');
+    out.put('v');
+    out.put('f');
+    return;
+  }
+
+  uint32_t scale = 1;
+  for (uint8_t i = 0; i < precision; i++)
+    scale *= 10;
+  float rounded = value + 0.5f / scale;
+  uint32_t whole = (uint32_t)rounded;
+  uint32_t fraction = (uint32_t)((rounded - whole) * scale);
+  if (fraction >= scale)
+    fraction = scale - 1;
+
+  uint8_t fractionWidth = precision ? precision + 1 : 0;
+  writeNumber(out, whole, 10, false, negative, (width > fractionWidth) ? width - fractionWidth : 0, fill);
+  if (precision) {
+    out.put('.');
+    writeNumber(out, fraction, 10, false, false, precision, '0');
+  }
+}
+
+s3uiLogRecord s3uiMakeLogRecord(s3uiLogLevel level, const __FlashStringHelper *format, s3uiLogArg a0, s3uiLogArg a1,
+                                s3uiLogArg a2, s3uiLogArg a3) {
+  s3uiLogRecord record;
+  record.timestamp = millis();
+  record.format = reinterpret_cast<const char *>(format);
+  record.args[0] = a0;
+  record.args[1] = a1;
+  record.args[2] = a2;
+  record.args[3] = a3;
+  record.level = (level < S3UI_LOG_LEVELS) ? level : S3UI_LOG_ERROR;
+  return record;
+}
+
+uint16_t s3uiFormatLogRecord(const s3uiLogRecord &record, char *buffer, uint16_t size) {
+  RecordWriter out = {buffer, size, 0};
+  if (size == 0)
+    return 0;
+
+  const char *p = record.format;
+  uint8_t nextArg = 0;
+  char c;
+  while (record.format && (c = (char)pgm_read_byte(p++)) != '\0') {
+    if (c != '%') {
+      out.put(c);
+      continue;
+    }
+
+    // %[0][width][.precision][l]conversion
+    const char *spec = p - 1;
+    char fill = ' ';
+    uint8_t width = 0;
+    uint8_t precision = 2;
+    c = (char)pgm_read_byte(p++);
+    if (c == '0') {
+      fill = '0';
+      c = (char)pgm_read_byte(p++);
+    }
+    while (c >= '0' && c <= '9') {
+      width = width * 10 + (c - '0');
+      c = (char)pgm_read_byte(p++);
+    }
+    if (c == '.') {
+      precision = 0;
+      c = (char)pgm_read_byte(p++);
+      while (c >= '0' && c <= '9') {
+        precision = precision * 10 + (c - '0');
+        c = (char)pgm_read_byte(p++);
+      }
+      if (precision > 6)
+        precision = 6;
+    }
+    while (c == 'l')
+      c = (char)pgm_read_byte(p++);
+
+    if (c == '%') {
+      out.put('%');
+      continue;
+    }
+    if (c != 'd' && c != 'i' && c != 'u' && c != 'x' && c != 'X' && c != 'c' && c != 'f') {
+      // Unknown conversion: copy it literally (stop at the terminator)
+      while (spec < p && pgm_read_byte(spec) != '\0')
+        out.put((char)pgm_read_byte(spec++));
+      if (c == '\0')
+        break;
+      continue;
+    }
+    if (nextArg >= S3UI_LOG_RECORD_ARGS) {
+      out.put('?');
+      continue;
+    }
+
+    const s3uiLogArg &arg = record.args[nextArg++];
+    if (c == 'd' || c == 'i') {
+      int32_t v = arg.asInt();
+      writeNumber(out, (v < 0) ? 0U - (uint32_t)v : (uint32_t)v, 10, false, v < 0, width, fill);
+    } else if (c == 'u') {
+      writeNumber(out, arg.asUnsigned(), 10, false, false, width, fill);
+    } else if (c == 'x' || c == 'X') {
+      writeNumber(out, arg.asUnsigned(), 16, c == 'X', false, width, fill);
+    } else if (c == 'c') {
+      if (width > 1)
+        out.pad(' ', width - 1);
+      out.put((char)arg.asInt());
+    } else {
+      writeFloat(out, arg.asFloat(), precision, width, fill);
+    }
+  }
+
+  buffer[out.length] = '\0';
+  return out.length;
+}
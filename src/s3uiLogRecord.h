@@ -0,0 +1,96 @@
+#ifndef S3UI_LOG_RECORD_H
+#define S3UI_LOG_RECORD_H
+
+/**
+ * @file s3uiLogRecord.h
+ * @brief Compact binary log records that are formatted only when they are displayed.
+ */
+
+#include "Arduino.h"
+
+/** @brief Severity of a structured log record (s3ui::logRecord()). */
+enum s3uiLogLevel : uint8_t {
+  S3UI_LOG_DEBUG, ///< Diagnostic detail.
+  S3UI_LOG_INFO,  ///< Normal progress.
+  S3UI_LOG_WARN,  ///< Something unexpected that was handled.
+  S3UI_LOG_ERROR, ///< A failure.
+  S3UI_LOG_LEVELS ///< Number of levels.
+};
+
+/** @brief Arguments stored with each log record (unused ones cost the same space). */
+#define S3UI_LOG_RECORD_ARGS 4
+
+#ifndef S3UI_LOG_RECORD_TEXT_MAX
+/** @brief Buffer size a record is formatted into (timestamp, level prefix and message); longer text is cut. */
+#define S3UI_LOG_RECORD_TEXT_MAX 64
+#endif
+
+/**
+ * @class s3uiLogArg
+ * @brief One 32-bit log record argument; the format conversion decides how it is read back.
+ *
+ * Converts implicitly from the integer types and float/double, so s3ui::logRecord() takes numbers directly.
+ * Integers keep their low 32 bits and floating-point values are stored as float.
+ */
+class s3uiLogArg {
+private:
+  union {
+    int32_t i;
+    uint32_t u;
+    float f;
+  } value;
+
+public:
+  /** @brief Unused argument (reads as 0). */
+  s3uiLogArg() { value.u = 0; }
+  s3uiLogArg(int v) { value.i = v; }
+  s3uiLogArg(unsigned int v) { value.u = v; }
+  s3uiLogArg(long v) { value.i = (int32_t)v; }
+  s3uiLogArg(unsigned long v) { value.u = (uint32_t)v; }
+  s3uiLogArg(double v) { value.f = (float)v; }
+
+  /** @brief Value as a signed integer (%d, %i, %c). */
+  int32_t asInt() const { return value.i; }
+  /** @brief Value as an unsigned integer (%u, %x, %X). */
+  uint32_t asUnsigned() const { return value.u; }
+  /** @brief Value as a float (%f). */
+  float asFloat() const { return value.f; }
+};
+
+/**
+ * @struct s3uiLogRecord
+ * @brief Fixed-size log record as copied into the log store by s3ui::logRecord().
+ */
+struct s3uiLogRecord {
+  uint32_t timestamp;                     ///< millis() when the record was appended.
+  const char *format;                     ///< printf-style format string in PROGMEM.
+  s3uiLogArg args[S3UI_LOG_RECORD_ARGS];  ///< Arguments consumed by the format conversions in order.
+  uint8_t level;                          ///< s3uiLogLevel.
+};
+
+/**
+ * @brief Build a record stamped with the current millis().
+ * @param level Record severity; out-of-range levels are stored as S3UI_LOG_ERROR.
+ * @param format printf-style format string in PROGMEM (kept by pointer).
+ * @param a0 First argument.
+ * @param a1 Second argument.
+ * @param a2 Third argument.
+ * @param a3 Fourth argument.
+ */
+s3uiLogRecord s3uiMakeLogRecord(s3uiLogLevel level, const __FlashStringHelper *format, s3uiLogArg a0, s3uiLogArg a1,
+                                s3uiLogArg a2, s3uiLogArg a3);
+
+/**
+ * @brief Format a record's message into a buffer.
+ *
+ * Supports %d, %i, %u, %x, %X, %c, %f and %% with an optional '0' flag, field width, precision (%f, default 2)
+ * and 'l' length modifier (ignored, all arguments are 32-bit). Conversions beyond the stored arguments print '?';
+ * unknown conversions are copied as written. Floating-point output does not rely on printf support.
+ * @param record Record to format.
+ * @param buffer Destination; always NUL-terminated when size > 0.
+ * @param size Size of buffer in bytes.
+ * @return Number of characters written, excluding the terminator.
+ */
+uint16_t s3uiFormatLogRecord(const s3uiLogRecord &record, char *buffer, uint16_t size);
+
+#endif
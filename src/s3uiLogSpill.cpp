@@ -0,0 +1,192 @@
+#include "s3uiLogSpill.h"
+
+/**
+ * @file s3uiLogSpill.cpp
+ * @brief Implementation of the append-only log file storage.
+ */
+
+static const uint32_t kNoEntry = 0xFFFFFFFF;
+
+s3uiLogSpill::s3uiLogSpill()
+    : data(nullptr), index(nullptr), buffer(nullptr), entries(0), dataEnd(0), lineEnd(0), batchEntries(0),
+      batchData(0), batchLines(0), dataWritten(0), indexWritten(0), dataBuffered(0), indexBuffered(0),
+      failed(false), cacheNext(0), textEntry(kNoEntry), textLength(0) {
+  invalidateCache();
+}
+
+s3uiLogSpill::~s3uiLogSpill() { detach(); }
+
+void s3uiLogSpill::invalidateCache() {
+  cachedEntry[0] = kNoEntry;
+  cachedEntry[1] = kNoEntry;
+  textEntry = kNoEntry;
+}
+
+bool s3uiLogSpill::attach(s3uiLogStorage *dataFile, s3uiLogStorage *indexFile) {
+  detach();
+  if (!dataFile || !indexFile)
+    return false;
+  buffer = (uint8_t *)malloc(bufferBytes());
+  if (!buffer)
+    return false;
+  data = dataFile;
+  index = indexFile;
+
+  // Continue after the last entry whose text made it into the data file
+  entries = index->size() / sizeof(s3uiLogSpillEntry);
+  uint32_t dataSize = data->size();
+  s3uiLogSpillEntry last;
+  while (entries && !(entry(entries - 1, last) && last.offset + last.length <= dataSize))
+    entries--;
+  dataEnd = entries ? last.offset + last.length : 0;
+  lineEnd = entries ? last.lineStart + last.displayLines : 0;
+  invalidateCache();
+  return true;
+}
+
+void s3uiLogSpill::detach() {
+  free(buffer);
+  buffer = nullptr;
+  data = nullptr;
+  index = nullptr;
+  entries = 0;
+  dataEnd = 0;
+  lineEnd = 0;
+  batchEntries = batchData = batchLines = 0;
+  dataWritten = indexWritten = 0;
+  dataBuffered = 0;
+  indexBuffered = 0;
+  failed = false;
+  invalidateCache();
+}
+
+void s3uiLogSpill::writeData(const uint8_t *bytes, uint16_t length) {
+  if (failed || length == 0)
+    return;
+  if (!data->seek(dataEnd + dataWritten) || data->write(bytes, length) != length)
+    failed = true;
+  dataWritten += length;
+}
+
+// Index records only ever point at text that is already written
+void s3uiLogSpill::writeBatch() {
+  writeData(buffer, dataBuffered);
+  dataBuffered = 0;
+  if (indexBuffered && !failed) {
+    size_t bytes = indexBuffered * sizeof(s3uiLogSpillEntry);
+    if (!index->seek((entries + indexWritten) * sizeof(s3uiLogSpillEntry)) ||
+        index->write((const uint8_t *)indexBuffer(), bytes) != bytes)
+      failed = true;
+  }
+  indexWritten += indexBuffered;
+  indexBuffered = 0;
+}
+
+void s3uiLogSpill::append(const s3uiText &text, uint8_t displayLines) {
+  if (!buffer)
+    return;
+  s3uiLogSpillEntry &record = indexBuffer()[indexBuffered++];
+  record.offset = dataEnd + batchData;
+  record.lineStart = lineEnd + batchLines;
+  record.length = text.length();
+  record.displayLines = displayLines;
+  record.reserved = 0;
+
+  // Gather short texts; one that does not fit goes out on its own after the gathered bytes
+  const uint8_t *bytes = (const uint8_t *)text.data();
+  if (dataBuffered + record.length > S3UI_LOG_SPILL_BUFFER) {
+    writeData(buffer, dataBuffered);
+    dataBuffered = 0;
+  }
+  if (record.length > S3UI_LOG_SPILL_BUFFER) {
+    writeData(bytes, record.length);
+  } else {
+    memcpy(buffer + dataBuffered, bytes, record.length);
+    dataBuffered += record.length;
+  }
+
+  batchEntries++;
+  batchData += record.length;
+  batchLines += displayLines;
+  if (indexBuffered == kIndexBatch)
+    writeBatch();
+}
+
+bool s3uiLogSpill::commit() {
+  if (!buffer)
+    return false;
+  if (batchEntries == 0)
+    return true;
+  writeBatch();
+  if (!failed) {
+    data->flush();
+    index->flush();
+    entries += batchEntries;
+    dataEnd += batchData;
+    lineEnd += batchLines;
+  }
+  bool ok = !failed;
+  batchEntries = batchData = batchLines = 0;
+  dataWritten = indexWritten = 0;
+  failed = false;
+  return ok;
+}
+
+bool s3uiLogSpill::entry(uint32_t n, s3uiLogSpillEntry &record) {
+  for (uint8_t i = 0; i < 2; i++) {
+    if (cachedEntry[i] == n) {
+      record = cached[i];
+      return true;
+    }
+  }
+  if (!index->seek(n * sizeof(s3uiLogSpillEntry)) ||
+      index->read((uint8_t *)&record, sizeof(record)) != sizeof(record))
+    return false;
+  cachedEntry[cacheNext] = n;
+  cached[cacheNext] = record;
+  cacheNext ^= 1;
+  return true;
+}
+
+uint32_t s3uiLogSpill::linesBefore(uint32_t n) {
+  if (n >= entries)
+    return lineEnd;
+  s3uiLogSpillEntry record;
+  return entry(n, record) ? record.lineStart : 0;
+}
+
+uint8_t s3uiLogSpill::displayLines(uint32_t n) {
+  s3uiLogSpillEntry record;
+  return entry(n, record) ? record.displayLines : 0;
+}
+
+s3uiText s3uiLogSpill::text(uint32_t n) {
+  if (!buffer)
+    return s3uiText();
+  char *text = textBuffer();
+  if (n == textEntry)
+    return s3uiText(text, textLength);
+  s3uiLogSpillEntry record;
+  textEntry = kNoEntry;
+  if (!entry(n, record) || !data->seek(record.offset))
+    return s3uiText();
+  uint16_t length = record.length < S3UI_LOG_SPILL_TEXT_MAX ? record.length : S3UI_LOG_SPILL_TEXT_MAX;
+  textLength = data->read((uint8_t *)text, length);
+  textEntry = n;
+  return s3uiText(text, textLength);
+}
+
+// Last entry of the range whose first line is at or before line
+uint32_t s3uiLogSpill::entryAtLine(uint32_t line, uint32_t first, uint32_t number, uint32_t &entryStart) {
+  uint32_t low = first;
+  uint32_t high = first + number - 1;
+  while (low < high) {
+    uint32_t mid = low + (high - low + 1) / 2;
+    if (linesBefore(mid) <= line)
+      low = mid;
+    else
+      high = mid - 1;
+  }
+  entryStart = linesBefore(low);
+  return low;
+}
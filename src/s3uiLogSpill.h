@@ -0,0 +1,189 @@
+#ifndef S3UI_LOG_SPILL_H
+#define S3UI_LOG_SPILL_H
+
+/**
+ * @file s3uiLogSpill.h
+ * @brief Append-only log storage on a file, so the log can hold more entries than fit in RAM.
+ */
+
+#include "Arduino.h"
+#include "s3uiText.h"
+
+#ifndef S3UI_LOG_SPILL_BUFFER
+/** @brief Bytes of entry text gathered in RAM before they are written to the data file. */
+#define S3UI_LOG_SPILL_BUFFER 128
+#endif
+
+#ifndef S3UI_LOG_SPILL_TEXT_MAX
+/** @brief Buffer size an entry read back from storage is copied into; longer entries are shown truncated. */
+#define S3UI_LOG_SPILL_TEXT_MAX 96
+#endif
+
+/**
+ * @class s3uiLogStorage
+ * @brief Byte stream a spilled log is kept in: a file on LittleFS or an SD card, or a plain file on a host.
+ *
+ * Writes always start at a position passed to seek() first, so files must be opened for reading and writing
+ * without append mode (e.g. "r+", or "w+" to start a new log).
+ */
+class s3uiLogStorage {
+public:
+  virtual ~s3uiLogStorage() {}
+  /** @brief Move the read/write position to a byte offset. @return False on failure. */
+  virtual bool seek(uint32_t position) = 0;
+  /** @brief Read up to bytes bytes at the current position. @return Bytes read. */
+  virtual size_t read(uint8_t *buffer, size_t bytes) = 0;
+  /** @brief Write bytes at the current position. @return Bytes written. */
+  virtual size_t write(const uint8_t *data, size_t bytes) = 0;
+  /** @brief Current size in bytes. */
+  virtual uint32_t size() = 0;
+  /** @brief Push buffered writes to the medium. */
+  virtual void flush() {}
+};
+
+/**
+ * @class s3uiFileStorage
+ * @brief s3uiLogStorage over an Arduino file object (fs::File of LittleFS/SPIFFS, SD's File, SdFat's FsFile).
+ *
+ * The file is referenced, not copied; keep it open while the log uses it.
+ */
+template <class FileT> class s3uiFileStorage : public s3uiLogStorage {
+private:
+  FileT &file; ///< Open file.
+
+public:
+  explicit s3uiFileStorage(FileT &openFile) : file(openFile) {}
+  bool seek(uint32_t position) { return file.seek(position); }
+  size_t read(uint8_t *buffer, size_t bytes) {
+    int got = file.read(buffer, bytes);
+    return got > 0 ? (size_t)got : 0;
+  }
+  size_t write(const uint8_t *data, size_t bytes) { return file.write(data, bytes); }
+  uint32_t size() { return file.size(); }
+  void flush() { file.flush(); }
+};
+
+/**
+ * @struct s3uiLogSpillEntry
+ * @brief Index file record of one spilled entry (12 bytes, native byte order).
+ */
+struct s3uiLogSpillEntry {
+  uint32_t offset;      ///< Byte offset of the entry text in the data file.
+  uint32_t lineStart;   ///< Display lines of all earlier entries in the file.
+  uint16_t length;      ///< Text length in bytes.
+  uint8_t displayLines; ///< Wrapped display-line count when the entry was written.
+  uint8_t reserved;     ///< Zero.
+};
+
+/**
+ * @class s3uiLogSpill
+ * @brief Writes log entries to an append-only data file and an entry offset index, and reads them back.
+ *
+ * Entry text goes back to back into the data file; the index file holds one s3uiLogSpillEntry per entry, so
+ * entry n, the display line it starts at and the entry at a display line (binary search) are found with a
+ * few small reads, whatever the size of the log. Appends are gathered in RAM and written by commit(), data
+ * before index, so an interrupted batch leaves the files consistent up to the previous commit. attach()
+ * picks up the entries a previous run left in the files. RAM use is one fixed buffer allocated by attach().
+ */
+class s3uiLogSpill {
+private:
+  static const uint8_t kIndexBatch = 8; ///< Index records gathered before they are written.
+  /** @brief Buffer offset of the gathered index records (aligned for their members). */
+  static const uint16_t kIndexOffset = (S3UI_LOG_SPILL_BUFFER + 3) & ~3;
+  /** @brief Buffer offset of the read-back text. */
+  static const uint16_t kTextOffset = kIndexOffset + kIndexBatch * sizeof(s3uiLogSpillEntry);
+
+  s3uiLogStorage *data;        ///< Entry text file.
+  s3uiLogStorage *index;       ///< Index file.
+  uint8_t *buffer;             ///< Data gather buffer, index gather records and read-back text.
+  uint32_t entries;            ///< Committed entries.
+  uint32_t dataEnd;            ///< Committed bytes of the data file.
+  uint32_t lineEnd;            ///< Display lines of all committed entries.
+  uint32_t batchEntries;       ///< Entries appended since the last commit.
+  uint32_t batchData;          ///< Text bytes appended since the last commit.
+  uint32_t batchLines;         ///< Display lines appended since the last commit.
+  uint32_t dataWritten;        ///< Batch text bytes already written.
+  uint32_t indexWritten;       ///< Batch index records already written.
+  uint16_t dataBuffered;       ///< Text bytes in the gather buffer.
+  uint8_t indexBuffered;       ///< Index records in the gather buffer.
+  bool failed;                 ///< True once a write of the current batch failed.
+  uint32_t cachedEntry[2];     ///< Entries of the cached index records (0xFFFFFFFF = none).
+  s3uiLogSpillEntry cached[2]; ///< Recently read index records.
+  uint8_t cacheNext;           ///< Cache slot replaced next.
+  uint32_t textEntry;          ///< Entry whose text is in the read-back buffer.
+  uint16_t textLength;         ///< Bytes of that text.
+
+  /** @brief Gathered index records. */
+  s3uiLogSpillEntry *indexBuffer() const { return (s3uiLogSpillEntry *)(buffer + kIndexOffset); }
+  /** @brief Read-back text buffer. */
+  char *textBuffer() const { return (char *)(buffer + kTextOffset); }
+  /** @brief Write bytes to the data file after the batch text written so far. */
+  void writeData(const uint8_t *bytes, uint16_t length);
+  /** @brief Write the gathered text, then the gathered index records. */
+  void writeBatch();
+  /** @brief Forget cached index records and text. */
+  void invalidateCache();
+
+public:
+  s3uiLogSpill();
+  ~s3uiLogSpill();
+
+  s3uiLogSpill(const s3uiLogSpill &) = delete;
+  s3uiLogSpill &operator=(const s3uiLogSpill &) = delete;
+
+  /**
+   * @brief Use two files and continue the log stored in them.
+   * @param dataFile Entry text.
+   * @param indexFile Entry index; trailing records whose text is missing from dataFile are ignored.
+   * @return True if the buffer was allocated.
+   */
+  bool attach(s3uiLogStorage *dataFile, s3uiLogStorage *indexFile);
+  /** @brief Stop using the files and free the buffer; uncommitted entries are discarded. */
+  void detach();
+  /** @brief True while files are attached. */
+  bool attached() const { return buffer != nullptr; }
+  /** @brief Bytes allocated by attach(). */
+  static uint16_t bufferBytes() { return kTextOffset + S3UI_LOG_SPILL_TEXT_MAX; }
+
+  /**
+   * @brief Add an entry to the current batch; full gather buffers are written out on the way.
+   * @param text Entry text in RAM.
+   * @param displayLines Wrapped display-line count to store with it.
+   */
+  void append(const s3uiText &text, uint8_t displayLines);
+  /**
+   * @brief Write the rest of the batch and flush both files.
+   * @return True if the batch is stored; false if a write failed (the batch is discarded).
+   */
+  bool commit();
+
+  /** @brief Committed entries (entry 0 is the oldest). */
+  uint32_t count() const { return entries; }
+  /** @brief Display line entry n starts at (n == count() gives the lines of all entries); 0 on a read error. */
+  uint32_t linesBefore(uint32_t n);
+  /** @brief Stored display-line count of entry n (0 on a read error). */
+  uint8_t displayLines(uint32_t n);
+  /**
+   * @brief Read an entry back.
+   * @param n Entry number, below count().
+   * @return View of an internal buffer, valid until the next text() call (truncated to
+   *         S3UI_LOG_SPILL_TEXT_MAX bytes; empty on a read error).
+   */
+  s3uiText text(uint32_t n);
+  /**
+   * @brief Find the entry shown at a display line by binary search over the index, in O(log n) reads.
+   * @param line Display line counted from entry 0.
+   * @param first First entry to consider.
+   * @param number Entries to consider (at least one).
+   * @param entryStart Receives the display line the returned entry starts at.
+   * @return Entry number in [first, first + number).
+   */
+  uint32_t entryAtLine(uint32_t line, uint32_t first, uint32_t number, uint32_t &entryStart);
+  /**
+   * @brief Read the index record of an entry (cached).
+   * @return False on a read error.
+   */
+  bool entry(uint32_t n, s3uiLogSpillEntry &record);
+};
+
+#endif
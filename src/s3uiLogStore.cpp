@@ -0,0 +1,299 @@
+#include "s3uiLogStore.h"
+
+/**
+ * @file s3uiLogStore.cpp
+ * @brief Implementation of the ring-arena log entry storage.
+ */
+
+// Initial sizes used by the growable mode on first append
+static const uint32_t kInitialArenaBytes = 256;
+static const uint16_t kInitialEntries = 16;
+// Hard limit on the descriptor ring (entry indices are 16-bit)
+static const uint16_t kMaxEntriesLimit = 0xFFFF;
+
+s3uiLogStore::s3uiLogStore()
+    : arena(nullptr), arenaSize(0), entries(nullptr), maxEntries(0), oldest(0), entryCount(0), evicted(0),
+      totalLines(0), fixedCapacity(false) {
+#ifdef S3UI_RENDER_STATS
+  allocCount = 0;
+  allocBytes = 0;
+#endif
+}
+
+s3uiLogStore::~s3uiLogStore() { release(); }
+
+void s3uiLogStore::release() {
+  free(arena);
+  free(entries);
+  arena = nullptr;
+  entries = nullptr;
+  arenaSize = 0;
+  maxEntries = 0;
+  oldest = 0;
+  evicted += entryCount;
+  entryCount = 0;
+  totalLines = 0;
+}
+
+bool s3uiLogStore::configure(uint32_t bytes, uint16_t maxCount) {
+  release();
+  fixedCapacity = false;
+  if (bytes == 0 && maxCount == 0)
+    return true;
+
+  // Derive the missing limit from the given one (~16 bytes per entry on average)
+  if (maxCount == 0) {
+    uint32_t derived = bytes / 16;
+    maxCount = (derived == 0) ? 1 : (derived > kMaxEntriesLimit ? kMaxEntriesLimit : (uint16_t)derived);
+  }
+  if (bytes == 0)
+    bytes = (uint32_t)maxCount * 32;
+
+  arena = (char *)malloc(bytes);
+  entries = (Entry *)malloc(sizeof(Entry) * maxCount);
+#ifdef S3UI_RENDER_STATS
+  allocCount += 2;
+  allocBytes += bytes + sizeof(Entry) * maxCount;
+#endif
+  if (!arena || !entries) {
+    release();
+    return false;
+  }
+  arenaSize = bytes;
+  maxEntries = maxCount;
+  fixedCapacity = true;
+  rebuildLineIndex();
+  return true;
+}
+
+void s3uiLogStore::clear() {
+  oldest = 0;
+  evicted += entryCount;
+  entryCount = 0;
+  rebuildLineIndex();
+}
+
+// Line index: Fenwick tree over ring slots, node k (1-based) kept in entries[k - 1].lineSum. Free slots hold
+// zero lines, so sums over slot ranges only count stored entries
+void s3uiLogStore::addLines(uint16_t ringSlot, LineCount delta) {
+  for (uint32_t k = (uint32_t)ringSlot + 1; k <= maxEntries; k += k & (0 - k))
+    entries[k - 1].lineSum += delta;
+  totalLines += delta;
+}
+
+s3uiLogStore::LineCount s3uiLogStore::slotLines(uint16_t slots) const {
+  LineCount sum = 0;
+  for (uint32_t k = slots; k; k &= k - 1)
+    sum += entries[k - 1].lineSum;
+  return sum;
+}
+
+void s3uiLogStore::rebuildLineIndex() {
+  totalLines = 0;
+  for (uint16_t s = 0; s < maxEntries; s++)
+    entries[s].lineSum = 0;
+  for (uint16_t i = 0; i < entryCount; i++) {
+    Entry &e = entries[slot(i)];
+    e.lineSum = lineWeight(e.displayLines);
+    totalLines += e.lineSum;
+  }
+  for (uint32_t k = 1; k <= maxEntries; k++) {
+    uint32_t parent = k + (k & (0 - k));
+    if (parent <= maxEntries)
+      entries[parent - 1].lineSum += entries[k - 1].lineSum;
+  }
+}
+
+void s3uiLogStore::setDisplayLines(uint16_t index, uint8_t lines) {
+  uint16_t s = slot(index);
+  addLines(s, lineWeight(lines) - lineWeight(entries[s].displayLines));
+  entries[s].displayLines = lines;
+}
+
+// Entries occupy slots [oldest, maxEntries) and then [0, oldest) in logical order
+uint32_t s3uiLogStore::linesBefore(uint16_t index) const {
+  if (index >= entryCount)
+    return totalLines;
+  uint16_t s = slot(index);
+  LineCount head = slotLines(oldest);
+  if (s >= oldest)
+    return slotLines(s) - head;
+  return totalLines - head + slotLines(s);
+}
+
+uint16_t s3uiLogStore::entryAtLine(uint32_t line, uint32_t &entryStart) const {
+  entryStart = 0;
+  if (entryCount == 0 || totalLines == 0)
+    return 0;
+  if (line >= totalLines)
+    line = totalLines - 1;
+
+  // Turn the logical line into a line counted from slot 0, then descend the tree
+  LineCount head = slotLines(oldest);
+  LineCount tailLines = totalLines - head;
+  LineCount target = (line < tailLines) ? head + line : line - tailLines;
+  uint16_t pos = 0;
+  uint16_t step = 1;
+  while (step <= maxEntries / 2)
+    step <<= 1;
+  for (; step; step >>= 1) {
+    if ((uint32_t)pos + step <= maxEntries && entries[pos + step - 1].lineSum <= target) {
+      pos += step;
+      target -= entries[pos - 1].lineSum;
+    }
+  }
+
+  // pos is the slot holding the line and target the line within it
+  uint16_t index = (pos >= oldest) ? pos - oldest : (uint16_t)(pos + maxEntries - oldest);
+  entryStart = line - target;
+  return index;
+}
+
+void s3uiLogStore::evictOldest() {
+  if (entryCount == 0)
+    return;
+  addLines(oldest, 0 - lineWeight(entries[oldest].displayLines));
+  evicted++;
+  entryCount--;
+  oldest = (entryCount == 0) ? 0 : slot(1);
+}
+
+// Entries occupy either one run [head, tail) or two runs [head, end) + [0, tail) of the arena
+bool s3uiLogStore::findSpace(uint32_t bytes, uint32_t &offset) const {
+  if (entryCount == 0) {
+    offset = 0;
+    return bytes <= arenaSize;
+  }
+
+  const Entry &first = entries[oldest];
+  const Entry &last = entries[slot(entryCount - 1)];
+  uint32_t head = first.offset;
+  uint32_t tail = last.offset + last.length + 1;
+
+  if (last.offset >= head) {
+    // Not wrapped: free space after the tail, then before the head
+    if (arenaSize - tail >= bytes) {
+      offset = tail;
+      return true;
+    }
+    if (head >= bytes) {
+      offset = 0;
+      return true;
+    }
+    return false;
+  }
+
+  // Wrapped: the only free run lies between tail and head
+  if (head - tail >= bytes) {
+    offset = tail;
+    return true;
+  }
+  return false;
+}
+
+bool s3uiLogStore::grow(uint32_t minBytes) {
+  uint32_t usedBytes = 0;
+  for (uint16_t i = 0; i < entryCount; i++) {
+    usedBytes += entries[slot(i)].length + 1;
+  }
+
+  uint16_t newMaxEntries = maxEntries;
+  if (entryCount == maxEntries) {
+    if (maxEntries == kMaxEntriesLimit)
+      return false;
+    uint32_t doubled = maxEntries ? (uint32_t)maxEntries * 2 : kInitialEntries;
+    newMaxEntries = (doubled > kMaxEntriesLimit) ? kMaxEntriesLimit : (uint16_t)doubled;
+  }
+  uint32_t newArenaSize = arenaSize ? arenaSize : kInitialArenaBytes;
+  while (newArenaSize < usedBytes + minBytes) {
+    newArenaSize *= 2;
+  }
+
+  char *newArena = (char *)malloc(newArenaSize);
+  Entry *newEntries = (Entry *)malloc(sizeof(Entry) * newMaxEntries);
+#ifdef S3UI_RENDER_STATS
+  allocCount += 2;
+  allocBytes += newArenaSize + sizeof(Entry) * newMaxEntries;
+#endif
+  if (!newArena || !newEntries) {
+    free(newArena);
+    free(newEntries);
+    return false;
+  }
+
+  // Copy entries oldest-first into a single compact run starting at offset 0
+  uint32_t offset = 0;
+  for (uint16_t i = 0; i < entryCount; i++) {
+    const Entry &e = entries[slot(i)];
+    memcpy(newArena + offset, arena + e.offset, e.length + 1);
+    newEntries[i].offset = offset;
+    newEntries[i].length = e.length;
+    newEntries[i].displayLines = e.displayLines;
+    newEntries[i].record = e.record;
+    offset += e.length + 1;
+  }
+
+  free(arena);
+  free(entries);
+  arena = newArena;
+  entries = newEntries;
+  arenaSize = newArenaSize;
+  maxEntries = newMaxEntries;
+  oldest = 0;
+  rebuildLineIndex();
+  return true;
+}
+
+s3uiLogStore::Entry *s3uiLogStore::reserve(uint16_t length, uint8_t displayLines) {
+  uint32_t bytes = (uint32_t)length + 1;
+  uint32_t offset = 0;
+  while (entryCount == maxEntries || !findSpace(bytes, offset)) {
+    if (!fixedCapacity && grow(bytes))
+      continue;
+    if (entryCount == 0)
+      return nullptr;
+    evictOldest();
+  }
+
+  arena[offset + length] = '\0';
+  uint16_t s = slot(entryCount);
+  Entry &e = entries[s];
+  e.offset = offset;
+  e.length = length;
+  e.displayLines = displayLines;
+  entryCount++;
+  addLines(s, lineWeight(displayLines));
+  return &e;
+}
+
+bool s3uiLogStore::append(const s3uiText &text, uint8_t displayLines) {
+  uint16_t length = text.length();
+  if (fixedCapacity && length >= arenaSize) {
+    // Keep the newest entry visible even if it exceeds the whole budget
+    length = arenaSize - 1;
+  }
+
+  Entry *e = reserve(length, displayLines);
+  if (!e)
+    return false;
+#ifdef __AVR__
+  if (text.inFlash())
+    memcpy_P(arena + e->offset, text.data(), length);
+  else
+#endif
+    memcpy(arena + e->offset, text.data(), length);
+  e->record = false;
+  return true;
+}
+
+bool s3uiLogStore::appendRecord(const void *data, uint16_t bytes, uint8_t displayLines) {
+  if (fixedCapacity && bytes >= arenaSize)
+    return false;
+
+  Entry *e = reserve(bytes, displayLines);
+  if (!e)
+    return false;
+  memcpy(arena + e->offset, data, bytes);
+  e->record = true;
+  return true;
+}
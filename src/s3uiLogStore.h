@@ -0,0 +1,193 @@
+#ifndef S3UI_LOG_STORE_H
+#define S3UI_LOG_STORE_H
+
+/**
+ * @file s3uiLogStore.h
+ * @brief Contiguous ring-arena storage for live log entries.
+ */
+
+#include "Arduino.h"
+#include "s3uiText.h"
+
+/**
+ * @class s3uiLogStore
+ * @brief Stores log entries back to back in one byte arena with a ring of entry descriptors.
+ *
+ * Two modes are supported:
+ * - Growable (default): the arena and descriptor ring grow geometrically as entries are appended,
+ *   so nothing is ever evicted (up to 65535 entries).
+ * - Fixed capacity (configure()): both buffers are allocated once and the oldest entries are evicted
+ *   in O(1) to make room, so appends never touch the heap afterwards.
+ *
+ * Entries are text or binary records (see appendRecord()). Each is stored NUL-terminated and never straddles the
+ * end of the arena, so entry text can be handed to rendering code as a plain contiguous buffer. Index 0 always
+ * refers to the oldest entry.
+ *
+ * The cached display-line counts are summed in a Fenwick tree over the descriptor ring, so the display line
+ * an entry starts at and the entry shown at a given display line are found in O(log n) (see entryAtLine()).
+ */
+class s3uiLogStore {
+public:
+  /** @brief displayLines() value of an entry not measured yet; counts as one line in the line index. */
+  static constexpr uint8_t kLinesUnknown = 0xFF;
+  /** @brief Largest displayLines() value; an entry that wraps to more lines is shown cut to this many. */
+  static constexpr uint8_t kMaxLines = 0xFE;
+
+private:
+#ifdef __AVR__
+  typedef uint16_t LineCount; ///< Display-line sums (a log on AVR holds far fewer than 65536 lines).
+#else
+  typedef uint32_t LineCount; ///< Display-line sums.
+#endif
+
+  /** @brief Per-entry descriptor kept in the descriptor ring. */
+  struct Entry {
+    uint32_t offset;      ///< Byte offset of the entry text in the arena.
+    uint16_t length;      ///< Text length in bytes, excluding the NUL terminator.
+    uint8_t displayLines; ///< Cached wrapped display-line count (owned by the renderer).
+    bool record;          ///< True if the bytes are a binary record rather than text.
+    LineCount lineSum;    ///< Fenwick tree node of the ring slot: display lines of a range of slots ending here.
+  };
+
+  char *arena;          ///< Entry text storage.
+  uint32_t arenaSize;   ///< Arena size in bytes.
+  Entry *entries;       ///< Descriptor ring.
+  uint16_t maxEntries;  ///< Descriptor ring capacity.
+  uint16_t oldest;      ///< Ring slot of the oldest entry.
+  uint16_t entryCount;  ///< Number of stored entries.
+  uint32_t evicted;     ///< Entries removed so far (sequence number of the oldest entry).
+  LineCount totalLines; ///< Display lines of all entries.
+  bool fixedCapacity;   ///< True when buffers were preallocated by configure().
+#ifdef S3UI_RENDER_STATS
+  uint32_t allocCount;  ///< Buffers allocated so far.
+  uint32_t allocBytes;  ///< Bytes requested by those allocations.
+#endif
+
+  /** @brief Ring slot holding the entry at logical index (0 = oldest). */
+  uint16_t slot(uint16_t index) const {
+    uint32_t s = (uint32_t)oldest + index;
+    return (s >= maxEntries) ? (uint16_t)(s - maxEntries) : (uint16_t)s;
+  }
+  /** @brief Display lines an entry counts for in the line index. */
+  static LineCount lineWeight(uint8_t lines) { return (lines == kLinesUnknown) ? 1 : lines; }
+  /** @brief Add delta (modulo LineCount) to the display lines of a ring slot. */
+  void addLines(uint16_t ringSlot, LineCount delta);
+  /** @brief Display lines of ring slots [0, slots). */
+  LineCount slotLines(uint16_t slots) const;
+  /** @brief Recompute the line index from the descriptors in O(capacity). */
+  void rebuildLineIndex();
+  /** @brief Drop the oldest entry. */
+  void evictOldest();
+  /**
+   * @brief Find arena space for @p bytes contiguous bytes without evicting.
+   * @param bytes Number of bytes required.
+   * @param offset Receives the arena offset on success.
+   * @return True if space is available.
+   */
+  bool findSpace(uint32_t bytes, uint32_t &offset) const;
+  /**
+   * @brief Grow the arena and/or descriptor ring (growable mode only), linearizing stored entries.
+   * @param minBytes Minimum free contiguous bytes required after growing.
+   * @return True on success; false if allocation failed or the ring is at its hard limit.
+   */
+  bool grow(uint32_t minBytes);
+  /**
+   * @brief Make room for a new entry, evicting or growing as the mode allows, and append its descriptor.
+   * @param length Entry length in bytes, excluding the terminator.
+   * @param displayLines Initial cached display-line count.
+   * @return The new descriptor (offset, length and display lines set), or nullptr if the entry cannot be stored.
+   */
+  Entry *reserve(uint16_t length, uint8_t displayLines);
+  /** @brief Release both buffers. */
+  void release();
+
+public:
+  /** @brief Construct an empty growable store (no allocation until the first append). */
+  s3uiLogStore();
+  ~s3uiLogStore();
+
+  s3uiLogStore(const s3uiLogStore &) = delete;
+  s3uiLogStore &operator=(const s3uiLogStore &) = delete;
+
+  /**
+   * @brief Switch to fixed-capacity mode and preallocate the arena and descriptor ring.
+   * @param bytes Arena byte budget (entry text plus one terminator byte each). 0 derives it from @p maxCount.
+   * @param maxCount Maximum number of entries. 0 derives it from @p bytes.
+   * @return True if the buffers were allocated. Passing (0, 0) returns to growable mode.
+   * @note Existing entries are discarded.
+   */
+  bool configure(uint32_t bytes, uint16_t maxCount);
+
+  /**
+   * @brief Append an entry, evicting the oldest entries if needed (fixed-capacity mode).
+   * @param text Entry text in RAM or flash; truncated if it exceeds the arena.
+   * @param displayLines Initial cached display-line count.
+   * @return True if the entry was stored.
+   */
+  bool append(const s3uiText &text, uint8_t displayLines);
+  /**
+   * @brief Append a binary record, evicting the oldest entries if needed (fixed-capacity mode).
+   * @param data Record bytes in RAM.
+   * @param bytes Record size; records are never truncated.
+   * @param displayLines Initial cached display-line count.
+   * @return True if the record was stored.
+   */
+  bool appendRecord(const void *data, uint16_t bytes, uint8_t displayLines);
+
+  /** @brief Remove all entries (buffers are kept). */
+  void clear();
+
+  /** @brief Number of stored entries. */
+  uint16_t count() const { return entryCount; }
+  /** @brief True when buffers are preallocated and appends never allocate. */
+  bool isFixedCapacity() const { return fixedCapacity; }
+  /** @brief Arena size in bytes (0 before the first allocation). */
+  uint32_t capacityBytes() const { return arenaSize; }
+  /** @brief Descriptor ring capacity. */
+  uint16_t capacityEntries() const { return maxEntries; }
+#ifdef S3UI_RENDER_STATS
+  /** @brief Heap allocations made since construction. */
+  uint32_t allocations() const { return allocCount; }
+  /** @brief Bytes requested by those allocations. */
+  uint32_t allocatedBytes() const { return allocBytes; }
+#endif
+
+  /**
+   * @brief Access an entry's text.
+   * @param index Logical index (0 = oldest, count() - 1 = newest).
+   * @param length Receives the text length in bytes.
+   * @return Pointer to NUL-terminated text inside the arena.
+   */
+  const char *text(uint16_t index, uint16_t &length) const {
+    const Entry &e = entries[slot(index)];
+    length = e.length;
+    return arena + e.offset;
+  }
+  /** @brief True if the entry was stored with appendRecord() (text() then returns the record bytes). */
+  bool isRecord(uint16_t index) const { return entries[slot(index)].record; }
+  /** @brief Cached display-line count of an entry. */
+  uint8_t displayLines(uint16_t index) const { return entries[slot(index)].displayLines; }
+  /** @brief Update the cached display-line count of an entry (and the line index, in O(log n)). */
+  void setDisplayLines(uint16_t index, uint8_t lines);
+
+  /** @brief Display lines of all entries (unmeasured entries count as one). */
+  uint32_t totalDisplayLines() const { return totalLines; }
+  /** @brief Display line an entry starts at, counted from the oldest entry; O(log n). */
+  uint32_t linesBefore(uint16_t index) const;
+  /**
+   * @brief Find the entry shown at a display line in O(log n).
+   * @param line Display line counted from the oldest entry; lines past the end select the last entry.
+   * @param entryStart Receives the display line the returned entry starts at.
+   * @return Logical index of the entry (0 when the log is empty).
+   */
+  uint16_t entryAtLine(uint32_t line, uint32_t &entryStart) const;
+  /**
+   * @brief Sequence number of the oldest entry; entry i has sequence firstSequence() + i.
+   *
+   * Sequence numbers stay with their entry while older ones are evicted, so they identify an entry across
+   * appends. Entries removed by clear() or configure() count as evicted.
+   */
+  uint32_t firstSequence() const { return evicted; }
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "s3uiQueue.h"
+
+/**
+ * @file s3uiQueue.cpp
+ * @brief Implementation of the bounded multi-producer item queue.
+ */
+
+// Largest slot count; keeps position distances well inside the signed range of s3uiQueueDiff
+static const uint16_t kMaxQueueSlots = 0x4000;
+
+// Atomic accessors. AVR has no atomic 16/32-bit memory operations, so they run with interrupts masked for a
+// few cycles (single core, so that excludes every other producer); elsewhere they map to GCC builtins
+#ifdef __AVR__
+#include <util/atomic.h>
+
+template <typename T> static inline T loadAcquire(const T *v) {
+  T value;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { value = *(const volatile T *)v; }
+  return value;
+}
+template <typename T> static inline void storeRelease(T *v, T value) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *(volatile T *)v = value; }
+}
+template <typename T> static inline bool compareExchange(T *v, T &expected, T desired) {
+  bool swapped;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    T current = *(volatile T *)v;
+    swapped = (current == expected);
+    if (swapped)
+      *(volatile T *)v = desired;
+    else
+      expected = current;
+  }
+  return swapped;
+}
+static inline void addOne(uint32_t *v) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { (*(volatile uint32_t *)v)++; }
+}
+#else
+template <typename T> static inline T loadAcquire(const T *v) { return __atomic_load_n(v, __ATOMIC_ACQUIRE); }
+template <typename T> static inline void storeRelease(T *v, T value) { __atomic_store_n(v, value, __ATOMIC_RELEASE); }
+template <typename T> static inline bool compareExchange(T *v, T &expected, T desired) {
+  return __atomic_compare_exchange_n(v, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+static inline void addOne(uint32_t *v) { __atomic_fetch_add(v, 1, __ATOMIC_RELAXED); }
+#endif
+
+s3uiQueue::s3uiQueue()
+    : slots(nullptr), slotBytes(0), itemBytes(0), mask(0), enqueuePos(0), dequeuePos(0), droppedCount(0),
+      multiProducer(false), dropOldest(false) {}
+
+s3uiQueue::~s3uiQueue() { free(slots); }
+
+bool s3uiQueue::configure(uint16_t capacity, uint16_t size, s3uiQueueProducers producers,
+                          s3uiQueueOverflow overflow) {
+  free(slots);
+  slots = nullptr;
+  mask = 0;
+  enqueuePos = 0;
+  dequeuePos = 0;
+  droppedCount = 0;
+  multiProducer = (producers == S3UI_QUEUE_MULTI_PRODUCER);
+  dropOldest = (overflow == S3UI_QUEUE_DROP_OLDEST);
+  itemBytes = size;
+  // Keep every slot's sequence number aligned for the atomic accesses
+  slotBytes = (sizeof(s3uiQueueIndex) + size + sizeof(s3uiQueueIndex) - 1) / sizeof(s3uiQueueIndex) *
+              sizeof(s3uiQueueIndex);
+  if (capacity == 0)
+    return true;
+
+  uint16_t count = 1;
+  while (count < capacity && count < kMaxQueueSlots)
+    count <<= 1;
+  slots = (uint8_t *)malloc((uint32_t)slotBytes * count);
+  if (!slots)
+    return false;
+  mask = count - 1;
+  for (uint16_t i = 0; i < count; i++)
+    *sequence(i) = i;
+  return true;
+}
+
+// A slot is free for position pos when its sequence equals pos; a smaller sequence means the ring is full
+bool s3uiQueue::claim(s3uiQueueIndex &pos) {
+  pos = loadAcquire(&enqueuePos);
+  for (;;) {
+    s3uiQueueDiff diff = (s3uiQueueDiff)(loadAcquire(sequence(pos)) - pos);
+    if (diff < 0)
+      return false;
+    if (diff == 0) {
+      // Only one producer: nobody else moves enqueuePos, so a plain publish keeps push() wait-free
+      if (!multiProducer) {
+        storeRelease(&enqueuePos, (s3uiQueueIndex)(pos + 1));
+        return true;
+      }
+      if (compareExchange(&enqueuePos, pos, (s3uiQueueIndex)(pos + 1)))
+        return true;
+      // pos now holds the position another producer moved on to
+    } else {
+      pos = loadAcquire(&enqueuePos);
+    }
+  }
+}
+
+bool s3uiQueue::push(const void *data) {
+  if (!slots) {
+    countDrop();
+    return false;
+  }
+
+  s3uiQueueIndex pos;
+  bool claimed = claim(pos);
+  if (!claimed && dropOldest) {
+    // Full: evict the oldest item once. The slot may still be busy (a pop in progress elsewhere, possibly
+    // the one this push interrupted), so a second failure drops this item rather than waiting or evicting more
+    if (pop(nullptr))
+      countDrop();
+    claimed = claim(pos);
+  }
+  if (!claimed) {
+    countDrop();
+    return false;
+  }
+
+  memcpy(item(pos), data, itemBytes);
+  storeRelease(sequence(pos), (s3uiQueueIndex)(pos + 1));
+  return true;
+}
+
+// A slot holds a published item for position pos when its sequence equals pos + 1
+bool s3uiQueue::pop(void *data) {
+  if (!slots)
+    return false;
+  s3uiQueueIndex pos = loadAcquire(&dequeuePos);
+  for (;;) {
+    s3uiQueueDiff diff = (s3uiQueueDiff)(loadAcquire(sequence(pos)) - (s3uiQueueIndex)(pos + 1));
+    if (diff < 0)
+      return false;
+    if (diff == 0) {
+      // Producers evicting the oldest item may pop concurrently, so the position is claimed with a CAS
+      if (compareExchange(&dequeuePos, pos, (s3uiQueueIndex)(pos + 1))) {
+        if (data)
+          memcpy(data, item(pos), itemBytes);
+        storeRelease(sequence(pos), (s3uiQueueIndex)(pos + mask + 1));
+        return true;
+      }
+    } else {
+      pos = loadAcquire(&dequeuePos);
+    }
+  }
+}
+
+bool s3uiQueue::pending() const {
+  if (!slots)
+    return false;
+  s3uiQueueIndex pos = loadAcquire(&dequeuePos);
+  return loadAcquire(sequence(pos)) == (s3uiQueueIndex)(pos + 1);
+}
+
+uint32_t s3uiQueue::dropped() const { return loadAcquire(&droppedCount); }
+
+void s3uiQueue::countDrop() { addOne(&droppedCount); }
@@ -0,0 +1,111 @@
+#ifndef S3UI_QUEUE_H
+#define S3UI_QUEUE_H
+
+/**
+ * @file s3uiQueue.h
+ * @brief Fixed-size queue that lets interrupt handlers and other tasks hand items to another task.
+ */
+
+#include "Arduino.h"
+
+/** @brief Who may push into an s3uiQueue concurrently. */
+enum s3uiQueueProducers : uint8_t {
+  S3UI_QUEUE_SINGLE_PRODUCER, ///< One task or interrupt handler pushes; push() is wait-free.
+  S3UI_QUEUE_MULTI_PRODUCER   ///< Any number of tasks and interrupt handlers push; push() is lock-free.
+};
+
+/** @brief What push() does when the queue is full. */
+enum s3uiQueueOverflow : uint8_t {
+  S3UI_QUEUE_DROP_NEWEST, ///< Discard the item being pushed.
+  S3UI_QUEUE_DROP_OLDEST  ///< Discard the oldest queued item to make room (the new one if that slot is busy).
+};
+
+#ifdef __AVR__
+typedef uint16_t s3uiQueueIndex; ///< Position counter; accessed with interrupts masked on AVR.
+typedef int16_t s3uiQueueDiff;   ///< Signed distance between position counters.
+#else
+typedef uint32_t s3uiQueueIndex; ///< Position counter; accessed with GCC __atomic builtins.
+typedef int32_t s3uiQueueDiff;   ///< Signed distance between position counters.
+#endif
+
+/**
+ * @class s3uiQueue
+ * @brief Bounded multi-producer, single-consumer ring of fixed-size items (D. Vyukov's per-slot sequence scheme).
+ *
+ * Each slot carries a sequence number that tells producers and the consumer whether it is free or holds a
+ * published item, so producers never wait for the consumer or for each other: a producer interrupted half
+ * way through a push only delays the consumer at that slot. Items are copied in and out byte-wise. Producers
+ * never allocate; the slots are allocated once by configure(), which must not run while producers are active.
+ */
+class s3uiQueue {
+private:
+  uint8_t *slots;               ///< Ring of capacity() slots, each a sequence number followed by the item.
+  uint16_t slotBytes;           ///< Slot stride in bytes.
+  uint16_t itemBytes;           ///< Item size in bytes.
+  s3uiQueueIndex mask;          ///< capacity() - 1 (capacity is a power of two).
+  s3uiQueueIndex enqueuePos;    ///< Next push position.
+  s3uiQueueIndex dequeuePos;    ///< Next pop position.
+  uint32_t droppedCount;        ///< Items discarded on overflow.
+  bool multiProducer;           ///< True to claim push positions with compare-and-swap.
+  bool dropOldest;              ///< True to evict the oldest item when full.
+
+  /** @brief Sequence number of the slot for position pos: equals pos when free, pos + 1 when published. */
+  s3uiQueueIndex *sequence(s3uiQueueIndex pos) const {
+    return reinterpret_cast<s3uiQueueIndex *>(slots + (uint32_t)(pos & mask) * slotBytes);
+  }
+  /** @brief Item storage of the slot for position pos. */
+  uint8_t *item(s3uiQueueIndex pos) const {
+    return slots + (uint32_t)(pos & mask) * slotBytes + sizeof(s3uiQueueIndex);
+  }
+  /**
+   * @brief Claim the next push position.
+   * @param pos Receives the claimed position.
+   * @return False if the queue is full.
+   */
+  bool claim(s3uiQueueIndex &pos);
+  /** @brief Add to droppedCount from any context. */
+  void countDrop();
+
+public:
+  /** @brief Construct an unconfigured queue (push() drops everything until configure()). */
+  s3uiQueue();
+  ~s3uiQueue();
+
+  s3uiQueue(const s3uiQueue &) = delete;
+  s3uiQueue &operator=(const s3uiQueue &) = delete;
+
+  /**
+   * @brief Allocate the slots and choose the item size, concurrency and overflow behaviour.
+   * @param capacity Number of slots, rounded up to a power of two (at most 16384). 0 releases the queue.
+   * @param size Item size in bytes.
+   * @param producers Whether more than one context pushes.
+   * @param overflow Behaviour when full.
+   * @return True if the slots were allocated (or released for capacity 0).
+   * @note Queued items and the dropped counter are discarded.
+   */
+  bool configure(uint16_t capacity, uint16_t size, s3uiQueueProducers producers, s3uiQueueOverflow overflow);
+
+  /**
+   * @brief Queue an item; safe from interrupt handlers and other tasks.
+   * @param data Item to copy into the queue (the configured size).
+   * @return False if this item was dropped (full with S3UI_QUEUE_DROP_NEWEST, or not configured).
+   */
+  bool push(const void *data);
+  /**
+   * @brief Take the oldest published item (the consumer; full S3UI_QUEUE_DROP_OLDEST pushes also use it).
+   * @param data Receives the item (the configured size).
+   * @return False if nothing is published yet.
+   */
+  bool pop(void *data);
+  /** @brief True if pop() would return an item (consumer only). */
+  bool pending() const;
+
+  /** @brief Slot count (0 when not configured). */
+  uint16_t capacity() const { return slots ? (uint16_t)(mask + 1) : 0; }
+  /** @brief Bytes allocated for the slots. */
+  uint32_t capacityBytes() const { return (uint32_t)capacity() * slotBytes; }
+  /** @brief Items discarded because the queue was full or not configured. */
+  uint32_t dropped() const;
+};
+
+#endif
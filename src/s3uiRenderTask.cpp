@@ -0,0 +1,359 @@
+#include "s3uiRenderTask.h"
+
+/**
+ * @file s3uiRenderTask.cpp
+ * @brief Implementation of the command-driven render task with double-buffered frames.
+ */
+
+s3uiRenderTask::s3uiRenderTask(s3ui &renderer)
+    : ui(renderer), back(0), bufferBytes(0), layout(S3UI_LAYOUT_VERTICAL), flush(nullptr), flushContext(nullptr),
+      wake(nullptr), wakeContext(nullptr), flushBusy(false), flushDone(false), frameReady(false), current(),
+      pending() {
+  buffers[0] = nullptr;
+  buffers[1] = nullptr;
+  memset(&stats, 0, sizeof(stats));
+}
+
+s3uiRenderTask::~s3uiRenderTask() {
+  if (buffers[0])
+    ui.setFramebuffer(nullptr);
+  free(buffers[0]);
+  free(buffers[1]);
+}
+
+bool s3uiRenderTask::begin(s3uiFlushCallback callback, void *context, s3uiBufferLayout bufferLayout,
+                           uint16_t queueSize, s3uiQueueProducers producers) {
+  if (buffers[0])
+    ui.setFramebuffer(nullptr);
+  free(buffers[0]);
+  free(buffers[1]);
+  buffers[0] = nullptr;
+  buffers[1] = nullptr;
+
+  uint16_t width = ui.getDisplayWidth();
+  uint16_t height = ui.getDisplayHeight();
+  layout = bufferLayout;
+  bufferBytes = (layout == S3UI_LAYOUT_VERTICAL) ? width * ((height + 7) / 8) : ((width + 7) / 8) * height;
+  if (!callback || bufferBytes == 0 || queueSize == 0)
+    return false;
+  flush = callback;
+  flushContext = context;
+
+  uint8_t *first = (uint8_t *)calloc(bufferBytes, 1);
+  uint8_t *second = (uint8_t *)calloc(bufferBytes, 1);
+  if (!first || !second || !commands.configure(queueSize, sizeof(Command), producers, S3UI_QUEUE_DROP_NEWEST)) {
+    free(first);
+    free(second);
+    return false;
+  }
+  buffers[0] = first;
+  buffers[1] = second;
+  back = 0;
+  flushBusy = false;
+  flushDone = false;
+  frameReady = false;
+  current = Command();
+  ui.setFramebuffer(buffers[0], layout);
+  ui.resetDirtyRegion();
+  return true;
+}
+
+void s3uiRenderTask::setWakeCallback(s3uiWakeCallback callback, void *context) {
+  wake = callback;
+  wakeContext = context;
+}
+
+uint32_t s3uiRenderTask::run() {
+  if (!buffers[0])
+    return S3UI_NO_DEADLINE;
+
+  // Apply everything posted since the last step; only the last screen command of the batch is drawn
+  Command command;
+  uint16_t budget = commands.capacity();
+  pending.type = CMD_NONE;
+  while (budget-- && commands.pop(&command))
+    apply(command);
+  if (pending.type != CMD_NONE) {
+    drawScreen(pending);
+    current = pending;
+  }
+
+  if (ui.update()) {
+    stats.frames++;
+    if (frameReady)
+      stats.framesCoalesced++;
+    frameReady = true;
+  }
+
+  if (flushBusy && flushFinished())
+    flushBusy = false;
+  if (frameReady && !flushBusy)
+    startFlush();
+
+  if (commands.pending())
+    return 0;
+  // A frame waiting for a busy panel is flushed once flushComplete() wakes the task
+  return ui.msUntilNextUpdate();
+}
+
+void s3uiRenderTask::flushComplete() {
+#ifdef __AVR__
+  *(volatile bool *)&flushDone = true;
+#else
+  __atomic_store_n(&flushDone, true, __ATOMIC_RELEASE);
+#endif
+  if (wake)
+    wake(wakeContext);
+}
+
+bool s3uiRenderTask::flushFinished() {
+#ifdef __AVR__
+  return *(volatile bool *)&flushDone;
+#else
+  return __atomic_load_n(&flushDone, __ATOMIC_ACQUIRE);
+#endif
+}
+
+// Both buffers held the same image after the previous flush, so the other buffer only needs the pages that
+// changed since then to hold this frame too
+void s3uiRenderTask::startFlush() {
+  uint8_t count = ui.getDirtyBands(bands, S3UI_FLUSH_BANDS);
+  uint8_t *frame = buffers[back];
+  uint8_t *next = buffers[back ^ 1];
+  uint16_t width = ui.getDisplayWidth();
+  uint16_t height = ui.getDisplayHeight();
+  for (uint8_t i = 0; i < count; i++) {
+    int16_t top = bands[i].y;
+    int16_t bottom = bands[i].y + bands[i].h;
+    if (bottom > (int16_t)height)
+      bottom = height;
+    uint32_t start, end;
+    if (layout == S3UI_LAYOUT_VERTICAL) {
+      start = (uint32_t)(top / 8) * width;
+      end = (uint32_t)((bottom + 7) / 8) * width;
+    } else {
+      uint16_t stride = (width + 7) / 8;
+      start = (uint32_t)top * stride;
+      end = (uint32_t)bottom * stride;
+    }
+    memcpy(next + start, frame + start, end - start);
+  }
+
+  back ^= 1;
+  ui.swapFramebuffer(next);
+  ui.resetDirtyRegion();
+  frameReady = false;
+  flushBusy = true;
+  flushDone = false;
+  stats.flushes++;
+  if (flush(frame, bands, count, flushContext))
+    flushBusy = false;
+}
+
+void s3uiRenderTask::apply(Command &command) {
+  stats.commands++;
+  switch (command.type) {
+  case CMD_MOVE_CURSOR:
+    if (pending.type == CMD_OPTION_SELECT || pending.type == CMD_OPTION_VALUE_SET) {
+      pending.index = command.index;
+    } else if (pending.type == CMD_NONE &&
+               (current.type == CMD_OPTION_SELECT || current.type == CMD_OPTION_VALUE_SET)) {
+      current.index = command.index;
+      if (!ui.moveOptionCursor(command.index))
+        pending = current;
+    }
+    break;
+  case CMD_LOG_LINE:
+    ui.appendLogLine(command.text);
+    break;
+  case CMD_LOG_RECORD:
+    ui.logRecord(command.record);
+    break;
+  case CMD_CLEAR_LOG:
+    ui.clearLog();
+    break;
+  case CMD_STATUS_FIELD:
+    ui.setStatusField(command.index, command.text);
+    break;
+  case CMD_NONE:
+    break;
+  default:
+    // Screen command: it replaces any screen collected earlier in this batch
+    if (pending.type != CMD_NONE)
+      stats.screensSkipped++;
+    pending = command;
+    break;
+  }
+}
+
+void s3uiRenderTask::drawScreen(const Command &c) {
+  switch (c.type) {
+  case CMD_OPTION_SELECT:
+    ui.optionSelectScreen(c.title, c.battery, c.names, c.count, c.index);
+    break;
+  case CMD_OPTION_VALUE_SET:
+    ui.optionValueSetScreen(c.title, c.battery, c.names, c.values, c.count, c.index, c.editing);
+    break;
+  case CMD_ACTIVITY:
+    ui.runningActivityScreen(c.title, c.battery, static_cast<const uint8_t *>(c.bitmap), c.width, c.height, c.text);
+    break;
+  case CMD_ANIMATION:
+    ui.runningActivityScreen(c.title, c.battery, (const uint8_t **)c.bitmap, (uint8_t)c.count, c.width, c.height,
+                             c.msPerFrame, c.text);
+    break;
+  case CMD_ENCODED_ANIMATION:
+    ui.runningActivityScreen(c.title, c.battery, static_cast<const uint8_t *>(c.bitmap), c.scratch, c.msPerFrame,
+                             c.text);
+    break;
+  case CMD_LOG:
+    ui.activityLiveLogScreen(c.title, c.battery);
+    break;
+  case CMD_CONFIRM:
+    ui.confirmScreen(c.title, c.battery, static_cast<const uint8_t *>(c.bitmap), c.width, c.height, c.text, c.names,
+                     (uint8_t)c.count, (uint8_t)c.index);
+    break;
+  default:
+    break;
+  }
+}
+
+void s3uiRenderTask::copyText(char *dest, uint16_t size, const s3uiText &text) {
+  uint16_t n = text.length();
+  if (n > size - 1)
+    n = size - 1;
+  for (uint16_t i = 0; i < n; i++)
+    dest[i] = text[i];
+  dest[n] = '\0';
+}
+
+void s3uiRenderTask::prepare(Command &command, CommandType type, const s3uiText &title, const s3uiText &battery) {
+  command.type = type;
+  copyText(command.title, sizeof(command.title), title);
+  copyText(command.battery, sizeof(command.battery), battery);
+}
+
+bool s3uiRenderTask::post(const Command &command) {
+  if (!commands.push(&command))
+    return false;
+  if (wake)
+    wake(wakeContext);
+  return true;
+}
+
+bool s3uiRenderTask::optionSelectScreen(const s3uiText &title, const s3uiText &batteryPercentage,
+                                        const s3uiTextList &options, uint16_t numOptions, uint16_t cursorPos) {
+  Command c = Command();
+  prepare(c, CMD_OPTION_SELECT, title, batteryPercentage);
+  c.names = options;
+  c.count = numOptions;
+  c.index = cursorPos;
+  return post(c);
+}
+
+bool s3uiRenderTask::optionValueSetScreen(const s3uiText &title, const s3uiText &batteryPercentage,
+                                          const s3uiTextList &optionNames, const s3uiTextList &optionValues,
+                                          uint16_t numOptions, uint16_t cursorPos, bool optionSelected) {
+  Command c = Command();
+  prepare(c, CMD_OPTION_VALUE_SET, title, batteryPercentage);
+  c.names = optionNames;
+  c.values = optionValues;
+  c.count = numOptions;
+  c.index = cursorPos;
+  c.editing = optionSelected;
+  return post(c);
+}
+
+bool s3uiRenderTask::moveOptionCursor(uint16_t cursorPos) {
+  Command c = Command();
+  c.type = CMD_MOVE_CURSOR;
+  c.index = cursorPos;
+  return post(c);
+}
+
+bool s3uiRenderTask::runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage,
+                                           const uint8_t *bitmap, uint16_t bitmapW, uint16_t bitmapH,
+                                           const s3uiText &caption) {
+  Command c = Command();
+  prepare(c, CMD_ACTIVITY, title, batteryPercentage);
+  c.bitmap = bitmap;
+  c.width = bitmapW;
+  c.height = bitmapH;
+  copyText(c.text, sizeof(c.text), caption);
+  return post(c);
+}
+
+bool s3uiRenderTask::runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage,
+                                           const uint8_t **bitmaps, uint8_t numFrames, uint16_t bitmapW,
+                                           uint16_t bitmapH, uint16_t msPerFrame, const s3uiText &caption) {
+  Command c = Command();
+  prepare(c, CMD_ANIMATION, title, batteryPercentage);
+  c.bitmap = bitmaps;
+  c.count = numFrames;
+  c.width = bitmapW;
+  c.height = bitmapH;
+  c.msPerFrame = msPerFrame;
+  copyText(c.text, sizeof(c.text), caption);
+  return post(c);
+}
+
+bool s3uiRenderTask::runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage,
+                                           const uint8_t *animation, uint8_t *frameBuffer, uint16_t msPerFrame,
+                                           const s3uiText &caption) {
+  Command c = Command();
+  prepare(c, CMD_ENCODED_ANIMATION, title, batteryPercentage);
+  c.bitmap = animation;
+  c.scratch = frameBuffer;
+  c.msPerFrame = msPerFrame;
+  copyText(c.text, sizeof(c.text), caption);
+  return post(c);
+}
+
+bool s3uiRenderTask::activityLiveLogScreen(const s3uiText &title, const s3uiText &batteryPercentage) {
+  Command c = Command();
+  prepare(c, CMD_LOG, title, batteryPercentage);
+  return post(c);
+}
+
+bool s3uiRenderTask::confirmScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *bitmap,
+                                   uint16_t bitmapW, uint16_t bitmapH, const s3uiText &question,
+                                   const s3uiTextList &options, uint8_t numOptions, uint8_t selectedIndex) {
+  Command c = Command();
+  prepare(c, CMD_CONFIRM, title, batteryPercentage);
+  c.bitmap = bitmap;
+  c.width = bitmapW;
+  c.height = bitmapH;
+  copyText(c.text, sizeof(c.text), question);
+  c.names = options;
+  c.count = numOptions;
+  c.index = selectedIndex;
+  return post(c);
+}
+
+bool s3uiRenderTask::appendLogLine(const s3uiText &line) {
+  Command c = Command();
+  c.type = CMD_LOG_LINE;
+  copyText(c.text, sizeof(c.text), line);
+  return post(c);
+}
+
+bool s3uiRenderTask::logRecord(s3uiLogLevel level, const __FlashStringHelper *format, s3uiLogArg a0, s3uiLogArg a1,
+                               s3uiLogArg a2, s3uiLogArg a3) {
+  Command c = Command();
+  c.type = CMD_LOG_RECORD;
+  c.record = s3uiMakeLogRecord(level, format, a0, a1, a2, a3);
+  return post(c);
+}
+
+bool s3uiRenderTask::clearLog() {
+  Command c = Command();
+  c.type = CMD_CLEAR_LOG;
+  return post(c);
+}
+
+bool s3uiRenderTask::setStatusField(uint8_t field, const s3uiText &text) {
+  Command c = Command();
+  c.type = CMD_STATUS_FIELD;
+  c.index = field;
+  copyText(c.text, sizeof(c.text), text);
+  return post(c);
+}
@@ -0,0 +1,229 @@
+#ifndef S3UI_RENDER_TASK_H
+#define S3UI_RENDER_TASK_H
+
+/**
+ * @file s3uiRenderTask.h
+ * @brief Optional render-task mode: the application posts screen commands, a separate task draws and flushes.
+ */
+
+#include "Arduino.h"
+#include "s3ui.h"
+
+#ifndef S3UI_RENDER_TEXT_MAX
+/** @brief Buffer size a posted caption, confirm question, log line or status field text is copied into. */
+#define S3UI_RENDER_TEXT_MAX 48
+#endif
+
+#ifndef S3UI_FLUSH_BANDS
+/** @brief Dirty bands handed to the flush callback per frame; further dirty pages merge into the last band. */
+#define S3UI_FLUSH_BANDS 4
+#endif
+
+/**
+ * @brief Frame flush callback of an s3uiRenderTask.
+ * @param buffer Completed 1-bpp frame (the layout given to begin()). It is not drawn into until the flush ends.
+ * @param bands Page-aligned areas that changed since the previous flush (see s3ui::getDirtyBands()).
+ * @param bandCount Number of bands.
+ * @param context Pointer given to begin().
+ * @return True if the frame was sent before returning; false if the transfer continues (e.g. DMA) and
+ *         s3uiRenderTask::flushComplete() will be called when it ends.
+ */
+typedef bool (*s3uiFlushCallback)(const uint8_t *buffer, const s3uiRect *bands, uint8_t bandCount, void *context);
+
+/** @brief Wake-up callback of an s3uiRenderTask (e.g. notify the render task); see setWakeCallback(). */
+typedef void (*s3uiWakeCallback)(void *context);
+
+/**
+ * @struct s3uiRenderTaskStats
+ * @brief Work counters of an s3uiRenderTask.
+ */
+struct s3uiRenderTaskStats {
+  uint32_t commands;        ///< Commands applied.
+  uint32_t screensSkipped;  ///< Screen commands replaced by a later one before they were drawn.
+  uint32_t frames;          ///< run() calls that drew something.
+  uint32_t flushes;         ///< Frames handed to the flush callback.
+  uint32_t framesCoalesced; ///< Drawn frames merged into a later flush because the panel was busy.
+};
+
+/**
+ * @class s3uiRenderTask
+ * @brief Runs an s3ui on its own task with a double-buffered framebuffer and asynchronous flushes.
+ *
+ * The application calls the screen methods of this class instead of those of the s3ui; they copy their
+ * arguments into a command queue and return at once. The render task calls run(), which applies all queued
+ * commands (a screen command replaced by a later one is never drawn), calls s3ui::update() and hands the
+ * finished frame to the flush callback. While the panel receives that frame the next one is drawn into the
+ * second buffer; frames drawn before the flush ends are coalesced into the next flush.
+ *
+ * Set up the s3ui (display, fonts, status fields, log capacity) before begin(). Afterwards only the render
+ * task may touch the s3ui, except for s3ui::queueLogRecord(). Text lists, bitmaps and animation buffers are
+ * referenced, not copied, and must stay valid while their screen is shown; titles, battery texts, captions,
+ * questions, log lines and status field texts are copied (truncated to S3UI_RENDER_TEXT_MAX - 1 characters where
+ * that buffer is used).
+ */
+class s3uiRenderTask {
+private:
+  /** @brief Command types. */
+  enum CommandType : uint8_t {
+    CMD_NONE,
+    CMD_OPTION_SELECT,
+    CMD_OPTION_VALUE_SET,
+    CMD_ACTIVITY,
+    CMD_ANIMATION,
+    CMD_ENCODED_ANIMATION,
+    CMD_LOG,
+    CMD_CONFIRM,
+    CMD_MOVE_CURSOR,
+    CMD_LOG_LINE,
+    CMD_LOG_RECORD,
+    CMD_CLEAR_LOG,
+    CMD_STATUS_FIELD
+  };
+
+  /** @brief One posted command; built value-initialized, so fields a command does not use are zero. */
+  struct Command {
+    CommandType type;                     ///< What to do.
+    bool editing;                         ///< optionValueSetScreen() edit state.
+    uint16_t count;                       ///< Options, frames or confirm buttons.
+    uint16_t index;                       ///< Cursor, selected button or status field.
+    uint16_t width;                       ///< Bitmap width.
+    uint16_t height;                      ///< Bitmap height.
+    uint16_t msPerFrame;                  ///< Animation frame time.
+    const void *bitmap;                   ///< Bitmap, frame array or encoded animation.
+    uint8_t *scratch;                     ///< Encoded animation frame buffer.
+    s3uiTextList names;                   ///< Option names or confirm labels.
+    s3uiTextList values;                  ///< Option values.
+    char title[S3UI_TITLE_TEXT_MAX];      ///< Copied title.
+    char battery[S3UI_STATUS_TEXT_MAX];   ///< Copied battery text.
+    char text[S3UI_RENDER_TEXT_MAX];      ///< Copied caption, question, log line or status field text.
+    s3uiLogRecord record;                 ///< Log record.
+  };
+
+  s3ui &ui;                    ///< Renderer driven by run().
+  s3uiQueue commands;          ///< Commands posted by the application.
+  uint8_t *buffers[2];         ///< Frame buffers; ui draws into buffers[back].
+  uint8_t back;                ///< Index of the buffer being drawn.
+  uint16_t bufferBytes;        ///< Size of each buffer.
+  s3uiBufferLayout layout;     ///< Buffer memory layout.
+  s3uiFlushCallback flush;     ///< Frame sink.
+  void *flushContext;          ///< Passed to flush.
+  s3uiWakeCallback wake;       ///< Optional render task wake-up.
+  void *wakeContext;           ///< Passed to wake.
+  bool flushBusy;              ///< True while a frame is being sent.
+  bool flushDone;              ///< Set by flushComplete() from any context.
+  bool frameReady;             ///< True when the back buffer holds a frame that was not flushed yet.
+  Command current;             ///< Last screen command drawn (replayed when a cursor move needs a full screen).
+  Command pending;             ///< Screen command collected while draining the queue.
+  s3uiRect bands[S3UI_FLUSH_BANDS]; ///< Dirty bands of the frame being flushed.
+  s3uiRenderTaskStats stats;   ///< Work counters.
+
+  /** @brief Set the type of a value-initialized command and copy the title bar texts into it. */
+  static void prepare(Command &command, CommandType type, const s3uiText &title, const s3uiText &battery);
+  /** @brief Copy text into a NUL-terminated buffer, truncating it to size - 1 characters. */
+  static void copyText(char *dest, uint16_t size, const s3uiText &text);
+  /** @brief Queue a command and wake the render task. */
+  bool post(const Command &command);
+  /** @brief Apply one drained command (screens are only collected into pending). */
+  void apply(Command &command);
+  /** @brief Draw a screen command with the matching s3ui screen method. */
+  void drawScreen(const Command &command);
+  /** @brief Hand the back buffer to the flush callback and continue in the other buffer. */
+  void startFlush();
+  /** @brief True once the frame being flushed has been sent. */
+  bool flushFinished();
+
+public:
+  /**
+   * @brief Wrap an s3ui.
+   * @param renderer The s3ui to drive; configure its display and fonts before begin().
+   */
+  explicit s3uiRenderTask(s3ui &renderer);
+  ~s3uiRenderTask();
+
+  s3uiRenderTask(const s3uiRenderTask &) = delete;
+  s3uiRenderTask &operator=(const s3uiRenderTask &) = delete;
+
+  /**
+   * @brief Allocate both frame buffers and the command queue and attach the s3ui to the first buffer.
+   * @param callback Receives every finished frame (called on the render task).
+   * @param context Passed to callback.
+   * @param layout Buffer layout the callback expects (S3UI_LAYOUT_VERTICAL for SSD1306/PCF8814 pages).
+   * @param queueSize Commands that can be queued between two run() calls; more are dropped (see dropped()).
+   * @param producers S3UI_QUEUE_MULTI_PRODUCER if more than one task posts commands.
+   * @return True if everything was allocated.
+   * @note Call once, before the render task starts, after s3ui::setDisplay().
+   */
+  bool begin(s3uiFlushCallback callback, void *context, s3uiBufferLayout layout = S3UI_LAYOUT_VERTICAL,
+             uint16_t queueSize = 16, s3uiQueueProducers producers = S3UI_QUEUE_SINGLE_PRODUCER);
+  /**
+   * @brief Call a function whenever there is new work for run() (a posted command or a finished flush).
+   * @param callback E.g. a function that gives a FreeRTOS task notification or signals a condition variable.
+   * @param context Passed to callback.
+   * @note The callback runs on the posting task, or wherever flushComplete() is called.
+   */
+  void setWakeCallback(s3uiWakeCallback callback, void *context);
+
+  /**
+   * @brief Render-task step: apply queued commands, advance animations and the log, and flush a finished frame.
+   * @return Milliseconds until run() has timed work again (S3UI_NO_DEADLINE if only a command or
+   *         flushComplete() can create work); sleep until then or until the wake callback fires.
+   */
+  uint32_t run();
+  /** @brief Report that an asynchronous flush has finished (callable from any task or interrupt). */
+  void flushComplete();
+
+  // Screen commands (application side): same parameters as the s3ui methods of the same name
+  /** @brief Post s3ui::optionSelectScreen(). @return False if the command queue was full. */
+  bool optionSelectScreen(const s3uiText &title, const s3uiText &batteryPercentage, const s3uiTextList &options,
+                          uint16_t numOptions, uint16_t cursorPos);
+  /** @brief Post s3ui::optionValueSetScreen(). @return False if the command queue was full. */
+  bool optionValueSetScreen(const s3uiText &title, const s3uiText &batteryPercentage, const s3uiTextList &optionNames,
+                            const s3uiTextList &optionValues, uint16_t numOptions, uint16_t cursorPos,
+                            bool optionSelected);
+  /**
+   * @brief Post a cursor move on the option screen; falls back to redrawing that screen when
+   *        s3ui::moveOptionCursor() cannot repaint in place.
+   * @return False if the command queue was full.
+   */
+  bool moveOptionCursor(uint16_t cursorPos);
+  /** @brief Post the static s3ui::runningActivityScreen(). @return False if the command queue was full. */
+  bool runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *bitmap,
+                             uint16_t bitmapW, uint16_t bitmapH, const s3uiText &caption);
+  /** @brief Post the animated s3ui::runningActivityScreen(). @return False if the command queue was full. */
+  bool runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t **bitmaps,
+                             uint8_t numFrames, uint16_t bitmapW, uint16_t bitmapH, uint16_t msPerFrame,
+                             const s3uiText &caption);
+  /** @brief Post the encoded-animation s3ui::runningActivityScreen(). @return False if the command queue was full. */
+  bool runningActivityScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *animation,
+                             uint8_t *frameBuffer, uint16_t msPerFrame, const s3uiText &caption);
+  /** @brief Post s3ui::activityLiveLogScreen(). @return False if the command queue was full. */
+  bool activityLiveLogScreen(const s3uiText &title, const s3uiText &batteryPercentage);
+  /** @brief Post s3ui::confirmScreen() (bitmap may be nullptr). @return False if the command queue was full. */
+  bool confirmScreen(const s3uiText &title, const s3uiText &batteryPercentage, const uint8_t *bitmap, uint16_t bitmapW,
+                     uint16_t bitmapH, const s3uiText &question, const s3uiTextList &options, uint8_t numOptions,
+                     uint8_t selectedIndex);
+  /**
+   * @brief Post s3ui::appendLogLine() with a copy of the line (at most S3UI_RENDER_TEXT_MAX - 1 characters).
+   * @return False if the command queue was full.
+   */
+  bool appendLogLine(const s3uiText &line);
+  /** @brief Post s3ui::logRecord(). @return False if the command queue was full. */
+  bool logRecord(s3uiLogLevel level, const __FlashStringHelper *format, s3uiLogArg a0 = s3uiLogArg(),
+                 s3uiLogArg a1 = s3uiLogArg(), s3uiLogArg a2 = s3uiLogArg(), s3uiLogArg a3 = s3uiLogArg());
+  /** @brief Post s3ui::clearLog(). @return False if the command queue was full. */
+  bool clearLog();
+  /** @brief Post s3ui::setStatusField(). @return False if the command queue was full. */
+  bool setStatusField(uint8_t field, const s3uiText &text);
+
+  /**
+   * @brief True if run() has nothing left to send: no queued command, no unflushed frame and no flush in progress.
+   * @note Call on the render task; a flush finished by flushComplete() is only noticed by the next run().
+   */
+  bool idle() const { return !commands.pending() && !frameReady && !flushBusy; }
+  /** @brief Commands dropped because the queue was full. */
+  uint32_t dropped() const { return commands.dropped(); }
+  /** @brief Work counters (read them on the render task for consistent values). */
+  const s3uiRenderTaskStats &getStats() const { return stats; }
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef S3UI_STATS_H
+#define S3UI_STATS_H
+
+/**
+ * @file s3uiStats.h
+ * @brief Optional render instrumentation, compiled in only when S3UI_RENDER_STATS is defined.
+ *
+ * Define S3UI_RENDER_STATS as a build flag (not in a sketch) so that the library and the sketch agree on the
+ * class layout. Without it none of these counters exist and the library code is unchanged.
+ */
+
+#include "Arduino.h"
+
+/** @brief Screen types timed separately in s3uiRenderStats::screenMicros. */
+enum s3uiStatScreen : uint8_t {
+  S3UI_STAT_OPTION_SELECT,    ///< optionSelectScreen()
+  S3UI_STAT_OPTION_VALUE_SET, ///< optionValueSetScreen()
+  S3UI_STAT_ACTIVITY,         ///< runningActivityScreen() (all overloads)
+  S3UI_STAT_LOG,              ///< activityLiveLogScreen()
+  S3UI_STAT_CONFIRM,          ///< confirmScreen() (both overloads)
+  S3UI_STAT_SCREENS           ///< Number of screen types.
+};
+
+/**
+ * @struct s3uiRenderCounters
+ * @brief Work done by s3ui, summed over some span of calls. All members are uint32_t counters.
+ */
+struct s3uiRenderCounters {
+  uint32_t fillCalls;      ///< Filled rectangles drawn.
+  uint32_t outlineCalls;   ///< Rectangle outlines drawn.
+  uint32_t bitmapCalls;    ///< Bitmaps drawn.
+  uint32_t textCalls;      ///< Text runs printed.
+  uint32_t pixelCalls;     ///< Single drawPixel() calls (animation deltas, row-clipped text on the GFX path).
+  uint32_t pixelsTouched;  ///< Pixels in the areas drawn, clipped to the display.
+  uint32_t bytesTouched;   ///< 1-bpp buffer bytes those areas span (framebuffer layout; horizontal rows if none).
+  uint32_t charsMeasured;  ///< Characters whose width was measured.
+  uint32_t charsPrinted;   ///< Characters printed.
+  uint32_t allocations;    ///< Heap allocations made by s3ui (font advance tables, glyph cache, log storage).
+  uint32_t allocatedBytes; ///< Bytes requested by those allocations.
+  uint32_t wrapCalls;      ///< Wrap engine invocations (one per wrapped line produced, plus the final miss).
+  uint32_t screenCalls;    ///< Screen method calls.
+  uint32_t screenMicros;   ///< Microseconds spent in screen method calls.
+  uint32_t updateCalls;    ///< update() calls.
+  uint32_t updateMicros;   ///< Microseconds spent in update().
+};
+
+/**
+ * @struct s3uiRenderStats
+ * @brief Cumulative counters, the counters of the most recent call and per-screen timings.
+ */
+struct s3uiRenderStats {
+  s3uiRenderCounters total;                  ///< Everything since construction or resetRenderStats().
+  s3uiRenderCounters last;                   ///< The most recent screen method call or update() alone.
+  uint32_t maxScreenMicros;                  ///< Slowest screen method call.
+  uint32_t maxUpdateMicros;                  ///< Slowest update().
+  uint32_t screenCalls[S3UI_STAT_SCREENS];   ///< Calls per screen type.
+  uint32_t screenMicros[S3UI_STAT_SCREENS];  ///< Microseconds per screen type.
+};
+
+#endif // S3UI_STATS_H
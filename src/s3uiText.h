@@ -0,0 +1,157 @@
+#ifndef S3UI_TEXT_H
+#define S3UI_TEXT_H
+
+/**
+ * @file s3uiText.h
+ * @brief Non-owning text views used by the s3ui API to render without heap Strings.
+ */
+
+#include "Arduino.h"
+
+/**
+ * @class s3uiText
+ * @brief Read-only view of characters in RAM or flash (pointer + length, not necessarily NUL-terminated).
+ *
+ * Converts implicitly from String, C strings and F()/PSTR flash strings, so every s3ui text parameter
+ * accepts any of them. The view does not copy: the referenced characters must stay valid for the call.
+ */
+class s3uiText {
+private:
+  const char *ptr; ///< First character.
+  uint16_t len;    ///< Number of characters.
+  bool flash;      ///< True if ptr points into PROGMEM (only matters on AVR).
+
+public:
+  /** @brief Empty text. */
+  s3uiText() : ptr(""), len(0), flash(false) {}
+  /** @brief View a NUL-terminated string in RAM. */
+  s3uiText(const char *text) : ptr(text ? text : ""), len(text ? strlen(text) : 0), flash(false) {}
+  /** @brief View length characters in RAM starting at text. */
+  s3uiText(const char *text, uint16_t length) : ptr(text ? text : ""), len(text ? length : 0), flash(false) {}
+  /** @brief View the contents of an Arduino String (valid while the String is unchanged). */
+  s3uiText(const String &text) : ptr(text.c_str()), len(text.length()), flash(false) {}
+  /** @brief View a flash string created with F(). */
+  s3uiText(const __FlashStringHelper *text)
+      : ptr(reinterpret_cast<const char *>(text)), len(text ? strlen_P(reinterpret_cast<const char *>(text)) : 0),
+        flash(true) {
+    if (!text)
+      ptr = "";
+  }
+
+  /** @brief View a NUL-terminated string stored in PROGMEM (e.g. declared with PROGMEM or PSTR()). */
+  static s3uiText progmem(const char *text) { return s3uiText(reinterpret_cast<const __FlashStringHelper *>(text)); }
+
+  /** @brief Number of characters. */
+  uint16_t length() const { return len; }
+  /** @brief Raw pointer (PROGMEM address when inFlash() on AVR). */
+  const char *data() const { return ptr; }
+  /** @brief True if the characters live in PROGMEM. */
+  bool inFlash() const { return flash; }
+
+  /** @brief Character at index i (no bounds check). */
+  char operator[](uint16_t i) const {
+#ifdef __AVR__
+    return flash ? (char)pgm_read_byte(ptr + i) : ptr[i];
+#else
+    return ptr[i]; // flash is memory-mapped
+#endif
+  }
+
+  /** @brief Sub-view of count characters starting at offset. */
+  s3uiText slice(uint16_t offset, uint16_t count) const {
+    s3uiText sub(*this);
+    sub.ptr += offset;
+    sub.len = count;
+    return sub;
+  }
+};
+
+/**
+ * @brief Item callback of a virtual list: return the text of item index.
+ * @param index Zero-based item index.
+ * @param buffer Scratch buffer the text may be formatted into (nullptr if size is 0).
+ * @param size Size of buffer in bytes.
+ * @return View of the item text, e.g. s3uiText(buffer, n) after formatting, or a view of a stored string.
+ *         It only needs to stay valid until the callback is invoked again.
+ */
+typedef s3uiText (*s3uiItemProvider)(uint16_t index, char *buffer, uint16_t size);
+
+/**
+ * @class s3uiTextList
+ * @brief Indexed list of texts backed by one of several array layouts, without copying.
+ *
+ * Converts implicitly from arrays of String, C strings, F() strings and s3uiText views. Tables kept
+ * entirely in PROGMEM (array of PROGMEM pointers to PROGMEM strings) are wrapped with progmem().
+ * Converting from an s3uiItemProvider gives a virtual list whose items are fetched one at a time, so a
+ * list of any length costs no memory.
+ */
+class s3uiTextList {
+private:
+  /** @brief Backing array layout. */
+  enum Kind : uint8_t { StringArray, CStringArray, FlashArray, ProgmemTable, ViewArray, Provider };
+
+  union {
+    const void *items;         ///< Array base pointer.
+    s3uiItemProvider provider; ///< Item callback (Provider lists).
+  };
+  Kind kind; ///< How to interpret items.
+
+  s3uiTextList(const void *base, Kind k) : items(base), kind(k) {}
+
+public:
+  /** @brief Empty list (no backing array). */
+  s3uiTextList() : items(nullptr), kind(CStringArray) {}
+  /** @brief List over a String array. */
+  s3uiTextList(const String *array) : items(array), kind(StringArray) {}
+  /** @brief List over an array of C strings in RAM. */
+  s3uiTextList(const char *const *array) : items(array), kind(CStringArray) {}
+  /** @brief List over an array (in RAM) of F() flash strings. */
+  s3uiTextList(const __FlashStringHelper *const *array) : items(array), kind(FlashArray) {}
+  /** @brief List over an array of (pointer, length) views. */
+  s3uiTextList(const s3uiText *array) : items(array), kind(ViewArray) {}
+  /** @brief Virtual list whose items come from a callback. */
+  s3uiTextList(s3uiItemProvider callback) : provider(callback), kind(Provider) {}
+
+  /** @brief List over a PROGMEM table of PROGMEM strings (both the pointers and the text in flash). */
+  static s3uiTextList progmem(const char *const *table) { return s3uiTextList(table, ProgmemTable); }
+
+  /** @brief True if the list has no backing array or callback. */
+  bool empty() const { return kind == Provider ? provider == nullptr : items == nullptr; }
+
+  /**
+   * @brief Text at index i (no bounds check).
+   * @param i Item index.
+   * @param buffer Scratch buffer handed to a provider callback; array lists ignore it.
+   * @param size Size of buffer in bytes.
+   */
+  s3uiText at(uint16_t i, char *buffer, uint16_t size) const {
+    if (kind == Provider)
+      return provider(i, buffer, size);
+    return (*this)[i];
+  }
+
+  /** @brief Text at index i (no bounds check); provider callbacks get no buffer. */
+  s3uiText operator[](uint16_t i) const {
+    switch (kind) {
+    case StringArray:
+      return s3uiText(static_cast<const String *>(items)[i]);
+    case CStringArray:
+      return s3uiText(static_cast<const char *const *>(items)[i]);
+    case FlashArray:
+      return s3uiText(static_cast<const __FlashStringHelper *const *>(items)[i]);
+    case ProgmemTable:
+#ifdef __AVR__
+      return s3uiText::progmem((const char *)pgm_read_word(static_cast<const char *const *>(items) + i));
+#else
+      return s3uiText::progmem(static_cast<const char *const *>(items)[i]);
+#endif
+    case Provider:
+      return provider(i, nullptr, 0);
+    case ViewArray:
+    default:
+      return static_cast<const s3uiText *>(items)[i];
+    }
+  }
+};
+
+#endif